@@ -0,0 +1,840 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_COLLECTIVES_HPP_
+#define MODULES_CORE_INCLUDE_COLLECTIVES_HPP_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/mpi/communicator.hpp>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Hand-written MPI collectives over point-to-point messages, with the algorithm picked
+// from the size of the communicator and of the message. Elements are sent as raw bytes,
+// so T has to be trivially copyable. Header-only, so the core library does not depend
+// on MPI. Messages use the tags from TAG_BASE up, which tasks must not use on the same
+// communicator while a collective runs.
+namespace ppc::core::collectives {
+
+// LINEAR              the root talks to every rank directly (scatter, gather)
+// BINOMIAL            binomial tree, log(p) rounds of whole messages (all collectives)
+// RECURSIVE_DOUBLING  pairwise exchanges of whole messages in log(p) rounds (all_reduce)
+// RABENSEIFNER        reduce-scatter by recursive halving, then a gather (reduce) or an
+//                     allgather by recursive doubling (all_reduce)
+// RING                blocks passed around a ring: scatter and ring allgather (broadcast),
+//                     ring reduce-scatter and ring allgather (all_reduce)
+// CHAIN               the message cut into segments, pipelined along a chain of ranks
+//                     (broadcast, reduce)
+// BINARY_TREE         the message cut into segments, pipelined down a binary tree (broadcast)
+enum class Algorithm { AUTO, LINEAR, BINOMIAL, RECURSIVE_DOUBLING, RABENSEIFNER, RING, CHAIN, BINARY_TREE };
+
+enum class Collective { BROADCAST, REDUCE, ALL_REDUCE, SCATTER, GATHER };
+
+constexpr int TAG_BASE = 32700;
+// Crossovers of select_algorithm() in bytes of the message of one rank, and the segment
+// of CHAIN reduce and of the pipelined broadcasts before they are tuned
+constexpr size_t SHORT_MESSAGE = size_t(1) << 13;
+constexpr size_t LONG_MESSAGE = size_t(1) << 19;
+constexpr size_t CHAIN_SEGMENT = size_t(1) << 16;
+// Segments tried by tune_broadcast_segment(), the message it broadcasts and how often
+constexpr std::array<size_t, 8> SEGMENT_CANDIDATES = {size_t(1) << 13, size_t(1) << 14, size_t(1) << 15,
+                                                      size_t(1) << 16, size_t(1) << 17, size_t(1) << 18,
+                                                      size_t(1) << 19, size_t(1) << 20};
+constexpr size_t TUNING_MESSAGE = size_t(1) << 21;
+constexpr int TUNING_RUNS = 3;
+
+inline std::string to_string(Algorithm algorithm) {
+  switch (algorithm) {
+    case Algorithm::LINEAR:
+      return "linear";
+    case Algorithm::BINOMIAL:
+      return "binomial";
+    case Algorithm::RECURSIVE_DOUBLING:
+      return "recursive_doubling";
+    case Algorithm::RABENSEIFNER:
+      return "rabenseifner";
+    case Algorithm::RING:
+      return "ring";
+    case Algorithm::CHAIN:
+      return "chain";
+    case Algorithm::BINARY_TREE:
+      return "binary_tree";
+    default:
+      return "auto";
+  }
+}
+
+inline std::string to_string(Collective collective) {
+  switch (collective) {
+    case Collective::BROADCAST:
+      return "broadcast";
+    case Collective::REDUCE:
+      return "reduce";
+    case Collective::ALL_REDUCE:
+      return "all_reduce";
+    case Collective::SCATTER:
+      return "scatter";
+    default:
+      return "gather";
+  }
+}
+
+// Algorithms implemented for the collective, AUTO included
+inline std::vector<Algorithm> algorithms_of(Collective collective) {
+  switch (collective) {
+    case Collective::BROADCAST:
+      return {Algorithm::AUTO, Algorithm::BINOMIAL, Algorithm::RING, Algorithm::CHAIN, Algorithm::BINARY_TREE};
+    case Collective::REDUCE:
+      return {Algorithm::AUTO, Algorithm::BINOMIAL, Algorithm::RABENSEIFNER, Algorithm::CHAIN};
+    case Collective::ALL_REDUCE:
+      return {Algorithm::AUTO, Algorithm::BINOMIAL, Algorithm::RECURSIVE_DOUBLING, Algorithm::RABENSEIFNER,
+              Algorithm::RING};
+    default:
+      return {Algorithm::AUTO, Algorithm::LINEAR, Algorithm::BINOMIAL};
+  }
+}
+
+// Latency-bound trees for short messages, bandwidth-bound algorithms for long ones.
+// bytes is the message of one rank: the buffer of broadcast, the vector of reduce and
+// all_reduce, the block of one rank of scatter and gather. segment is the one of the
+// pipelined broadcasts (see broadcast_segment()): the chain takes p - 2 segment steps
+// more than a single message, the binary tree log(p) steps but sends every segment twice,
+// so the chain wins when there are more segments than ranks.
+inline Algorithm select_algorithm(Collective collective, int comm_size, size_t bytes,
+                                  size_t segment = CHAIN_SEGMENT) {
+  const bool power_of_two = (comm_size & (comm_size - 1)) == 0;
+  switch (collective) {
+    case Collective::BROADCAST:
+      if (bytes < SHORT_MESSAGE || comm_size <= 2) return Algorithm::BINOMIAL;
+      if (bytes < LONG_MESSAGE) return Algorithm::RING;
+      return bytes / std::max<size_t>(segment, 1) >= static_cast<size_t>(comm_size) ? Algorithm::CHAIN
+                                                                                     : Algorithm::BINARY_TREE;
+    case Collective::REDUCE:
+      return bytes < SHORT_MESSAGE ? Algorithm::BINOMIAL : Algorithm::RABENSEIFNER;
+    case Collective::ALL_REDUCE:
+      if (bytes < SHORT_MESSAGE) return Algorithm::RECURSIVE_DOUBLING;
+      // the ring needs no extra exchange for the ranks above a power of two
+      return bytes >= LONG_MESSAGE && !power_of_two ? Algorithm::RING : Algorithm::RABENSEIFNER;
+    default:
+      return bytes < SHORT_MESSAGE ? Algorithm::BINOMIAL : Algorithm::LINEAR;
+  }
+}
+
+// Element of the min_location and max_location reductions: a value and where it is,
+// e.g. the rank or the global index of the element
+template <class T>
+struct ValueLocation {
+  T value;
+  int64_t location;
+
+  bool operator==(const ValueLocation&) const = default;
+};
+
+// MPI_MINLOC and MPI_MAXLOC: the least (greatest) value and, of equal values, the least
+// location, so the result does not depend on the order of the ranks
+struct min_location {
+  template <class T>
+  ValueLocation<T> operator()(const ValueLocation<T>& a, const ValueLocation<T>& b) const {
+    if (a.value < b.value) return a;
+    if (b.value < a.value) return b;
+    return a.location <= b.location ? a : b;
+  }
+};
+
+struct max_location {
+  template <class T>
+  ValueLocation<T> operator()(const ValueLocation<T>& a, const ValueLocation<T>& b) const {
+    if (b.value < a.value) return a;
+    if (a.value < b.value) return b;
+    return a.location <= b.location ? a : b;
+  }
+};
+
+namespace detail {
+
+// largest message of MPI with an int count of bytes
+constexpr size_t MAX_PIECE = INT_MAX;
+
+inline int tag_of(Collective collective) { return TAG_BASE + static_cast<int>(collective); }
+
+// Messages of any size, cut into pieces of at most MAX_PIECE bytes; both sides have to
+// pass the same sizes
+inline void send_bytes(MPI_Comm comm, const void* data, size_t bytes, int dest, int tag) {
+  const auto* ptr = static_cast<const char*>(data);
+  do {
+    const auto piece = std::min(bytes, MAX_PIECE);
+    MPI_Send(ptr, static_cast<int>(piece), MPI_BYTE, dest, tag, comm);
+    ptr += piece;
+    bytes -= piece;
+  } while (bytes > 0);
+}
+
+inline void recv_bytes(MPI_Comm comm, void* data, size_t bytes, int source, int tag) {
+  auto* ptr = static_cast<char*>(data);
+  do {
+    const auto piece = std::min(bytes, MAX_PIECE);
+    MPI_Recv(ptr, static_cast<int>(piece), MPI_BYTE, source, tag, comm, MPI_STATUS_IGNORE);
+    ptr += piece;
+    bytes -= piece;
+  } while (bytes > 0);
+}
+
+inline void isend_bytes(MPI_Comm comm, const void* data, size_t bytes, int dest, int tag,
+                        std::vector<MPI_Request>& requests) {
+  const auto* ptr = static_cast<const char*>(data);
+  do {
+    const auto piece = std::min(bytes, MAX_PIECE);
+    MPI_Isend(ptr, static_cast<int>(piece), MPI_BYTE, dest, tag, comm, &requests.emplace_back());
+    ptr += piece;
+    bytes -= piece;
+  } while (bytes > 0);
+}
+
+inline void irecv_bytes(MPI_Comm comm, void* data, size_t bytes, int source, int tag,
+                        std::vector<MPI_Request>& requests) {
+  auto* ptr = static_cast<char*>(data);
+  do {
+    const auto piece = std::min(bytes, MAX_PIECE);
+    MPI_Irecv(ptr, static_cast<int>(piece), MPI_BYTE, source, tag, comm, &requests.emplace_back());
+    ptr += piece;
+    bytes -= piece;
+  } while (bytes > 0);
+}
+
+inline void sendrecv_bytes(MPI_Comm comm, const void* send_data, size_t send_bytes, int dest, void* recv_data,
+                           size_t recv_bytes, int source, int tag) {
+  const auto* send_ptr = static_cast<const char*>(send_data);
+  auto* recv_ptr = static_cast<char*>(recv_data);
+  do {
+    const auto send_piece = std::min(send_bytes, MAX_PIECE);
+    const auto recv_piece = std::min(recv_bytes, MAX_PIECE);
+    MPI_Sendrecv(send_ptr, static_cast<int>(send_piece), MPI_BYTE, dest, tag, recv_ptr, static_cast<int>(recv_piece),
+                 MPI_BYTE, source, tag, comm, MPI_STATUS_IGNORE);
+    send_ptr += send_piece;
+    send_bytes -= send_piece;
+    recv_ptr += recv_piece;
+    recv_bytes -= recv_piece;
+  } while (send_bytes > 0 || recv_bytes > 0);
+}
+
+inline void wait_all(std::vector<MPI_Request>& requests) {
+  MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+  requests.clear();
+}
+
+template <class T>
+void send(MPI_Comm comm, const T* data, size_t count, int dest, int tag) {
+  send_bytes(comm, data, count * sizeof(T), dest, tag);
+}
+
+template <class T>
+void recv(MPI_Comm comm, T* data, size_t count, int source, int tag) {
+  recv_bytes(comm, data, count * sizeof(T), source, tag);
+}
+
+template <class T>
+void sendrecv(MPI_Comm comm, const T* send_data, size_t send_count, int dest, T* recv_data, size_t recv_count,
+              int source, int tag) {
+  sendrecv_bytes(comm, send_data, send_count * sizeof(T), dest, recv_data, recv_count * sizeof(T), source, tag);
+}
+
+// inout[i] = op(inout[i], in[i]). One inlined op per element and no dependency between
+// iterations, so the compiler vectorizes the loop for arithmetic elements and the ops of
+// <functional> and boost::mpi
+template <class T, class Op>
+void combine(T* inout, const T* in, size_t count, Op& op) {
+  for (size_t i = 0; i < count; i++) inout[i] = op(inout[i], in[i]);
+}
+
+// Start of part i of count elements cut into parts parts, the first count % parts parts
+// get one element more
+inline size_t part_begin(size_t count, size_t parts, size_t i) {
+  return i * (count / parts) + std::min(i, count % parts);
+}
+
+inline int power_of_two_below(int p) {
+  int pof2 = 1;
+  while (pof2 * 2 <= p) pof2 *= 2;
+  return pof2;
+}
+
+// Binomial trees over virtual ranks 0..p-1 with the root at 0. The subtree of v is
+// [v, v + lowest bit of v) cut at p. offset(v) is the start of the block of v in a buffer
+// ordered by virtual rank, data points to the block of v and covers its subtree; rank_of
+// maps virtual ranks to ranks of comm.
+inline int subtree_end(int v, int p) { return v == 0 ? p : std::min(v + (v & -v), p); }
+
+// lowest bit of the root: the power of two at or above p
+inline int root_mask(int p) {
+  int mask = 1;
+  while (mask < p) mask <<= 1;
+  return mask;
+}
+
+// Receive the subtree of v from its parent, returns the lowest bit of v (p or more at the root)
+template <class T, class Offset, class RankOf>
+int tree_receive_from_parent(MPI_Comm comm, T* data, int v, int p, Offset offset, RankOf rank_of, int tag) {
+  int mask = 1;
+  for (; mask < p; mask <<= 1) {
+    if ((v & mask) != 0) {
+      recv(comm, data, offset(subtree_end(v, p)) - offset(v), rank_of(v - mask), tag);
+      break;
+    }
+  }
+  return mask;
+}
+
+template <class T, class Offset, class RankOf>
+void tree_send_to_children(MPI_Comm comm, const T* data, int v, int p, int mask, Offset offset, RankOf rank_of,
+                           int tag) {
+  for (mask >>= 1; mask > 0; mask >>= 1) {
+    if (v + mask < p) {
+      send(comm, data + offset(v + mask) - offset(v), offset(subtree_end(v + mask, p)) - offset(v + mask),
+           rank_of(v + mask), tag);
+    }
+  }
+}
+
+// Receive the subtrees of the children of v, returns the lowest bit of v
+template <class T, class Offset, class RankOf>
+int tree_receive_from_children(MPI_Comm comm, T* data, int v, int p, Offset offset, RankOf rank_of, int tag) {
+  int mask = 1;
+  for (; mask < p && (v & mask) == 0; mask <<= 1) {
+    if (v + mask < p) {
+      recv(comm, data + offset(v + mask) - offset(v), offset(subtree_end(v + mask, p)) - offset(v + mask),
+           rank_of(v + mask), tag);
+    }
+  }
+  return mask;
+}
+
+template <class T, class Offset, class RankOf>
+void tree_send_to_parent(MPI_Comm comm, const T* data, int v, int p, int mask, Offset offset, RankOf rank_of,
+                         int tag) {
+  if (v != 0) send(comm, data, offset(subtree_end(v, p)) - offset(v), rank_of(v - mask), tag);
+}
+
+// Ranks above the largest power of two pof2 are folded onto others: of the first 2 * rem
+// virtual ranks the odd ones hand their data to the even one below and sit out, so that
+// pof2 ranks remain. Returns the rank among them, -1 for the ranks that sit out.
+inline int fold_rank(int v, int rem) {
+  if (v < 2 * rem) return v % 2 == 0 ? v / 2 : -1;
+  return v - rem;
+}
+
+inline int unfold_rank(int folded, int rem) { return folded < rem ? folded * 2 : folded + rem; }
+
+template <class T>
+void binomial_broadcast(MPI_Comm comm, T* data, size_t count, int v, int p, int root, int tag) {
+  const auto rank_of = [&](int u) { return (u + root) % p; };
+  int mask = 1;
+  for (; mask < p; mask <<= 1) {
+    if ((v & mask) != 0) {
+      recv(comm, data, count, rank_of(v - mask), tag);
+      break;
+    }
+  }
+  for (mask >>= 1; mask > 0; mask >>= 1) {
+    if (v + mask < p) send(comm, data, count, rank_of(v + mask), tag);
+  }
+}
+
+// Scatter the blocks over a binomial tree, then pass them around a ring until every rank
+// has all of them
+template <class T>
+void ring_broadcast(MPI_Comm comm, T* data, size_t count, int v, int p, int root, int tag) {
+  const auto rank_of = [&](int u) { return (u + root) % p; };
+  const auto offset = [&](int u) { return part_begin(count, p, u); };
+  const int mask = tree_receive_from_parent(comm, data + offset(v), v, p, offset, rank_of, tag);
+  tree_send_to_children(comm, data + offset(v), v, p, mask, offset, rank_of, tag);
+  for (int step = 0; step + 1 < p; step++) {
+    const int send_block = (v - step + p) % p;
+    const int recv_block = (v - step - 1 + p) % p;
+    sendrecv(comm, data + offset(send_block), offset(send_block + 1) - offset(send_block), rank_of(v + 1),
+             data + offset(recv_block), offset(recv_block + 1) - offset(recv_block), rank_of(v - 1 + p), tag);
+  }
+}
+
+template <class T>
+void chain_broadcast(MPI_Comm comm, T* data, size_t count, int v, int p, int root, size_t segment, int tag) {
+  std::vector<MPI_Request> requests;
+  for (size_t begin = 0; begin < count; begin += segment) {
+    const size_t n = std::min(segment, count - begin);
+    if (v > 0) recv(comm, data + begin, n, (v - 1 + root) % p, tag);
+    // the segment is not written again, the sends complete while the next one arrives
+    if (v + 1 < p) isend_bytes(comm, data + begin, n * sizeof(T), (v + 1 + root) % p, tag, requests);
+  }
+  wait_all(requests);
+}
+
+// Segments pass down the tree of children 2v + 1 and 2v + 2 of virtual rank v
+template <class T>
+void tree_broadcast(MPI_Comm comm, T* data, size_t count, int v, int p, int root, size_t segment, int tag) {
+  std::vector<MPI_Request> requests;
+  for (size_t begin = 0; begin < count; begin += segment) {
+    const size_t n = std::min(segment, count - begin);
+    if (v > 0) recv(comm, data + begin, n, ((v - 1) / 2 + root) % p, tag);
+    for (int child = 2 * v + 1; child <= 2 * v + 2 && child < p; child++) {
+      isend_bytes(comm, data + begin, n * sizeof(T), (child + root) % p, tag, requests);
+    }
+  }
+  wait_all(requests);
+}
+
+// The reductions accumulate into acc, a full vector on every rank, the result ends up
+// in acc of virtual rank 0
+template <class T, class Op>
+void binomial_reduce(MPI_Comm comm, T* acc, size_t count, Op& op, int v, int p, int root, int tag) {
+  std::vector<T> received(count);
+  for (int mask = 1; mask < p; mask <<= 1) {
+    if ((v & mask) != 0) {
+      send(comm, acc, count, (v - mask + root) % p, tag);
+      return;
+    }
+    if (v + mask < p) {
+      recv(comm, received.data(), count, (v + mask + root) % p, tag);
+      combine(acc, received.data(), count, op);
+    }
+  }
+}
+
+template <class T, class Op>
+void chain_reduce(MPI_Comm comm, T* acc, size_t count, Op& op, int v, int p, int root, size_t segment, int tag) {
+  std::vector<T> received(std::min(segment, count));
+  std::vector<MPI_Request> requests;
+  for (size_t begin = 0; begin < count; begin += segment) {
+    const size_t n = std::min(segment, count - begin);
+    if (v + 1 < p) {
+      recv(comm, received.data(), n, (v + 1 + root) % p, tag);
+      combine(acc + begin, received.data(), n, op);
+    }
+    if (v > 0) isend_bytes(comm, acc + begin, n * sizeof(T), (v - 1 + root) % p, tag, requests);
+  }
+  wait_all(requests);
+}
+
+// Recursive halving over the pof2 folded ranks: afterwards folded rank f holds block f of
+// pof2 blocks fully reduced
+template <class T, class Op, class Offset, class RankOf>
+void reduce_scatter_halving(MPI_Comm comm, T* acc, T* received, Op& op, int folded, int pof2, Offset offset,
+                            RankOf rank_of, int tag) {
+  int low = 0;
+  int high = pof2;
+  for (int mask = pof2 / 2; mask > 0; mask >>= 1) {
+    const int middle = low + mask;
+    const bool keep_low = (folded & mask) == 0;
+    const int send_low = keep_low ? middle : low;
+    const int send_high = keep_low ? high : middle;
+    if (keep_low) {
+      high = middle;
+    } else {
+      low = middle;
+    }
+    sendrecv(comm, acc + offset(send_low), offset(send_high) - offset(send_low), rank_of(folded ^ mask),
+             received + offset(low), offset(high) - offset(low), rank_of(folded ^ mask), tag);
+    combine(acc + offset(low), received + offset(low), offset(high) - offset(low), op);
+  }
+}
+
+// Fold the ranks above pof2 for the power-of-two algorithms, returns the folded rank or -1
+template <class T, class Op>
+int fold(MPI_Comm comm, T* acc, T* received, size_t count, Op& op, int v, int rem, int root, int p, int tag) {
+  if (v < 2 * rem) {
+    if (v % 2 != 0) {
+      send(comm, acc, count, (v - 1 + root) % p, tag);
+    } else {
+      recv(comm, received, count, (v + 1 + root) % p, tag);
+      combine(acc, received, count, op);
+    }
+  }
+  return fold_rank(v, rem);
+}
+
+template <class T, class Op>
+void rabenseifner_reduce(MPI_Comm comm, T* acc, size_t count, Op& op, int v, int p, int root, int tag) {
+  const int pof2 = power_of_two_below(p);
+  const int rem = p - pof2;
+  std::vector<T> received(count);
+  const int folded = fold(comm, acc, received.data(), count, op, v, rem, root, p, tag);
+  if (folded < 0) return;
+  const auto offset = [&](int f) { return part_begin(count, pof2, f); };
+  const auto rank_of = [&](int f) { return (unfold_rank(f, rem) + root) % p; };
+  reduce_scatter_halving(comm, acc, received.data(), op, folded, pof2, offset, rank_of, tag);
+  // folded rank 0 is virtual rank 0, the root
+  const int mask = tree_receive_from_children(comm, acc + offset(folded), folded, pof2, offset, rank_of, tag);
+  tree_send_to_parent(comm, acc + offset(folded), folded, pof2, mask, offset, rank_of, tag);
+}
+
+template <class T, class Op>
+void recursive_doubling_all_reduce(MPI_Comm comm, T* acc, size_t count, Op& op, int rank, int p, int tag) {
+  const int pof2 = power_of_two_below(p);
+  const int rem = p - pof2;
+  std::vector<T> received(count);
+  const int folded = fold(comm, acc, received.data(), count, op, rank, rem, 0, p, tag);
+  if (folded >= 0) {
+    for (int mask = 1; mask < pof2; mask <<= 1) {
+      const int partner = unfold_rank(folded ^ mask, rem);
+      sendrecv(comm, acc, count, partner, received.data(), count, partner, tag);
+      combine(acc, received.data(), count, op);
+    }
+  }
+  if (rank < 2 * rem) {
+    if (rank % 2 == 0) {
+      send(comm, acc, count, rank + 1, tag);
+    } else {
+      recv(comm, acc, count, rank - 1, tag);
+    }
+  }
+}
+
+template <class T, class Op>
+void rabenseifner_all_reduce(MPI_Comm comm, T* acc, size_t count, Op& op, int rank, int p, int tag) {
+  const int pof2 = power_of_two_below(p);
+  const int rem = p - pof2;
+  std::vector<T> received(count);
+  const int folded = fold(comm, acc, received.data(), count, op, rank, rem, 0, p, tag);
+  if (folded >= 0) {
+    const auto offset = [&](int f) { return part_begin(count, pof2, f); };
+    const auto rank_of = [&](int f) { return unfold_rank(f, rem); };
+    reduce_scatter_halving(comm, acc, received.data(), op, folded, pof2, offset, rank_of, tag);
+    // allgather by recursive doubling, the blocks of low..high are complete
+    int low = folded;
+    int high = folded + 1;
+    for (int mask = 1; mask < pof2; mask <<= 1) {
+      const bool partner_below = (folded & mask) != 0;
+      const int partner_low = partner_below ? low - mask : high;
+      const int partner_high = partner_low + mask;
+      sendrecv(comm, acc + offset(low), offset(high) - offset(low), rank_of(folded ^ mask), acc + offset(partner_low),
+               offset(partner_high) - offset(partner_low), rank_of(folded ^ mask), tag);
+      low = std::min(low, partner_low);
+      high = std::max(high, partner_high);
+    }
+  }
+  if (rank < 2 * rem) {
+    if (rank % 2 == 0) {
+      send(comm, acc, count, rank + 1, tag);
+    } else {
+      recv(comm, acc, count, rank - 1, tag);
+    }
+  }
+}
+
+template <class T, class Op>
+void ring_all_reduce(MPI_Comm comm, T* acc, size_t count, Op& op, int rank, int p, int tag) {
+  const auto offset = [&](int block) { return part_begin(count, p, block); };
+  const auto size = [&](int block) { return offset(block + 1) - offset(block); };
+  const int right = (rank + 1) % p;
+  const int left = (rank - 1 + p) % p;
+  std::vector<T> received(size(0));
+  // reduce-scatter: after p - 1 steps block rank + 1 is complete
+  for (int step = 0; step + 1 < p; step++) {
+    const int send_block = (rank - step + p) % p;
+    const int recv_block = (rank - step - 1 + p) % p;
+    sendrecv(comm, acc + offset(send_block), size(send_block), right, received.data(), size(recv_block), left, tag);
+    combine(acc + offset(recv_block), received.data(), size(recv_block), op);
+  }
+  for (int step = 0; step + 1 < p; step++) {
+    const int send_block = (rank + 1 - step + p) % p;
+    const int recv_block = (rank - step + p) % p;
+    sendrecv(comm, acc + offset(send_block), size(send_block), right, acc + offset(recv_block), size(recv_block), left,
+             tag);
+  }
+}
+
+// Attribute of a communicator with the segment of its pipelined broadcasts, so that all
+// ranks of the communicator use the same one
+inline int segment_keyval() {
+  static const int keyval = [] {
+    int key = MPI_KEYVAL_INVALID;
+    MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, MPI_COMM_NULL_DELETE_FN, &key, nullptr);
+    return key;
+  }();
+  return keyval;
+}
+
+// segment set for comm, 0 if there is none
+inline size_t stored_segment(MPI_Comm comm) {
+  void* value = nullptr;
+  int found = 0;
+  MPI_Comm_get_attr(comm, segment_keyval(), &value, &found);
+  return found != 0 ? static_cast<size_t>(reinterpret_cast<uintptr_t>(value)) : 0;
+}
+
+inline bool is_pipelined(Algorithm algorithm) {
+  return algorithm == Algorithm::CHAIN || algorithm == Algorithm::BINARY_TREE;
+}
+
+inline void check_arguments(Collective collective, Algorithm algorithm, int root, int p) {
+  const auto algorithms = algorithms_of(collective);
+  if (std::find(algorithms.begin(), algorithms.end(), algorithm) == algorithms.end()) {
+    throw std::invalid_argument(to_string(collective) + ": algorithm " + to_string(algorithm) + " is not supported");
+  }
+  if (root < 0 || root >= p) throw std::invalid_argument(to_string(collective) + ": root out of the communicator");
+}
+
+}  // namespace detail
+
+// Segment in bytes of the pipelined broadcasts on comm, the same on all of its ranks
+inline void set_broadcast_segment(const boost::mpi::communicator& comm, size_t bytes) {
+  if (bytes == 0) throw std::invalid_argument("set_broadcast_segment: segment can't be empty");
+  MPI_Comm_set_attr(comm, detail::segment_keyval(), reinterpret_cast<void*>(static_cast<uintptr_t>(bytes)));
+}
+
+// Microbenchmark: broadcast TUNING_MESSAGE bytes with every segment of SEGMENT_CANDIDATES
+// down the chain and the binary tree, and set the segment of the fastest run for comm.
+// Every run is timed as its slowest rank, so all ranks pick the same segment. Collective.
+inline size_t tune_broadcast_segment(const boost::mpi::communicator& comm) {
+  const int p = comm.size();
+  size_t best_segment = CHAIN_SEGMENT;
+  if (p > 1) {
+    std::vector<char> buffer(TUNING_MESSAGE);
+    const int v = comm.rank();
+    const int tag = detail::tag_of(Collective::BROADCAST);
+    double best_time = std::numeric_limits<double>::max();
+    for (size_t segment : SEGMENT_CANDIDATES) {
+      for (auto algorithm : {Algorithm::CHAIN, Algorithm::BINARY_TREE}) {
+        for (int run = 0; run < TUNING_RUNS; run++) {
+          MPI_Barrier(comm);
+          const double start = MPI_Wtime();
+          if (algorithm == Algorithm::CHAIN) {
+            detail::chain_broadcast(comm, buffer.data(), buffer.size(), v, p, 0, segment, tag);
+          } else {
+            detail::tree_broadcast(comm, buffer.data(), buffer.size(), v, p, 0, segment, tag);
+          }
+          const double time = MPI_Wtime() - start;
+          double slowest = 0.0;
+          MPI_Allreduce(&time, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm);
+          if (slowest < best_time) {
+            best_time = slowest;
+            best_segment = segment;
+          }
+        }
+      }
+    }
+  }
+  set_broadcast_segment(comm, best_segment);
+  return best_segment;
+}
+
+// Segment in bytes of the pipelined broadcasts on comm: PPC_BCAST_SEGMENT if it is set,
+// else the one set for comm, else CHAIN_SEGMENT. The tuning is never started from here,
+// so that it does not land in a timed run: call tune_broadcast_segment() before, e.g.
+// in main() of the perf tests.
+inline size_t broadcast_segment(const boost::mpi::communicator& comm) {
+  if (const char* env = std::getenv("PPC_BCAST_SEGMENT")) {
+    const auto bytes = static_cast<size_t>(std::stoull(env));
+    if (bytes == 0) throw std::invalid_argument("PPC_BCAST_SEGMENT can't be 0");
+    return bytes;
+  }
+  const size_t stored = detail::stored_segment(comm);
+  return stored != 0 ? stored : CHAIN_SEGMENT;
+}
+
+// count elements of data of root to data of every rank
+template <class T>
+void broadcast(const boost::mpi::communicator& comm, T* data, size_t count, int root,
+               Algorithm algorithm = Algorithm::AUTO) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  const int p = comm.size();
+  detail::check_arguments(Collective::BROADCAST, algorithm, root, p);
+  if (p == 1) return;
+  const size_t bytes = count * sizeof(T);
+  const bool automatic = algorithm == Algorithm::AUTO;
+  if (automatic) algorithm = select_algorithm(Collective::BROADCAST, p, bytes);
+  size_t segment = CHAIN_SEGMENT;
+  // only the pipelined algorithms need the segment
+  if (detail::is_pipelined(algorithm)) {
+    segment = broadcast_segment(comm);
+    if (automatic) algorithm = select_algorithm(Collective::BROADCAST, p, bytes, segment);
+  }
+  const size_t segment_count = std::max<size_t>(1, segment / sizeof(T));
+  const int v = (comm.rank() - root + p) % p;
+  const int tag = detail::tag_of(Collective::BROADCAST);
+  if (algorithm == Algorithm::BINOMIAL) {
+    detail::binomial_broadcast(comm, data, count, v, p, root, tag);
+  } else if (algorithm == Algorithm::RING) {
+    detail::ring_broadcast(comm, data, count, v, p, root, tag);
+  } else if (algorithm == Algorithm::CHAIN) {
+    detail::chain_broadcast(comm, data, count, v, p, root, segment_count, tag);
+  } else {
+    detail::tree_broadcast(comm, data, count, v, p, root, segment_count, tag);
+  }
+}
+
+// Element-wise reduction of count elements of in of all ranks with op into out of root.
+// op has to be associative and commutative; out is used on root only and may be in.
+template <class T, class Op>
+void reduce(const boost::mpi::communicator& comm, const T* in, T* out, size_t count, Op op, int root,
+            Algorithm algorithm = Algorithm::AUTO) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  const int p = comm.size();
+  detail::check_arguments(Collective::REDUCE, algorithm, root, p);
+  const int v = (comm.rank() - root + p) % p;
+  std::vector<T> local;
+  T* acc = out;
+  if (v != 0) {
+    local.assign(in, in + count);
+    acc = local.data();
+  } else if (in != out) {
+    std::copy(in, in + count, out);
+  }
+  if (p == 1) return;
+  if (algorithm == Algorithm::AUTO) algorithm = select_algorithm(Collective::REDUCE, p, count * sizeof(T));
+  const int tag = detail::tag_of(Collective::REDUCE);
+  if (algorithm == Algorithm::BINOMIAL) {
+    detail::binomial_reduce(comm, acc, count, op, v, p, root, tag);
+  } else if (algorithm == Algorithm::RABENSEIFNER) {
+    detail::rabenseifner_reduce(comm, acc, count, op, v, p, root, tag);
+  } else {
+    detail::chain_reduce(comm, acc, count, op, v, p, root, std::max<size_t>(1, CHAIN_SEGMENT / sizeof(T)), tag);
+  }
+}
+
+// reduce() with the result on every rank; out may be in. Ranks combine only received
+// values, so op needs no identity element.
+template <class T, class Op>
+void all_reduce(const boost::mpi::communicator& comm, const T* in, T* out, size_t count, Op op,
+                Algorithm algorithm = Algorithm::AUTO) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  const int p = comm.size();
+  detail::check_arguments(Collective::ALL_REDUCE, algorithm, 0, p);
+  if (in != out) std::copy(in, in + count, out);
+  if (p == 1) return;
+  if (algorithm == Algorithm::AUTO) algorithm = select_algorithm(Collective::ALL_REDUCE, p, count * sizeof(T));
+  const int tag = detail::tag_of(Collective::ALL_REDUCE);
+  if (algorithm == Algorithm::BINOMIAL) {
+    detail::binomial_reduce(comm, out, count, op, comm.rank(), p, 0, tag);
+    detail::binomial_broadcast(comm, out, count, comm.rank(), p, 0, tag);
+  } else if (algorithm == Algorithm::RECURSIVE_DOUBLING) {
+    detail::recursive_doubling_all_reduce(comm, out, count, op, comm.rank(), p, tag);
+  } else if (algorithm == Algorithm::RABENSEIFNER) {
+    detail::rabenseifner_all_reduce(comm, out, count, op, comm.rank(), p, tag);
+  } else {
+    detail::ring_all_reduce(comm, out, count, op, comm.rank(), p, tag);
+  }
+}
+
+// all_reduce() of one value of every rank, e.g. of ValueLocation{value, rank} with
+// min_location to find the rank of the least value
+template <class T, class Op>
+T all_reduce(const boost::mpi::communicator& comm, const T& value, Op op, Algorithm algorithm = Algorithm::AUTO) {
+  T result = value;
+  all_reduce(comm, &result, &result, 1, op, algorithm);
+  return result;
+}
+
+// Block i of count elements of in of root, in rank order, to out of rank i; in is used on
+// root only
+template <class T>
+void scatter(const boost::mpi::communicator& comm, const T* in, T* out, size_t count, int root,
+             Algorithm algorithm = Algorithm::AUTO) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  const int p = comm.size();
+  const int rank = comm.rank();
+  detail::check_arguments(Collective::SCATTER, algorithm, root, p);
+  if (algorithm == Algorithm::AUTO) algorithm = select_algorithm(Collective::SCATTER, p, count * sizeof(T));
+  const int tag = detail::tag_of(Collective::SCATTER);
+  if (rank == root) std::copy(in + root * count, in + (root + 1) * count, out);
+  if (p == 1) return;
+
+  if (algorithm == Algorithm::LINEAR) {
+    if (rank != root) {
+      detail::recv(comm, out, count, root, tag);
+      return;
+    }
+    std::vector<MPI_Request> requests;
+    for (int r = 0; r < p; r++) {
+      if (r != root) detail::isend_bytes(comm, in + r * count, count * sizeof(T), r, tag, requests);
+    }
+    detail::wait_all(requests);
+    return;
+  }
+
+  const int v = (rank - root + p) % p;
+  const auto offset = [&](int u) { return static_cast<size_t>(u) * count; };
+  const auto rank_of = [&](int u) { return (u + root) % p; };
+  if (v == 0) {
+    // blocks in virtual rank order start with the one of root
+    const T* blocks = in;
+    std::vector<T> rotated;
+    if (root != 0) {
+      rotated.assign(in + root * count, in + p * count);
+      rotated.insert(rotated.end(), in, in + root * count);
+      blocks = rotated.data();
+    }
+    detail::tree_send_to_children(comm, blocks, 0, p, detail::root_mask(p), offset, rank_of, tag);
+    return;
+  }
+  std::vector<T> subtree;
+  T* blocks = out;
+  if (detail::subtree_end(v, p) - v > 1) {
+    subtree.resize(offset(detail::subtree_end(v, p)) - offset(v));
+    blocks = subtree.data();
+  }
+  const int mask = detail::tree_receive_from_parent(comm, blocks, v, p, offset, rank_of, tag);
+  detail::tree_send_to_children(comm, blocks, v, p, mask, offset, rank_of, tag);
+  if (blocks != out) std::copy(blocks, blocks + count, out);
+}
+
+// count elements of in of rank i to block i of out of root, in rank order; out is used on
+// root only
+template <class T>
+void gather(const boost::mpi::communicator& comm, const T* in, T* out, size_t count, int root,
+            Algorithm algorithm = Algorithm::AUTO) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  const int p = comm.size();
+  const int rank = comm.rank();
+  detail::check_arguments(Collective::GATHER, algorithm, root, p);
+  if (algorithm == Algorithm::AUTO) algorithm = select_algorithm(Collective::GATHER, p, count * sizeof(T));
+  const int tag = detail::tag_of(Collective::GATHER);
+
+  if (algorithm == Algorithm::LINEAR || p == 1) {
+    if (rank != root) {
+      detail::send(comm, in, count, root, tag);
+      return;
+    }
+    std::vector<MPI_Request> requests;
+    for (int r = 0; r < p; r++) {
+      if (r != root) detail::irecv_bytes(comm, out + r * count, count * sizeof(T), r, tag, requests);
+    }
+    std::copy(in, in + count, out + root * count);
+    detail::wait_all(requests);
+    return;
+  }
+
+  const int v = (rank - root + p) % p;
+  const auto offset = [&](int u) { return static_cast<size_t>(u) * count; };
+  const auto rank_of = [&](int u) { return (u + root) % p; };
+  if (detail::subtree_end(v, p) - v == 1) {
+    detail::tree_send_to_parent(comm, in, v, p, v & -v, offset, rank_of, tag);
+    return;
+  }
+  // blocks of the subtree in virtual rank order, starting with the one of this rank
+  std::vector<T> subtree;
+  T* blocks = out;
+  if (v != 0 || root != 0) {
+    subtree.resize(offset(detail::subtree_end(v, p)) - offset(v));
+    blocks = subtree.data();
+  }
+  std::copy(in, in + count, blocks);
+  const int mask = detail::tree_receive_from_children(comm, blocks, v, p, offset, rank_of, tag);
+  if (v != 0) {
+    detail::tree_send_to_parent(comm, blocks, v, p, mask, offset, rank_of, tag);
+  } else if (blocks != out) {
+    std::copy(blocks, blocks + offset(p - root), out + root * count);
+    std::copy(blocks + offset(p - root), blocks + offset(p), out);
+  }
+}
+
+}  // namespace ppc::core::collectives
+
+#endif  // MODULES_CORE_INCLUDE_COLLECTIVES_HPP_
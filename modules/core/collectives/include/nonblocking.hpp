@@ -0,0 +1,211 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_NONBLOCKING_HPP_
+#define MODULES_CORE_INCLUDE_NONBLOCKING_HPP_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <boost/mpi/communicator.hpp>
+#include <climits>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/collectives/include/collectives.hpp"
+
+// Nonblocking point-to-point messages and collectives, so that a task computes on one
+// chunk of its data while the next one is on the way. Every call returns a Request; the
+// buffers it was given must stay alive and untouched until the request is complete.
+namespace ppc::core::collectives {
+
+// A pending operation, the future of its buffers: they may be used again after wait() or
+// after test() returned true. Move-only; the destructor waits, so a request never
+// outlives its buffers by accident.
+class Request {
+ public:
+  Request() = default;
+  Request(const Request&) = delete;
+  Request& operator=(const Request&) = delete;
+  Request(Request&& other) noexcept
+      : requests(std::move(other.requests)),
+        type(std::exchange(other.type, MPI_DATATYPE_NULL)),
+        op(std::exchange(other.op, MPI_OP_NULL)),
+        counts(std::move(other.counts)),
+        displacements(std::move(other.displacements)) {
+    other.requests.clear();
+  }
+  Request& operator=(Request&& other) noexcept {
+    if (this != &other) {
+      wait();
+      requests = std::move(other.requests);
+      other.requests.clear();
+      type = std::exchange(other.type, MPI_DATATYPE_NULL);
+      op = std::exchange(other.op, MPI_OP_NULL);
+      counts = std::move(other.counts);
+      displacements = std::move(other.displacements);
+    }
+    return *this;
+  }
+  ~Request() { wait(); }
+
+  // false once the operation completed and was waited for or tested
+  [[nodiscard]] bool active() const { return !requests.empty(); }
+
+  void wait() {
+    if (!active()) return;
+    detail::wait_all(requests);
+    release();
+  }
+
+  // true if the operation completed; does not block
+  bool test() {
+    if (!active()) return true;
+    int done = 0;
+    MPI_Testall(static_cast<int>(requests.size()), requests.data(), &done, MPI_STATUSES_IGNORE);
+    if (done == 0) return false;
+    requests.clear();
+    release();
+    return true;
+  }
+
+ private:
+  template <class T>
+  friend Request isend(const boost::mpi::communicator& comm, const T* data, size_t count, int dest, int tag);
+  template <class T>
+  friend Request irecv(const boost::mpi::communicator& comm, T* data, size_t count, int source, int tag);
+  template <class T>
+  friend Request ibcast(const boost::mpi::communicator& comm, T* data, size_t count, int root);
+  template <class T, class Op>
+  friend Request ireduce(const boost::mpi::communicator& comm, const T* in, T* out, size_t count, Op op, int root);
+  template <class T>
+  friend Request iscatterv(const boost::mpi::communicator& comm, const T* in, std::vector<int> counts,
+                           std::vector<int> displacements, T* out, int root);
+
+  // the arguments of ireduce() and iscatterv() live as long as the operation
+  void release() {
+    if (type != MPI_DATATYPE_NULL) MPI_Type_free(&type);
+    if (op != MPI_OP_NULL) MPI_Op_free(&op);
+    counts.clear();
+    displacements.clear();
+  }
+
+  std::vector<MPI_Request> requests;
+  MPI_Datatype type = MPI_DATATYPE_NULL;
+  MPI_Op op = MPI_OP_NULL;
+  std::vector<int> counts;
+  std::vector<int> displacements;
+};
+
+namespace detail {
+
+// MPI_User_function of a stateless op; the ops are commutative, so the order of the
+// arguments does not matter
+template <class T, class Op>
+void apply_op(void* in, void* inout, int* len, MPI_Datatype* /*type*/) {
+  Op op;
+  combine(static_cast<T*>(inout), static_cast<const T*>(in), static_cast<size_t>(*len), op);
+}
+
+}  // namespace detail
+
+template <class T>
+Request isend(const boost::mpi::communicator& comm, const T* data, size_t count, int dest, int tag) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  Request request;
+  detail::isend_bytes(comm, data, count * sizeof(T), dest, tag, request.requests);
+  return request;
+}
+
+// count has to be the count of the matching isend()
+template <class T>
+Request irecv(const boost::mpi::communicator& comm, T* data, size_t count, int source, int tag) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  Request request;
+  detail::irecv_bytes(comm, data, count * sizeof(T), source, tag, request.requests);
+  return request;
+}
+
+// broadcast() that returns at once; all ranks have to start their nonblocking
+// collectives on comm in the same order
+template <class T>
+Request ibcast(const boost::mpi::communicator& comm, T* data, size_t count, int root) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  detail::check_arguments(Collective::BROADCAST, Algorithm::AUTO, root, comm.size());
+  Request request;
+  auto* ptr = reinterpret_cast<char*>(data);
+  size_t bytes = count * sizeof(T);
+  do {
+    const auto piece = std::min(bytes, detail::MAX_PIECE);
+    MPI_Ibcast(ptr, static_cast<int>(piece), MPI_BYTE, root, comm, &request.requests.emplace_back());
+    ptr += piece;
+    bytes -= piece;
+  } while (bytes > 0);
+  return request;
+}
+
+// reduce() that returns at once. op has to be associative, commutative and stateless, as
+// std::plus<>, boost::mpi::maximum<T> or a lambda without captures: MPI runs a copy of it.
+template <class T, class Op>
+Request ireduce(const boost::mpi::communicator& comm, const T* in, T* out, size_t count, Op /*op*/, int root) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  static_assert(std::is_empty_v<Op> && std::is_default_constructible_v<Op>, "ireduce: op has to be stateless");
+  detail::check_arguments(Collective::REDUCE, Algorithm::AUTO, root, comm.size());
+  Request request;
+  MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &request.type);
+  MPI_Type_commit(&request.type);
+  MPI_Op_create(&detail::apply_op<T, Op>, 1, &request.op);
+  const bool is_root = comm.rank() == root;
+  size_t offset = 0;
+  do {
+    const auto piece = std::min<size_t>(count - offset, INT_MAX);
+    const void* send = is_root && in == out ? MPI_IN_PLACE : static_cast<const void*>(in + offset);
+    MPI_Ireduce(send, is_root ? out + offset : nullptr, static_cast<int>(piece), request.type, request.op, root, comm,
+                &request.requests.emplace_back());
+    offset += piece;
+  } while (offset < count);
+  return request;
+}
+
+// MPI_Iscatterv: counts[r] elements of in from displacements[r] on, both in elements, to
+// out of rank r. All ranks pass the same counts and displacements, e.g. of a
+// ppc::core::Distribution; the root keeps its own part in place in in.
+template <class T>
+Request iscatterv(const boost::mpi::communicator& comm, const T* in, std::vector<int> counts,
+                  std::vector<int> displacements, T* out, int root) {
+  static_assert(std::is_trivially_copyable_v<T>, "collectives send elements as bytes");
+  detail::check_arguments(Collective::SCATTER, Algorithm::AUTO, root, comm.size());
+  if (counts.size() != static_cast<size_t>(comm.size()) || displacements.size() != counts.size()) {
+    throw std::invalid_argument("iscatterv: counts and displacements must have an entry per rank");
+  }
+  Request request;
+  MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &request.type);
+  MPI_Type_commit(&request.type);
+  request.counts = std::move(counts);
+  request.displacements = std::move(displacements);
+  const bool is_root = comm.rank() == root;
+  MPI_Iscatterv(in, request.counts.data(), request.displacements.data(), request.type,
+                is_root ? MPI_IN_PLACE : static_cast<void*>(out), request.counts[comm.rank()], request.type, root, comm,
+                &request.requests.emplace_back());
+  return request;
+}
+
+inline void wait_all(std::vector<Request>& requests) {
+  for (auto& request : requests) request.wait();
+}
+
+// Index of an active request that has completed, if there is one; it is no longer active
+// afterwards, so the next call finds another one
+inline std::optional<size_t> test_any(std::vector<Request>& requests) {
+  for (size_t i = 0; i < requests.size(); i++) {
+    if (requests[i].active() && requests[i].test()) return i;
+  }
+  return std::nullopt;
+}
+
+}  // namespace ppc::core::collectives
+
+#endif  // MODULES_CORE_INCLUDE_NONBLOCKING_HPP_
@@ -0,0 +1,122 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/dataset/include/dataset.hpp"
+#include "core/task/func_tests/test_task.hpp"
+#include "core/task/include/task.hpp"
+
+namespace {
+
+// Fresh path in the temporary directory, removed with the object
+struct TempPath {
+  std::string path;
+  explicit TempPath(const std::string& name)
+      : path((std::filesystem::temp_directory_path() / ("ppc_dataset_tests_" + name)).string()) {
+    std::filesystem::remove_all(path);
+  }
+  ~TempPath() { std::filesystem::remove_all(path); }
+};
+
+}  // namespace
+
+TEST(dataset_tests, check_write_and_map) {
+  TempPath file("matrix.ppcds");
+  std::vector<double> matrix(3 * 5);
+  std::iota(matrix.begin(), matrix.end(), 0.5);
+  ppc::core::write_dataset(file.path, std::span<const double>(matrix), {3, 5});
+
+  ppc::core::MappedDataset dataset(file.path);
+  EXPECT_EQ(dataset.view().dtype, ppc::core::DataType::FLOAT64);
+  EXPECT_EQ(dataset.view().shape, (std::vector<uint64_t>{3, 5}));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(dataset.view().data) % ppc::core::DATASET_ALIGNMENT, 0U);
+  const auto span = dataset.span<double>();
+  EXPECT_TRUE(std::equal(span.begin(), span.end(), matrix.begin(), matrix.end()));
+  EXPECT_THROW(static_cast<void>(dataset.span<float>()), std::invalid_argument);
+
+  // the mapping outlives moves
+  ppc::core::MappedDataset moved(std::move(dataset));
+  EXPECT_EQ(moved.span<double>()[14], 14.5);
+}
+
+TEST(dataset_tests, check_task_reads_the_mapping) {
+  TempPath file("vector.ppcds");
+  std::vector<int32_t> in(1000, 3);
+  ppc::core::write_dataset(file.path, std::span<const int32_t>(in));
+  ppc::core::MappedDataset dataset(file.path);
+
+  std::vector<int32_t> out(1, 0);
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(dataset.view());
+  taskData->add_output(out);
+  EXPECT_EQ(taskData->inputs[0], dataset.view().data);
+
+  ppc::test::TestTask<int32_t> testTask(taskData);
+  ASSERT_TRUE(testTask.validation());
+  testTask.pre_processing();
+  testTask.run();
+  testTask.post_processing();
+  EXPECT_EQ(out[0], 3000);
+
+  // writes to the input stay in the process
+  taskData->inputs[0][0] = 7;
+  EXPECT_EQ(ppc::core::MappedDataset(file.path).span<int32_t>()[0], 3);
+}
+
+TEST(dataset_tests, check_cached_dataset_is_generated_once) {
+  TempPath dir("cache");
+  int generated = 0;
+  const auto make = [&](std::span<float> data) {
+    generated++;
+    std::fill(data.begin(), data.end(), 1.0F);
+  };
+  const auto first = ppc::core::cached_dataset<float>("ones", {4, 4}, make, dir.path);
+  const auto second = ppc::core::cached_dataset<float>("ones", {4, 4}, make, dir.path);
+  EXPECT_EQ(generated, 1);
+  EXPECT_EQ(second.span<float>()[15], 1.0F);
+  // another shape or type does not match the file
+  const auto reshaped = ppc::core::cached_dataset<float>("ones", {2, 8}, make, dir.path);
+  EXPECT_EQ(reshaped.view().shape, (std::vector<uint64_t>{2, 8}));
+  EXPECT_EQ(generated, 2);
+  EXPECT_FALSE(ppc::core::open_dataset(
+      ppc::core::cached_dataset_path(dir.path, "ones", ppc::core::DataType::FLOAT32, {2, 8}),
+      ppc::core::DataType::INT32, {2, 8}));
+}
+
+TEST(dataset_tests, check_cached_dataset_keeps_mapped_files) {
+  // a dataset of another shape goes to a file of its own, the mapped one stays in place
+  TempPath dir("cache_mapped");
+  const auto make = [](std::span<int32_t> data) { std::iota(data.begin(), data.end(), 0); };
+  const auto square = ppc::core::cached_dataset<int32_t>("iota", {4, 4}, make, dir.path);
+  const auto square_path = ppc::core::cached_dataset_path(dir.path, "iota", ppc::core::DataType::INT32, {4, 4});
+  const auto row_path = ppc::core::cached_dataset_path(dir.path, "iota", ppc::core::DataType::INT32, {16});
+  EXPECT_EQ(square_path, dir.path + "/iota.v1.int32.4x4.ppcds");
+  EXPECT_NE(square_path, row_path);
+  const auto row = ppc::core::cached_dataset<int32_t>("iota", {16}, make, dir.path);
+  EXPECT_TRUE(std::filesystem::exists(square_path));
+  EXPECT_TRUE(std::filesystem::exists(row_path));
+  EXPECT_EQ(square.span<int32_t>()[15], 15);
+  EXPECT_EQ(row.span<int32_t>()[15], 15);
+}
+
+TEST(dataset_tests, check_invalid_files) {
+  TempPath file("broken.ppcds");
+  EXPECT_THROW(ppc::core::MappedDataset(file.path), std::runtime_error);
+  {
+    std::ofstream out(file.path, std::ios::binary);
+    out << "not a dataset at all, only some text that is long enough for a header";
+  }
+  EXPECT_THROW(ppc::core::MappedDataset(file.path), std::runtime_error);
+  EXPECT_FALSE(ppc::core::open_dataset(file.path, ppc::core::DataType::UINT8, {1}));
+
+  std::vector<uint8_t> bytes(100, 1);
+  ppc::core::write_dataset(file.path, std::span<const uint8_t>(bytes));
+  std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 1);
+  EXPECT_THROW(ppc::core::MappedDataset(file.path), std::runtime_error);
+}
@@ -0,0 +1,103 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_DATASET_HPP_
+#define MODULES_CORE_INCLUDE_DATASET_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/task/include/data_view.hpp"
+
+namespace ppc::core {
+
+// Inputs stored once in a binary file and mapped into memory, so that a perf test
+// neither generates nor copies them and every backend reads the same bytes.
+//
+// File layout, little-endian:
+//   "PPCDSET\0", uint32 version, uint32 dtype (DataType), uint64 rank, uint64 shape[rank],
+//   zero padding to DATASET_ALIGNMENT bytes, the elements in row-major order.
+constexpr uint32_t DATASET_VERSION = 1;
+constexpr uint64_t DATASET_ALIGNMENT = 64;
+
+// view has to be contiguous and typed. Written to a temporary file which is then
+// renamed, so a reader sees either no file or the whole of it. Throws
+// std::runtime_error on I/O errors, std::filesystem::filesystem_error if the file
+// can't be put in place.
+void write_dataset(const std::string& path, const DataView& view);
+
+template <class T>
+void write_dataset(const std::string& path, std::span<const T> data, std::vector<uint64_t> shape = {}) {
+  if (shape.empty()) shape = {data.size()};
+  write_dataset(path, DataView{reinterpret_cast<uint8_t*>(const_cast<T*>(data.data())), data_type_of<T>(),
+                               std::move(shape), {}});
+}
+
+// Read-only file mapped copy-on-write: a task may write to its input, which changes
+// its own pages and never the file
+class MappedDataset {
+ public:
+  // Throws std::runtime_error if path can't be opened or is not a dataset of this version
+  explicit MappedDataset(const std::string& path);
+  MappedDataset(const MappedDataset&) = delete;
+  MappedDataset& operator=(const MappedDataset&) = delete;
+  MappedDataset(MappedDataset&& other) noexcept;
+  MappedDataset& operator=(MappedDataset&& other) noexcept;
+  ~MappedDataset();
+
+  // Pass to TaskData::add_input; valid while the dataset lives
+  [[nodiscard]] const DataView& view() const { return view_; }
+  template <class T>
+  [[nodiscard]] std::span<const T> span() const {
+    return view_.span<const T>();
+  }
+
+ private:
+  void unmap();
+
+  void* mapping = nullptr;
+  uint64_t length = 0;
+  DataView view_;
+};
+
+// nullopt if path does not exist or holds another version, dtype or shape
+std::optional<MappedDataset> open_dataset(const std::string& path, DataType dtype,
+                                          const std::vector<uint64_t>& shape);
+
+// Directory of cached datasets: PPC_DATASET_DIR, or ppc_datasets in the temporary directory
+std::string dataset_dir();
+
+// File of the cached dataset name in dir, e.g. dir/ones.v1.float32.4x4.ppcds. Every
+// version, dtype and shape has a file of its own, so a dataset is never written over a
+// file that may still be mapped, by this process or another (Windows can't replace those).
+std::string cached_dataset_path(const std::string& dir, const std::string& name, DataType dtype,
+                                const std::vector<uint64_t>& shape);
+
+// Dataset name of dir. The first call for a dtype and shape fills the elements with
+// make(std::span<T>) and writes the file; the others just map it. Put anything the
+// contents depend on (seed, generator version) into name.
+template <class T, class Make>
+MappedDataset cached_dataset(const std::string& name, const std::vector<uint64_t>& shape, const Make& make,
+                             const std::string& dir = dataset_dir()) {
+  const std::string path = cached_dataset_path(dir, name, data_type_of<T>(), shape);
+  if (auto dataset = open_dataset(path, data_type_of<T>(), shape)) return std::move(*dataset);
+  uint64_t size = 1;
+  for (auto extent : shape) size *= extent;
+  std::vector<T> data(size);
+  make(std::span<T>(data));
+  try {
+    write_dataset(path, std::span<const T>(data), shape);
+  } catch (const std::filesystem::filesystem_error&) {
+    // another process wrote the same dataset first and has it mapped already
+    if (auto dataset = open_dataset(path, data_type_of<T>(), shape)) return std::move(*dataset);
+    throw;
+  }
+  return MappedDataset(path);
+}
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_DATASET_HPP_
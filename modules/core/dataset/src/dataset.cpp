@@ -0,0 +1,212 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/dataset/include/dataset.hpp"
+
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char MAGIC[8] = {'P', 'P', 'C', 'D', 'S', 'E', 'T', '\0'};
+// bound on the rank, so that a corrupt header can't ask for a huge shape
+constexpr uint64_t MAX_RANK = 32;
+
+void check_endian() {
+  if constexpr (std::endian::native != std::endian::little) {
+    throw std::runtime_error("Datasets are stored little-endian, this host is not");
+  }
+}
+
+uint64_t header_size(uint64_t rank) {
+  const uint64_t size = sizeof(MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t) * (1 + rank);
+  return (size + ppc::core::DATASET_ALIGNMENT - 1) / ppc::core::DATASET_ALIGNMENT * ppc::core::DATASET_ALIGNMENT;
+}
+
+template <class T>
+T read_field(const uint8_t* bytes, uint64_t& offset) {
+  T value;
+  std::memcpy(&value, bytes + offset, sizeof(T));
+  offset += sizeof(T);
+  return value;
+}
+
+template <class T>
+void write_field(std::ofstream& out, T value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Parse the header of a mapped file into view, the elements are checked to fill the file exactly
+void parse(const std::string& path, const uint8_t* bytes, uint64_t length, ppc::core::DataView& view) {
+  const auto fail = [&](const std::string& what) { throw std::runtime_error("Dataset " + path + ": " + what); };
+  if (length < header_size(0) || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) fail("not a dataset");
+  uint64_t offset = sizeof(MAGIC);
+  const auto version = read_field<uint32_t>(bytes, offset);
+  if (version != ppc::core::DATASET_VERSION) fail("version " + std::to_string(version) + " is not supported");
+  view.dtype = static_cast<ppc::core::DataType>(read_field<uint32_t>(bytes, offset));
+  const uint64_t element_size = ppc::core::data_type_size(view.dtype);
+  if (element_size == 0) fail("unknown element type");
+  const auto rank = read_field<uint64_t>(bytes, offset);
+  if (rank == 0 || rank > MAX_RANK || length < header_size(rank)) fail("corrupt shape");
+  view.shape.resize(rank);
+  uint64_t size = 1;
+  for (auto& extent : view.shape) {
+    extent = read_field<uint64_t>(bytes, offset);
+    if (extent != 0 && size > std::numeric_limits<uint64_t>::max() / element_size / extent) fail("corrupt shape");
+    size *= extent;
+  }
+  if (length != header_size(rank) + size * element_size) fail("size does not match the shape");
+  view.data = const_cast<uint8_t*>(bytes) + header_size(rank);
+  view.strides.clear();
+}
+
+}  // namespace
+
+void ppc::core::write_dataset(const std::string& path, const DataView& view) {
+  check_endian();
+  if (data_type_size(view.dtype) == 0) throw std::invalid_argument("write_dataset: element type is unknown");
+  if (view.shape.empty() || view.shape.size() > MAX_RANK) throw std::invalid_argument("write_dataset: bad rank");
+  if (!view.is_contiguous()) throw std::invalid_argument("write_dataset: view is not contiguous");
+
+  const std::filesystem::path target(path);
+  if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path());
+  // unique per writer, as several processes may generate the same dataset at once
+  const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+  const std::string temp = path + ".tmp" + std::to_string(std::random_device()()) + std::to_string(stamp);
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("write_dataset: can't create " + temp);
+    out.write(MAGIC, sizeof(MAGIC));
+    write_field<uint32_t>(out, DATASET_VERSION);
+    write_field<uint32_t>(out, static_cast<uint32_t>(view.dtype));
+    write_field<uint64_t>(out, view.shape.size());
+    for (auto extent : view.shape) write_field<uint64_t>(out, extent);
+    const uint64_t written = sizeof(MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t) * (1 + view.shape.size());
+    const std::vector<char> padding(header_size(view.shape.size()) - written, 0);
+    out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    const auto bytes = static_cast<std::streamsize>(view.size() * data_type_size(view.dtype));
+    out.write(reinterpret_cast<const char*>(view.data), bytes);
+    if (!out.flush()) {
+      out.close();
+      std::filesystem::remove(temp);
+      throw std::runtime_error("write_dataset: can't write " + temp);
+    }
+  }
+  try {
+    std::filesystem::rename(temp, target);
+  } catch (const std::filesystem::filesystem_error&) {
+    std::filesystem::remove(temp);
+    throw;
+  }
+}
+
+ppc::core::MappedDataset::MappedDataset(const std::string& path) {
+  check_endian();
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Dataset " + path + ": can't open");
+  LARGE_INTEGER file_size;
+  GetFileSizeEx(file, &file_size);
+  length = static_cast<uint64_t>(file_size.QuadPart);
+  HANDLE section = length == 0 ? nullptr : CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (section != nullptr) {
+    mapping = MapViewOfFile(section, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(section);
+  }
+#else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Dataset " + path + ": can't open");
+  struct stat info {};
+  fstat(fd, &info);
+  length = static_cast<uint64_t>(info.st_size);
+  if (length != 0) {
+    // private and writable: writes go to copies of the pages, never to the file
+    mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) mapping = nullptr;
+  }
+  close(fd);
+#endif
+  if (mapping == nullptr) throw std::runtime_error("Dataset " + path + ": can't map");
+  try {
+    parse(path, static_cast<const uint8_t*>(mapping), length, view_);
+  } catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+ppc::core::MappedDataset::MappedDataset(MappedDataset&& other) noexcept
+    : mapping(std::exchange(other.mapping, nullptr)),
+      length(std::exchange(other.length, 0)),
+      view_(std::exchange(other.view_, {})) {}
+
+ppc::core::MappedDataset& ppc::core::MappedDataset::operator=(MappedDataset&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    mapping = std::exchange(other.mapping, nullptr);
+    length = std::exchange(other.length, 0);
+    view_ = std::exchange(other.view_, {});
+  }
+  return *this;
+}
+
+ppc::core::MappedDataset::~MappedDataset() { unmap(); }
+
+void ppc::core::MappedDataset::unmap() {
+  if (mapping == nullptr) return;
+#ifdef _WIN32
+  UnmapViewOfFile(mapping);
+#else
+  munmap(mapping, length);
+#endif
+  mapping = nullptr;
+  length = 0;
+  view_ = {};
+}
+
+std::optional<ppc::core::MappedDataset> ppc::core::open_dataset(const std::string& path, DataType dtype,
+                                                                const std::vector<uint64_t>& shape) {
+  if (!std::filesystem::exists(path)) return std::nullopt;
+  try {
+    MappedDataset dataset(path);
+    if (dataset.view().dtype != dtype || dataset.view().shape != shape) return std::nullopt;
+    return dataset;
+  } catch (const std::runtime_error&) {
+    return std::nullopt;
+  }
+}
+
+std::string ppc::core::cached_dataset_path(const std::string& dir, const std::string& name, DataType dtype,
+                                           const std::vector<uint64_t>& shape) {
+  std::string path = dir + "/" + name + ".v" + std::to_string(DATASET_VERSION) + "." + data_type_name(dtype) + ".";
+  for (size_t i = 0; i < shape.size(); i++) {
+    if (i > 0) path += 'x';
+    path += std::to_string(shape[i]);
+  }
+  return path + ".ppcds";
+}
+
+std::string ppc::core::dataset_dir() {
+  if (const char* dir = std::getenv("PPC_DATASET_DIR")) return dir;
+  return (std::filesystem::temp_directory_path() / "ppc_datasets").string();
+}
@@ -0,0 +1,111 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "core/distribution/include/distribution.hpp"
+
+using ppc::core::Distribution;
+using ppc::core::Distribution2D;
+using ppc::core::Scheme;
+
+TEST(distribution_tests, check_block_counts) {
+  const Distribution distribution(10, 4);
+  EXPECT_EQ(distribution.counts(), std::vector<int>({3, 3, 2, 2}));
+  EXPECT_EQ(distribution.displacements(), std::vector<int>({0, 3, 6, 8}));
+  EXPECT_TRUE(distribution.contiguous());
+  // more parts than elements
+  EXPECT_EQ(Distribution(2, 3).counts(), std::vector<int>({1, 1, 0}));
+}
+
+TEST(distribution_tests, check_block_cyclic_counts) {
+  // blocks {0 1 2} {3 4 5} {6 7 8} {9}
+  const Distribution distribution(10, 3, Scheme::BLOCK_CYCLIC, 3);
+  EXPECT_EQ(distribution.counts(), std::vector<int>({4, 3, 3}));
+  EXPECT_EQ(distribution.global_index(0, 3), 9U);
+  EXPECT_FALSE(distribution.contiguous());
+  EXPECT_EQ(Distribution(7, 3, Scheme::CYCLIC).counts(), std::vector<int>({3, 2, 2}));
+}
+
+TEST(distribution_tests, check_indices_of_all_schemes) {
+  for (auto scheme : {Scheme::BLOCK, Scheme::CYCLIC, Scheme::BLOCK_CYCLIC}) {
+    for (size_t size : {0, 1, 5, 17, 64}) {
+      for (int parts : {1, 2, 3, 7}) {
+        const Distribution distribution(size, parts, scheme, 4);
+        std::vector<size_t> seen(parts, 0);
+        for (size_t i = 0; i < size; i++) {
+          const int owner = distribution.owner(i);
+          ASSERT_LT(owner, parts) << ppc::core::to_string(scheme);
+          const size_t local = distribution.local_index(i);
+          // local order is the global order
+          ASSERT_EQ(local, seen[owner]++) << ppc::core::to_string(scheme);
+          ASSERT_EQ(distribution.global_index(owner, local), i) << ppc::core::to_string(scheme);
+        }
+        for (int part = 0; part < parts; part++) {
+          ASSERT_EQ(distribution.count(part), seen[part]) << ppc::core::to_string(scheme);
+        }
+      }
+    }
+  }
+}
+
+TEST(distribution_tests, check_pack_and_unpack) {
+  for (auto scheme : {Scheme::BLOCK, Scheme::CYCLIC, Scheme::BLOCK_CYCLIC}) {
+    const Distribution distribution(23, 4, scheme, 3);
+    std::vector<int> global(23);
+    std::iota(global.begin(), global.end(), 0);
+    std::vector<int> packed(global.size());
+    distribution.pack(global.data(), packed.data());
+    for (int part = 0; part < 4; part++) {
+      for (size_t local = 0; local < distribution.count(part); local++) {
+        ASSERT_EQ(packed[distribution.displacement(part) + local], global[distribution.global_index(part, local)]);
+      }
+    }
+    std::vector<int> unpacked(global.size(), -1);
+    distribution.unpack(packed.data(), unpacked.data());
+    EXPECT_EQ(unpacked, global) << ppc::core::to_string(scheme);
+  }
+}
+
+TEST(distribution_tests, check_tiles) {
+  // 5 x 7 matrix on a 2 x 3 grid
+  const auto distribution = Distribution2D::by_tiles(5, 7, 2, 3);
+  EXPECT_EQ(distribution.parts(), 6);
+  EXPECT_EQ(distribution.counts(), std::vector<int>({9, 6, 6, 6, 4, 4}));
+  EXPECT_EQ(distribution.owner(4, 6), 5);
+  EXPECT_FALSE(distribution.contiguous());
+
+  std::vector<int> global(35);
+  std::iota(global.begin(), global.end(), 0);
+  std::vector<int> packed(global.size());
+  distribution.pack(global.data(), packed.data());
+  // part 4 has rows 3..4 and columns 3..4
+  const auto part = packed.begin() + static_cast<std::ptrdiff_t>(distribution.displacement(4));
+  EXPECT_EQ(std::vector<int>(part, part + 4), std::vector<int>({24, 25, 31, 32}));
+  std::vector<int> unpacked(global.size(), -1);
+  distribution.unpack(packed.data(), unpacked.data());
+  EXPECT_EQ(unpacked, global);
+}
+
+TEST(distribution_tests, check_rows_and_columns) {
+  const auto rows = Distribution2D::by_rows(4, 3, 3, Scheme::CYCLIC);
+  EXPECT_EQ(rows.counts(), std::vector<int>({6, 3, 3}));
+  EXPECT_EQ(rows.local_columns(1), 3U);
+  EXPECT_TRUE(Distribution2D::by_rows(4, 3, 3).contiguous());
+
+  const auto columns = Distribution2D::by_columns(2, 5, 2);
+  EXPECT_EQ(columns.counts(), std::vector<int>({6, 4}));
+  std::vector<int> global(10);
+  std::iota(global.begin(), global.end(), 0);
+  std::vector<int> packed(global.size());
+  columns.pack(global.data(), packed.data());
+  EXPECT_EQ(packed, std::vector<int>({0, 1, 2, 5, 6, 7, 3, 4, 8, 9}));
+}
+
+TEST(distribution_tests, check_invalid_arguments) {
+  EXPECT_THROW(Distribution(10, 0), std::invalid_argument);
+  EXPECT_THROW(Distribution(10, 2, Scheme::BLOCK_CYCLIC, 0), std::invalid_argument);
+}
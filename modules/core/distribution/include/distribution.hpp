@@ -0,0 +1,167 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_DISTRIBUTION_HPP_
+#define MODULES_CORE_INCLUDE_DISTRIBUTION_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ppc::core {
+
+// How size elements are dealt to parts (usually ranks):
+// BLOCK         one contiguous range per part, the first size % parts parts get one
+//               element more
+// CYCLIC        element i to part i % parts
+// BLOCK_CYCLIC  blocks of block elements, block j to part j % parts
+enum class Scheme { BLOCK, CYCLIC, BLOCK_CYCLIC };
+
+std::string to_string(Scheme scheme);
+
+// Distribution of a 1D range. The elements of a part are stored together in increasing
+// global order (its local order), the parts one after another in part order (the packed
+// order of scatterv and gatherv). Throws std::invalid_argument for parts < 1 and for
+// BLOCK_CYCLIC with block 0.
+class Distribution {
+ public:
+  Distribution(size_t size, int parts, Scheme scheme = Scheme::BLOCK, size_t block = 1);
+
+  [[nodiscard]] size_t size() const { return size_; }
+  [[nodiscard]] int parts() const { return parts_; }
+  [[nodiscard]] Scheme scheme() const { return scheme_; }
+
+  [[nodiscard]] int owner(size_t i) const;
+  [[nodiscard]] size_t local_index(size_t i) const;
+  [[nodiscard]] size_t global_index(int part, size_t local) const;
+  [[nodiscard]] size_t count(int part) const { return offsets_[part + 1] - offsets_[part]; }
+  // start of part in the packed order
+  [[nodiscard]] size_t displacement(int part) const { return offsets_[part]; }
+  // true if the packed order is the global order, so that pack() and unpack() copy only
+  [[nodiscard]] bool contiguous() const { return scheme_ == Scheme::BLOCK || parts_ == 1; }
+
+  // counts and displacements of all parts for the v-collectives of MPI, which take int;
+  // throws std::invalid_argument if they do not fit
+  [[nodiscard]] std::vector<int> counts() const;
+  [[nodiscard]] std::vector<int> displacements() const;
+
+  // f(global_begin, local_begin, length) for the contiguous runs of part in local order
+  template <class F>
+  void for_each_run(int part, F&& f) const {
+    if (scheme_ == Scheme::BLOCK) {
+      f(displacement(part), size_t(0), count(part));
+      return;
+    }
+    const size_t blocks = (size_ + block_ - 1) / block_;
+    for (size_t j = part, local = 0; j < blocks; j += parts_, local += block_) {
+      f(j * block_, local, std::min(block_, size_ - j * block_));
+    }
+  }
+
+  // global (size() elements in global order) to packed (in packed order) and back
+  template <class T>
+  void pack(const T* global, T* packed) const {
+    for (int part = 0; part < parts_; part++) {
+      T* destination = packed + displacement(part);
+      for_each_run(part, [&](size_t global_begin, size_t local_begin, size_t length) {
+        std::copy_n(global + global_begin, length, destination + local_begin);
+      });
+    }
+  }
+
+  template <class T>
+  void unpack(const T* packed, T* global) const {
+    for (int part = 0; part < parts_; part++) {
+      const T* source = packed + displacement(part);
+      for_each_run(part, [&](size_t global_begin, size_t local_begin, size_t length) {
+        std::copy_n(source + local_begin, length, global + global_begin);
+      });
+    }
+  }
+
+ private:
+  size_t size_;
+  int parts_;
+  Scheme scheme_;
+  size_t block_;
+  // displacements of all parts and size_
+  std::vector<size_t> offsets_;
+};
+
+// Distribution of a rows x columns row-major matrix over a grid of rows().parts() x
+// columns().parts() parts: part r * columns().parts() + c owns the rows of part r of
+// rows() and the columns of part c of columns(), stored row-major as a local_rows(part) x
+// local_columns(part) matrix. The parts follow one another in part order, as in
+// Distribution.
+class Distribution2D {
+ public:
+  Distribution2D(Distribution rows, Distribution columns);
+
+  // Horizontal stripes, vertical stripes and tiles of a grid_rows x grid_columns grid;
+  // block is the block of BLOCK_CYCLIC in both dimensions
+  static Distribution2D by_rows(size_t rows, size_t columns, int parts, Scheme scheme = Scheme::BLOCK,
+                                size_t block = 1);
+  static Distribution2D by_columns(size_t rows, size_t columns, int parts, Scheme scheme = Scheme::BLOCK,
+                                   size_t block = 1);
+  static Distribution2D by_tiles(size_t rows, size_t columns, int grid_rows, int grid_columns,
+                                 Scheme scheme = Scheme::BLOCK, size_t block = 1);
+
+  [[nodiscard]] const Distribution& rows() const { return rows_; }
+  [[nodiscard]] const Distribution& columns() const { return columns_; }
+  [[nodiscard]] size_t size() const { return rows_.size() * columns_.size(); }
+  [[nodiscard]] int parts() const { return rows_.parts() * columns_.parts(); }
+
+  [[nodiscard]] int owner(size_t row, size_t column) const {
+    return rows_.owner(row) * columns_.parts() + columns_.owner(column);
+  }
+  [[nodiscard]] size_t local_rows(int part) const { return rows_.count(part / columns_.parts()); }
+  [[nodiscard]] size_t local_columns(int part) const { return columns_.count(part % columns_.parts()); }
+  [[nodiscard]] size_t count(int part) const { return local_rows(part) * local_columns(part); }
+  [[nodiscard]] size_t displacement(int part) const { return offsets_[part]; }
+  [[nodiscard]] bool contiguous() const { return rows_.contiguous() && columns_.parts() == 1; }
+
+  [[nodiscard]] std::vector<int> counts() const;
+  [[nodiscard]] std::vector<int> displacements() const;
+
+  template <class T>
+  void pack(const T* global, T* packed) const {
+    for_each_row_run([&](size_t global_begin, size_t local_begin, size_t length) {
+      std::copy_n(global + global_begin, length, packed + local_begin);
+    });
+  }
+
+  template <class T>
+  void unpack(const T* packed, T* global) const {
+    for_each_row_run([&](size_t global_begin, size_t local_begin, size_t length) {
+      std::copy_n(packed + local_begin, length, global + global_begin);
+    });
+  }
+
+ private:
+  // f(global_begin, packed_begin, length) for the column runs of every local row of
+  // every part
+  template <class F>
+  void for_each_row_run(F&& f) const {
+    const size_t width = columns_.size();
+    for (int part = 0; part < parts(); part++) {
+      const int row_part = part / columns_.parts();
+      const int column_part = part % columns_.parts();
+      const size_t begin = displacement(part);
+      const size_t local_width = local_columns(part);
+      for (size_t local_row = 0; local_row < local_rows(part); local_row++) {
+        const size_t row = rows_.global_index(row_part, local_row);
+        columns_.for_each_run(column_part, [&](size_t global_begin, size_t local_begin, size_t length) {
+          f(row * width + global_begin, begin + local_row * local_width + local_begin, length);
+        });
+      }
+    }
+  }
+
+  Distribution rows_;
+  Distribution columns_;
+  std::vector<size_t> offsets_;
+};
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_DISTRIBUTION_HPP_
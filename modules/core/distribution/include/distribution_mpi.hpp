@@ -0,0 +1,100 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_DISTRIBUTION_MPI_HPP_
+#define MODULES_CORE_INCLUDE_DISTRIBUTION_MPI_HPP_
+
+#include <mpi.h>
+
+#include <boost/mpi/communicator.hpp>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "core/distribution/include/distribution.hpp"
+
+// scatterv and gatherv of a Distribution or a Distribution2D over the ranks of a
+// communicator: one MPI_Scatterv or MPI_Gatherv instead of a loop of sends from the
+// root. Header-only, so the core library does not depend on MPI.
+namespace ppc::core {
+
+namespace detail {
+
+// MPI datatype of one element, so that counts and displacements are in elements
+class ElementType {
+ public:
+  explicit ElementType(size_t bytes) {
+    MPI_Type_contiguous(static_cast<int>(bytes), MPI_BYTE, &type);
+    MPI_Type_commit(&type);
+  }
+  ElementType(const ElementType&) = delete;
+  ElementType& operator=(const ElementType&) = delete;
+  ~ElementType() { MPI_Type_free(&type); }
+  [[nodiscard]] MPI_Datatype get() const { return type; }
+
+ private:
+  MPI_Datatype type = MPI_DATATYPE_NULL;
+};
+
+template <class Layout>
+void check_distribution(const boost::mpi::communicator& comm, const Layout& distribution, int root) {
+  if (distribution.parts() != comm.size()) {
+    throw std::invalid_argument("Distribution: parts must be the ranks of the communicator");
+  }
+  if (root < 0 || root >= comm.size()) throw std::invalid_argument("Distribution: root out of the communicator");
+}
+
+}  // namespace detail
+
+// Part rank of in (distribution.size() elements in global order, used on root only) to
+// out of every rank, distribution.count(rank) elements in local order. The root packs in
+// first unless distribution.contiguous().
+template <class T, class Layout>
+void scatterv(const boost::mpi::communicator& comm, const T* in, T* out, const Layout& distribution,
+              int root = 0) {
+  static_assert(std::is_trivially_copyable_v<T>, "distributions send elements as bytes");
+  detail::check_distribution(comm, distribution, root);
+  const detail::ElementType type(sizeof(T));
+  const auto counts = distribution.counts();
+  const int count = counts[comm.rank()];
+  if (comm.rank() != root) {
+    MPI_Scatterv(nullptr, nullptr, nullptr, type.get(), out, count, type.get(), root, comm);
+    return;
+  }
+  std::vector<T> packed;
+  if (!distribution.contiguous()) {
+    packed.resize(distribution.size());
+    distribution.pack(in, packed.data());
+    in = packed.data();
+  }
+  const auto displacements = distribution.displacements();
+  MPI_Scatterv(in, counts.data(), displacements.data(), type.get(), out, count, type.get(), root, comm);
+}
+
+// The reverse of scatterv(): the parts of all ranks to out of root in global order; out is
+// used on root only
+template <class T, class Layout>
+void gatherv(const boost::mpi::communicator& comm, const T* in, T* out, const Layout& distribution,
+             int root = 0) {
+  static_assert(std::is_trivially_copyable_v<T>, "distributions send elements as bytes");
+  detail::check_distribution(comm, distribution, root);
+  const detail::ElementType type(sizeof(T));
+  const auto counts = distribution.counts();
+  const int count = counts[comm.rank()];
+  if (comm.rank() != root) {
+    MPI_Gatherv(in, count, type.get(), nullptr, nullptr, nullptr, type.get(), root, comm);
+    return;
+  }
+  std::vector<T> packed;
+  T* destination = out;
+  if (!distribution.contiguous()) {
+    packed.resize(distribution.size());
+    destination = packed.data();
+  }
+  const auto displacements = distribution.displacements();
+  MPI_Gatherv(in, count, type.get(), destination, counts.data(), displacements.data(), type.get(), root, comm);
+  if (!distribution.contiguous()) distribution.unpack(packed.data(), out);
+}
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_DISTRIBUTION_MPI_HPP_
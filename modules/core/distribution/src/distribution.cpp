@@ -0,0 +1,115 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/distribution/include/distribution.hpp"
+
+#include <climits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+std::vector<int> to_int(const std::vector<size_t>& values, const std::string& what) {
+  std::vector<int> result(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    if (values[i] > static_cast<size_t>(INT_MAX)) {
+      throw std::invalid_argument("Distribution: " + what + " do not fit into int");
+    }
+    result[i] = static_cast<int>(values[i]);
+  }
+  return result;
+}
+
+std::vector<int> counts_of(const std::vector<size_t>& offsets) {
+  std::vector<size_t> counts(offsets.size() - 1);
+  for (size_t i = 0; i < counts.size(); i++) counts[i] = offsets[i + 1] - offsets[i];
+  return to_int(counts, "counts");
+}
+
+std::vector<int> displacements_of(const std::vector<size_t>& offsets) {
+  return to_int(std::vector<size_t>(offsets.begin(), offsets.end() - 1), "displacements");
+}
+
+}  // namespace
+
+std::string ppc::core::to_string(Scheme scheme) {
+  switch (scheme) {
+    case Scheme::BLOCK:
+      return "block";
+    case Scheme::CYCLIC:
+      return "cyclic";
+    case Scheme::BLOCK_CYCLIC:
+      return "block_cyclic";
+  }
+  return "unknown";
+}
+
+ppc::core::Distribution::Distribution(size_t size, int parts, Scheme scheme, size_t block)
+    : size_(size), parts_(parts), scheme_(scheme), block_(scheme == Scheme::BLOCK_CYCLIC ? block : 1) {
+  if (parts < 1) throw std::invalid_argument("Distribution: parts must be positive");
+  if (block_ == 0) throw std::invalid_argument("Distribution: block can't be empty");
+  offsets_.resize(parts + 1, 0);
+  const auto parts_count = static_cast<size_t>(parts);
+  for (int part = 0; part < parts; part++) {
+    const auto index = static_cast<size_t>(part);
+    size_t count = 0;
+    if (scheme_ == Scheme::BLOCK) {
+      count = size / parts_count + (index < size % parts_count ? 1 : 0);
+    } else {
+      // whole blocks, the last block of the range may be short
+      const size_t blocks = (size + block_ - 1) / block_;
+      const size_t own = blocks / parts_count + (index < blocks % parts_count ? 1 : 0);
+      count = own * block_;
+      if (own > 0 && (blocks - 1) % parts_count == index) count -= blocks * block_ - size;
+    }
+    offsets_[part + 1] = offsets_[part] + count;
+  }
+}
+
+int ppc::core::Distribution::owner(size_t i) const {
+  if (scheme_ == Scheme::BLOCK) {
+    // the first size % parts parts have one element more
+    const size_t small = size_ / parts_;
+    const size_t large_parts = size_ % parts_;
+    if (i < large_parts * (small + 1)) return static_cast<int>(i / (small + 1));
+    return static_cast<int>(large_parts + (i - large_parts * (small + 1)) / small);
+  }
+  return static_cast<int>((i / block_) % parts_);
+}
+
+size_t ppc::core::Distribution::local_index(size_t i) const {
+  if (scheme_ == Scheme::BLOCK) return i - displacement(owner(i));
+  return (i / block_ / parts_) * block_ + i % block_;
+}
+
+size_t ppc::core::Distribution::global_index(int part, size_t local) const {
+  if (scheme_ == Scheme::BLOCK) return displacement(part) + local;
+  return ((local / block_) * parts_ + part) * block_ + local % block_;
+}
+
+std::vector<int> ppc::core::Distribution::counts() const { return counts_of(offsets_); }
+
+std::vector<int> ppc::core::Distribution::displacements() const { return displacements_of(offsets_); }
+
+ppc::core::Distribution2D::Distribution2D(Distribution rows, Distribution columns)
+    : rows_(std::move(rows)), columns_(std::move(columns)) {
+  offsets_.resize(parts() + 1, 0);
+  for (int part = 0; part < parts(); part++) offsets_[part + 1] = offsets_[part] + count(part);
+}
+
+ppc::core::Distribution2D ppc::core::Distribution2D::by_rows(size_t rows, size_t columns, int parts, Scheme scheme,
+                                                             size_t block) {
+  return {Distribution(rows, parts, scheme, block), Distribution(columns, 1)};
+}
+
+ppc::core::Distribution2D ppc::core::Distribution2D::by_columns(size_t rows, size_t columns, int parts,
+                                                                Scheme scheme, size_t block) {
+  return {Distribution(rows, 1), Distribution(columns, parts, scheme, block)};
+}
+
+ppc::core::Distribution2D ppc::core::Distribution2D::by_tiles(size_t rows, size_t columns, int grid_rows,
+                                                              int grid_columns, Scheme scheme, size_t block) {
+  return {Distribution(rows, grid_rows, scheme, block), Distribution(columns, grid_columns, scheme, block)};
+}
+
+std::vector<int> ppc::core::Distribution2D::counts() const { return counts_of(offsets_); }
+
+std::vector<int> ppc::core::Distribution2D::displacements() const { return displacements_of(offsets_); }
@@ -0,0 +1,134 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "core/numa/include/numa.hpp"
+#include "core/numa/include/numa_allocator.hpp"
+#include "core/task/func_tests/test_task.hpp"
+#include "core/task/include/execution.hpp"
+#include "core/task/include/thread_pool.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+// two nodes with cores {0, 1, 2} and {4, 5}
+ppc::core::NumaTopology two_nodes() {
+  ppc::core::NumaTopology topology;
+  topology.nodes.push_back({0, {0, 1, 2}});
+  topology.nodes.push_back({1, {4, 5}});
+  return topology;
+}
+
+}  // namespace
+
+TEST(numa_tests, check_config_names) {
+  using ppc::core::MemoryPlacement;
+  using ppc::core::ThreadPinning;
+  for (auto placement : {MemoryPlacement::DEFAULT, MemoryPlacement::FIRST_TOUCH, MemoryPlacement::INTERLEAVE}) {
+    EXPECT_EQ(ppc::core::placement_from_string(ppc::core::to_string(placement)), placement);
+  }
+  for (auto pinning : {ThreadPinning::NONE, ThreadPinning::COMPACT, ThreadPinning::SPREAD}) {
+    EXPECT_EQ(ppc::core::pinning_from_string(ppc::core::to_string(pinning)), pinning);
+  }
+  EXPECT_THROW(static_cast<void>(ppc::core::placement_from_string("local")), std::invalid_argument);
+  EXPECT_THROW(static_cast<void>(ppc::core::pinning_from_string("")), std::invalid_argument);
+}
+
+TEST(numa_tests, check_topology_has_cores) {
+  const auto& topology = ppc::core::numa_topology();
+  ASSERT_FALSE(topology.nodes.empty());
+  uint64_t num_cpus = 0;
+  for (const auto& node : topology.nodes) num_cpus += node.cpus.size();
+  EXPECT_GT(num_cpus, 0U);
+}
+
+TEST(numa_tests, check_cpu_for_thread) {
+  const auto topology = two_nodes();
+  std::vector<uint32_t> compact;
+  std::vector<uint32_t> spread;
+  for (uint64_t i = 0; i < 6; i++) {
+    compact.push_back(ppc::core::cpu_for_thread(i, ppc::core::ThreadPinning::COMPACT, topology));
+    spread.push_back(ppc::core::cpu_for_thread(i, ppc::core::ThreadPinning::SPREAD, topology));
+  }
+  EXPECT_EQ(compact, (std::vector<uint32_t>{0, 1, 2, 4, 5, 0}));
+  EXPECT_EQ(spread, (std::vector<uint32_t>{0, 4, 1, 5, 2, 0}));
+}
+
+#ifdef __linux__
+TEST(numa_tests, check_pin_current_thread) {
+  const uint32_t cpu = ppc::core::cpu_for_thread(0, ppc::core::ThreadPinning::COMPACT);
+  bool pinned = false;
+  int running_on = -1;
+  // on a separate thread, so the affinity of the test runner stays as it is
+  std::thread thread([&] {
+    pinned = ppc::core::pin_current_thread(cpu);
+    running_on = sched_getcpu();
+  });
+  thread.join();
+  ASSERT_TRUE(pinned);
+  EXPECT_EQ(running_on, static_cast<int>(cpu));
+}
+
+TEST(numa_tests, check_pinned_region_keeps_affinity_of_caller) {
+  cpu_set_t before;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(before), &before), 0);
+  for (auto backend : ppc::core::available_backends()) {
+    const ppc::core::ExecutionPolicy policy{backend, 3, ppc::core::ThreadPinning::COMPACT};
+    std::vector<int> out(12, 0);
+    ppc::core::parallel_for(policy, out.size(), [&](uint64_t i) { out[i] = 1; });
+    EXPECT_EQ(std::accumulate(out.begin(), out.end(), 0), 12) << ppc::core::to_string(backend);
+
+    cpu_set_t after;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(after), &after), 0);
+    EXPECT_TRUE(CPU_EQUAL(&before, &after)) << ppc::core::to_string(backend);
+  }
+}
+#endif
+
+TEST(numa_tests, check_numa_vector_placements) {
+  using ppc::core::MemoryPlacement;
+  const ppc::core::ExecutionPolicy policy{ppc::core::Backend::STL, 3};
+  for (auto placement : {MemoryPlacement::DEFAULT, MemoryPlacement::FIRST_TOUCH, MemoryPlacement::INTERLEAVE}) {
+    // below and above the size mapped from the OS
+    for (size_t count : {size_t(100), size_t(1) << 18}) {
+      ppc::core::numa_vector<int64_t> data(count, 0, ppc::core::NumaAllocator<int64_t>(placement, policy));
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(data.data()) % 64, 0U);
+      std::iota(data.begin(), data.end(), int64_t(1));
+      const auto n = static_cast<int64_t>(count);
+      EXPECT_EQ(std::accumulate(data.begin(), data.end(), int64_t(0)), n * (n + 1) / 2);
+    }
+  }
+}
+
+TEST(numa_tests, check_task_with_numa_vector) {
+  ppc::core::NumaAllocator<int32_t> allocator(ppc::core::MemoryPlacement::FIRST_TOUCH);
+  ppc::core::numa_vector<int32_t> in(1 << 16, 1, allocator);
+  ppc::core::numa_vector<int32_t> out(1, 0, allocator);
+
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(in);
+  taskData->add_output(out);
+
+  ppc::test::TestTask<int32_t> testTask(taskData);
+  ASSERT_TRUE(testTask.validation());
+  testTask.pre_processing();
+  testTask.run();
+  testTask.post_processing();
+  EXPECT_EQ(out[0], 1 << 16);
+}
+
+TEST(numa_tests, check_pinned_thread_pool) {
+  ppc::core::ThreadPool pool(2, ppc::core::ThreadPinning::COMPACT);
+  auto first = pool.submit([] { return 20; });
+  auto second = pool.submit([] { return 22; });
+  EXPECT_EQ(first.get() + second.get(), 42);
+}
@@ -0,0 +1,85 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_NUMA_HPP_
+#define MODULES_CORE_INCLUDE_NUMA_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ppc::core {
+
+// Where the pages of large buffers go on machines with several NUMA nodes:
+// DEFAULT leaves it to the OS (the node of the thread that touches a page first, usually
+// the main thread), FIRST_TOUCH touches the pages from the threads that will process
+// them, INTERLEAVE spreads the pages round robin over all nodes.
+enum class MemoryPlacement { DEFAULT, FIRST_TOUCH, INTERLEAVE };
+
+// Which core worker i of a parallel backend runs on: NONE lets the OS move threads,
+// COMPACT fills the cores of one node before the next, SPREAD takes one core of every
+// node in turn.
+enum class ThreadPinning { NONE, COMPACT, SPREAD };
+
+struct NumaConfig {
+  MemoryPlacement placement = MemoryPlacement::DEFAULT;
+  ThreadPinning pinning = ThreadPinning::NONE;
+};
+
+// "default", "first_touch", "interleave" and "none", "compact", "spread"
+std::string to_string(MemoryPlacement placement);
+std::string to_string(ThreadPinning pinning);
+MemoryPlacement placement_from_string(const std::string& name);
+ThreadPinning pinning_from_string(const std::string& name);
+
+// Configuration of the PPC_NUMA_PLACEMENT and PPC_PIN_THREADS environment variables,
+// read on the first call. Throws on unknown values.
+const NumaConfig& numa_config();
+
+struct NumaNode {
+  uint32_t id = 0;
+  // cores of the node this process may run on
+  std::vector<uint32_t> cpus;
+};
+
+struct NumaTopology {
+  std::vector<NumaNode> nodes;
+};
+
+// Nodes from /sys/devices/system/node on Linux; elsewhere, or when it is not there, one
+// node with all cores
+const NumaTopology& numa_topology();
+
+// Core for thread index under pinning, the cores are taken in turn when there are more
+// threads than cores
+uint32_t cpu_for_thread(uint64_t index, ThreadPinning pinning, const NumaTopology& topology = numa_topology());
+
+// Bind the calling thread to one core, false where the OS does not support or refuses it
+bool pin_current_thread(uint32_t cpu);
+
+// Pin the calling thread as thread index of a backend under pinning, once per thread;
+// later calls on the same thread do nothing. Only for worker threads: the affinity of a
+// thread passes on to every thread it starts later.
+void pin_current_thread_once(uint64_t index, ThreadPinning pinning);
+
+namespace detail {
+
+// Memory for bytes aligned to 64 bytes at least. Blocks of LARGE_BLOCK bytes and more are
+// mapped from the OS, with INTERLEAVE applied on Linux. Throws std::bad_alloc.
+constexpr size_t LARGE_BLOCK = size_t(1) << 16;
+void* allocate_pages(size_t bytes, MemoryPlacement placement);
+void free_pages(void* data, size_t bytes);
+
+// Called with the size of every block mapped from the OS and with its negated size when
+// it is unmapped, as operator new never sees those blocks; the perf module installs one
+// to count them as heap. nullptr (the default) removes it.
+using MappingHook = void (*)(int64_t bytes);
+void set_mapping_hook(MappingHook hook);
+// Write to the pages of data starting in [begin, end), so the calling thread touches them first
+void touch_pages(void* data, size_t begin, size_t end);
+
+}  // namespace detail
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_NUMA_HPP_
@@ -0,0 +1,59 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_NUMA_ALLOCATOR_HPP_
+#define MODULES_CORE_INCLUDE_NUMA_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/numa/include/numa.hpp"
+#include "core/task/include/execution.hpp"
+
+namespace ppc::core {
+
+// Allocator for the large buffers of a task (TaskData inputs and outputs, work arrays),
+// placed by MemoryPlacement. FIRST_TOUCH touches element range c of a parallel_for over
+// the buffer from the thread that runs chunk c under policy, so the pages land on the
+// node of that thread. That is exact for OMP, where chunk c always runs on thread c
+// (pinned with PPC_PIN_THREADS), and a best effort for the work-stealing backends.
+template <class T>
+class NumaAllocator {
+ public:
+  using value_type = T;
+
+  explicit NumaAllocator(MemoryPlacement placement_ = numa_config().placement,
+                         ExecutionPolicy policy_ = policy_from_env())
+      : placement(placement_), policy(policy_) {}
+  template <class U>
+  explicit NumaAllocator(const NumaAllocator<U>& other) : placement(other.placement), policy(other.policy) {}
+
+  T* allocate(size_t n) {
+    auto* data = static_cast<T*>(detail::allocate_pages(n * sizeof(T), placement));
+    if (placement == MemoryPlacement::FIRST_TOUCH && n * sizeof(T) >= detail::LARGE_BLOCK) {
+      const uint64_t num_chunks = detail::num_chunks(policy, n);
+      detail::for_each_chunk(policy, num_chunks, [&](uint64_t c) {
+        detail::touch_pages(data, detail::chunk_begin(n, num_chunks, c) * sizeof(T),
+                            detail::chunk_begin(n, num_chunks, c + 1) * sizeof(T));
+      });
+    }
+    return data;
+  }
+  void deallocate(T* data, size_t n) { detail::free_pages(data, n * sizeof(T)); }
+
+  template <class U>
+  bool operator==(const NumaAllocator<U>& other) const {
+    return placement == other.placement && policy.backend == other.policy.backend &&
+           policy.num_threads == other.policy.num_threads;
+  }
+
+  MemoryPlacement placement;
+  ExecutionPolicy policy;
+};
+
+template <class T>
+using numa_vector = std::vector<T, NumaAllocator<T>>;
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_NUMA_ALLOCATOR_HPP_
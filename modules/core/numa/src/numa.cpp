@@ -0,0 +1,258 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/numa/include/numa.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace {
+
+using ppc::core::NumaNode;
+using ppc::core::NumaTopology;
+
+constexpr size_t ALIGNMENT = 64;
+
+std::atomic<ppc::core::detail::MappingHook> mapping_hook{nullptr};
+
+#ifdef __linux__
+// from linux/mempolicy.h, part of the kernel ABI
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+// "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+std::vector<uint32_t> parse_cpu_list(const std::string& list) {
+  std::vector<uint32_t> cpus;
+  std::stringstream stream(list);
+  for (std::string range; std::getline(stream, range, ',');) {
+    if (range.empty()) continue;
+    const auto dash = range.find('-');
+    const auto first = static_cast<uint32_t>(std::stoul(range.substr(0, dash)));
+    const auto last = dash == std::string::npos ? first : static_cast<uint32_t>(std::stoul(range.substr(dash + 1)));
+    for (uint32_t cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+NumaTopology read_topology() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  const bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+  const auto is_allowed = [&](uint32_t cpu) { return !has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)); };
+
+  NumaTopology topology;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+    const std::string name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+        !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      continue;
+    }
+    NumaNode node;
+    node.id = static_cast<uint32_t>(std::stoul(name.substr(4)));
+    std::ifstream cpulist(entry.path() / "cpulist");
+    std::string list;
+    std::getline(cpulist, list);
+    for (auto cpu : parse_cpu_list(list)) {
+      if (is_allowed(cpu)) node.cpus.push_back(cpu);
+    }
+    topology.nodes.push_back(std::move(node));
+  }
+  std::sort(topology.nodes.begin(), topology.nodes.end(),
+            [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+  return topology;
+}
+#endif
+
+// one node of the cores this process may use
+NumaTopology flat_topology() {
+  NumaTopology topology;
+  topology.nodes.emplace_back();
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &allowed)) topology.nodes[0].cpus.push_back(cpu);
+    }
+    return topology;
+  }
+#endif
+  const uint32_t count = std::max(1U, std::thread::hardware_concurrency());
+  for (uint32_t cpu = 0; cpu < count; cpu++) topology.nodes[0].cpus.push_back(cpu);
+  return topology;
+}
+
+size_t page_size() {
+#ifdef __linux__
+  static const auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+#else
+  return 4096;
+#endif
+}
+
+}  // namespace
+
+std::string ppc::core::to_string(MemoryPlacement placement) {
+  switch (placement) {
+    case MemoryPlacement::FIRST_TOUCH:
+      return "first_touch";
+    case MemoryPlacement::INTERLEAVE:
+      return "interleave";
+    default:
+      return "default";
+  }
+}
+
+std::string ppc::core::to_string(ThreadPinning pinning) {
+  switch (pinning) {
+    case ThreadPinning::COMPACT:
+      return "compact";
+    case ThreadPinning::SPREAD:
+      return "spread";
+    default:
+      return "none";
+  }
+}
+
+ppc::core::MemoryPlacement ppc::core::placement_from_string(const std::string& name) {
+  for (auto placement : {MemoryPlacement::DEFAULT, MemoryPlacement::FIRST_TOUCH, MemoryPlacement::INTERLEAVE}) {
+    if (to_string(placement) == name) return placement;
+  }
+  throw std::invalid_argument("Unknown memory placement: " + name);
+}
+
+ppc::core::ThreadPinning ppc::core::pinning_from_string(const std::string& name) {
+  for (auto pinning : {ThreadPinning::NONE, ThreadPinning::COMPACT, ThreadPinning::SPREAD}) {
+    if (to_string(pinning) == name) return pinning;
+  }
+  throw std::invalid_argument("Unknown thread pinning: " + name);
+}
+
+const ppc::core::NumaConfig& ppc::core::numa_config() {
+  static const NumaConfig config = [] {
+    NumaConfig result;
+    if (const char* placement = std::getenv("PPC_NUMA_PLACEMENT")) result.placement = placement_from_string(placement);
+    if (const char* pinning = std::getenv("PPC_PIN_THREADS")) result.pinning = pinning_from_string(pinning);
+    return result;
+  }();
+  return config;
+}
+
+const ppc::core::NumaTopology& ppc::core::numa_topology() {
+  static const NumaTopology topology = [] {
+#ifdef __linux__
+    auto result = read_topology();
+    // nodes without cores hold memory only
+    const bool has_cpus =
+        std::any_of(result.nodes.begin(), result.nodes.end(), [](const NumaNode& node) { return !node.cpus.empty(); });
+    if (has_cpus) return result;
+#endif
+    return flat_topology();
+  }();
+  return topology;
+}
+
+uint32_t ppc::core::cpu_for_thread(uint64_t index, ThreadPinning pinning, const NumaTopology& topology) {
+  std::vector<uint32_t> order;
+  if (pinning == ThreadPinning::SPREAD) {
+    size_t max_cpus = 0;
+    for (const auto& node : topology.nodes) max_cpus = std::max(max_cpus, node.cpus.size());
+    for (size_t i = 0; i < max_cpus; i++) {
+      for (const auto& node : topology.nodes) {
+        if (i < node.cpus.size()) order.push_back(node.cpus[i]);
+      }
+    }
+  } else {
+    for (const auto& node : topology.nodes) order.insert(order.end(), node.cpus.begin(), node.cpus.end());
+  }
+  if (order.empty()) return 0;
+  return order[index % order.size()];
+}
+
+bool ppc::core::pin_current_thread(uint32_t cpu) {
+#ifdef __linux__
+  if (cpu >= CPU_SETSIZE) return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return sched_setaffinity(0, sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+  if (cpu >= 8 * sizeof(DWORD_PTR)) return false;
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+  static_cast<void>(cpu);
+  return false;
+#endif
+}
+
+void ppc::core::pin_current_thread_once(uint64_t index, ThreadPinning pinning) {
+  thread_local bool pinned = false;
+  if (pinned || pinning == ThreadPinning::NONE) return;
+  pinned = true;
+  pin_current_thread(cpu_for_thread(index, pinning));
+}
+
+void ppc::core::detail::set_mapping_hook(MappingHook hook) { mapping_hook = hook; }
+
+void* ppc::core::detail::allocate_pages(size_t bytes, MemoryPlacement placement) {
+  if (bytes < LARGE_BLOCK) return ::operator new(std::max<size_t>(bytes, 1), std::align_val_t(ALIGNMENT));
+#ifdef __linux__
+  void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) throw std::bad_alloc();
+  // operator new would count the small blocks
+  if (auto hook = mapping_hook.load()) hook(static_cast<int64_t>(bytes));
+  const auto& nodes = numa_topology().nodes;
+  if (placement == MemoryPlacement::INTERLEAVE && nodes.size() > 1) {
+    std::vector<unsigned long> mask(nodes.back().id / (8 * sizeof(unsigned long)) + 1, 0);
+    for (const auto& node : nodes) {
+      mask[node.id / (8 * sizeof(unsigned long))] |= 1UL << (node.id % (8 * sizeof(unsigned long)));
+    }
+    // the pages are not touched yet, so all of them follow the policy; on failure they
+    // keep the default one
+    syscall(SYS_mbind, data, bytes, MPOL_INTERLEAVE_MODE, mask.data(), mask.size() * 8 * sizeof(unsigned long) + 1,
+            0);
+  }
+  return data;
+#else
+  static_cast<void>(placement);
+  return ::operator new(bytes, std::align_val_t(ALIGNMENT));
+#endif
+}
+
+void ppc::core::detail::free_pages(void* data, size_t bytes) {
+  if (data == nullptr) return;
+  if (bytes < LARGE_BLOCK) {
+    ::operator delete(data, std::align_val_t(ALIGNMENT));
+    return;
+  }
+#ifdef __linux__
+  if (auto hook = mapping_hook.load()) hook(-static_cast<int64_t>(bytes));
+  munmap(data, bytes);
+#else
+  ::operator delete(data, std::align_val_t(ALIGNMENT));
+#endif
+}
+
+void ppc::core::detail::touch_pages(void* data, size_t begin, size_t end) {
+  const size_t page = page_size();
+  auto* bytes = static_cast<volatile char*>(data);
+  for (size_t offset = (begin + page - 1) / page * page; offset < end; offset += page) bytes[offset] = 0;
+}
@@ -0,0 +1,149 @@
+// Copyright 2024 Nesterov Alexander
+// Replacement of the global operator new/delete that feeds AllocTracker. It is not a
+// part of core_module_lib: only the perf test binaries compile it in (see
+// tasks/CMakeLists.txt), so other binaries keep the default allocator.
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "core/perf/include/alloc_tracker.hpp"
+
+#if defined(__linux__) || defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+namespace {
+
+size_t usable_size(void* ptr) {
+#if defined(__linux__)
+  return malloc_usable_size(ptr);
+#elif defined(__APPLE__)
+  return malloc_size(ptr);
+#elif defined(_WIN32)
+  return _msize(ptr);
+#else
+  return 0;
+#endif
+}
+
+void* tracked_malloc(std::size_t size) noexcept {
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr != nullptr) ppc::core::AllocTracker::on_allocation(usable_size(ptr));
+  return ptr;
+}
+
+void tracked_free(void* ptr) noexcept {
+  if (ptr == nullptr) return;
+  ppc::core::AllocTracker::on_deallocation(usable_size(ptr));
+  std::free(ptr);
+}
+
+// the overloads with std::align_val_t, e.g. of the buffers of numa.hpp and arena.hpp
+size_t aligned_size(void* ptr, std::size_t alignment) {
+#if defined(_WIN32)
+  return _aligned_msize(ptr, alignment, 0);
+#else
+  static_cast<void>(alignment);
+  return usable_size(ptr);
+#endif
+}
+
+void* tracked_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept {
+  const auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#if defined(_WIN32)
+  void* ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, align, size == 0 ? 1 : size) != 0) ptr = nullptr;
+#endif
+  if (ptr != nullptr) ppc::core::AllocTracker::on_allocation(aligned_size(ptr, align));
+  return ptr;
+}
+
+void tracked_aligned_free(void* ptr, std::align_val_t alignment) noexcept {
+  if (ptr == nullptr) return;
+  ppc::core::AllocTracker::on_deallocation(
+      aligned_size(ptr, std::max(static_cast<std::size_t>(alignment), sizeof(void*))));
+#if defined(_WIN32)
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+const bool hooks_registered = [] {
+  ppc::core::AllocTracker::set_hooks_installed();
+  return true;
+}();
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  void* ptr = tracked_malloc(size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size) {
+  void* ptr = tracked_malloc(size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return tracked_malloc(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return tracked_malloc(size); }
+
+void operator delete(void* ptr) noexcept { tracked_free(ptr); }
+
+void operator delete[](void* ptr) noexcept { tracked_free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { tracked_free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { tracked_free(ptr); }
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  void* ptr = tracked_aligned_malloc(size, alignment);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  void* ptr = tracked_aligned_malloc(size, alignment);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return tracked_aligned_malloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return tracked_aligned_malloc(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept { tracked_aligned_free(ptr, alignment); }
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { tracked_aligned_free(ptr, alignment); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+  tracked_aligned_free(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+  tracked_aligned_free(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  tracked_aligned_free(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  tracked_aligned_free(ptr, alignment);
+}
@@ -1,10 +1,20 @@
 // Copyright 2023 Nesterov Alexander
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
 #include <vector>
 
+#include "core/numa/include/numa.hpp"
 #include "core/perf/func_tests/test_task.hpp"
 #include "core/perf/include/perf.hpp"
+#include "core/perf/include/perf_report.hpp"
+#include "core/perf/include/scaling.hpp"
 
 TEST(perf_tests, check_perf_pipeline) {
   // Create data
@@ -155,3 +165,651 @@ TEST(perf_tests, check_perf_task_float) {
   ASSERT_LE(perfResults->time_sec, 10.0);
   EXPECT_EQ(out[0], in.size());
 }
+
+TEST(perf_tests, check_perf_pipeline_statistical) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  // Create Perf attributes, every run takes exactly 0.5 ms of fake time
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 10;
+  perfAttr->num_warmup = 3;
+  perfAttr->type_of_measurement = ppc::core::PerfAttr::TypeOfMeasurement::STATISTICAL;
+  double fake_time = 0.0;
+  perfAttr->current_timer = [&] { return fake_time += 0.0005; };
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.pipeline_run(perfAttr, perfResults);
+
+  ASSERT_EQ(perfResults->samples.size(), perfAttr->num_running);
+  EXPECT_EQ(perfResults->statistics.num_samples, perfAttr->num_running);
+  EXPECT_NEAR(perfResults->statistics.median, 0.0005, 1e-9);
+  EXPECT_NEAR(perfResults->statistics.p99, 0.0005, 1e-9);
+  EXPECT_NEAR(perfResults->statistics.stddev, 0.0, 1e-9);
+  EXPECT_NEAR(perfResults->time_sec, 0.005, 1e-9);
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_perf_task_statistical_until_target_error) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  // Create Perf attributes, runs alternate between 0.5 ms and 1.5 ms of fake time
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 4;
+  perfAttr->type_of_measurement = ppc::core::PerfAttr::TypeOfMeasurement::STATISTICAL;
+  perfAttr->target_relative_error = 0.05;
+  double fake_time = 0.0;
+  uint64_t calls = 0;
+  perfAttr->current_timer = [&] { return fake_time += (calls++ % 4 < 2) ? 0.0005 : 0.0015; };
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.task_run(perfAttr, perfResults);
+
+  EXPECT_GT(perfResults->samples.size(), perfAttr->num_running);
+  EXPECT_LE(perfResults->statistics.relative_error, perfAttr->target_relative_error);
+  EXPECT_LE(perfResults->statistics.min, perfResults->statistics.median);
+  EXPECT_LE(perfResults->statistics.median, perfResults->statistics.max);
+  EXPECT_LE(perfResults->statistics.ci_low, perfResults->statistics.mean);
+  EXPECT_GE(perfResults->statistics.ci_high, perfResults->statistics.mean);
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_perf_task_statistical_target_error_needs_several_samples) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  // Create Perf attributes, one run asked for, every run takes exactly 0.5 ms of fake time
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 1;
+  perfAttr->type_of_measurement = ppc::core::PerfAttr::TypeOfMeasurement::STATISTICAL;
+  perfAttr->target_relative_error = 0.05;
+  double fake_time = 0.0;
+  perfAttr->current_timer = [&] { return fake_time += 0.0005; };
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.task_run(perfAttr, perfResults);
+
+  // a single sample has no confidence interval, so it can't reach the target
+  EXPECT_EQ(perfResults->samples.size(), 3U);
+  EXPECT_EQ(out[0], in.size());
+}
+
+#ifndef _WIN32
+TEST(perf_tests, check_perf_task_statistical_from_env) {
+  // PPC_PERF_STATISTICAL turns a TOTAL measurement into one sample per run after warmup
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 5;
+  uint64_t timer_calls = 0;
+  perfAttr->current_timer = [&] { return static_cast<double>(++timer_calls); };
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  setenv("PPC_PERF_STATISTICAL", "2", 1);
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.task_run(perfAttr, perfResults);
+  unsetenv("PPC_PERF_STATISTICAL");
+
+  EXPECT_EQ(perfResults->samples.size(), 5U);
+  EXPECT_EQ(timer_calls, 10U);
+  EXPECT_EQ(perfResults->phase_profile.phases[2].calls, 2U + 5U);
+  EXPECT_EQ(perfAttr->type_of_measurement, ppc::core::PerfAttr::TypeOfMeasurement::TOTAL);
+  EXPECT_EQ(out[0], in.size());
+}
+#endif
+
+TEST(perf_tests, check_statistics_reject_outliers) {
+  std::vector<double> samples(20, 1.0);
+  samples[3] = 1.1;
+  samples[7] = 0.9;
+  samples[11] = 50.0;
+
+  auto stats = ppc::core::compute_statistics(samples);
+  EXPECT_EQ(stats.num_outliers, 3U);
+  EXPECT_EQ(stats.num_samples, 17U);
+  EXPECT_DOUBLE_EQ(stats.max, 1.0);
+
+  auto all_stats = ppc::core::compute_statistics(samples, 0.0);
+  EXPECT_EQ(all_stats.num_outliers, 0U);
+  EXPECT_DOUBLE_EQ(all_stats.max, 50.0);
+  EXPECT_DOUBLE_EQ(ppc::core::percentile({1.0, 2.0, 3.0, 4.0, 5.0}, 0.9), 4.6);
+}
+
+TEST(perf_tests, check_perf_record_json_and_csv) {
+  ppc::core::PerfRecord record;
+  record.task_id = "example";
+  record.backend = "seq";
+  record.type_of_running = "pipeline";
+  record.input_size = 2000;
+  record.num_running = 2;
+  record.time_sec = 0.5;
+  record.samples = {0.25, 0.25};
+  record.statistics.relative_error = 0.125;
+  record.hardware.cpu_model = "CPU \"model\", rev 1";
+
+  auto json = ppc::core::to_json(record);
+  EXPECT_NE(json.find("\"task_id\":\"example\""), std::string::npos);
+  EXPECT_NE(json.find("\"relative_error\":0.125"), std::string::npos);
+  EXPECT_NE(json.find("\"samples\":[0.25,0.25]"), std::string::npos);
+  EXPECT_NE(json.find("CPU \\\"model\\\", rev 1"), std::string::npos);
+  EXPECT_NE(json.find("\"numa\":{\"memory_placement\":\"default\",\"thread_pinning\":\"none\"}"),
+            std::string::npos);
+
+  std::string path = "perf_tests_record.csv";
+  std::remove(path.c_str());
+  ppc::core::write_perf_record(path, record);
+  ppc::core::write_perf_record(path, record);
+
+  std::ifstream csv(path);
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(csv, line);) {
+    lines.push_back(line);
+  }
+  csv.close();
+  std::remove(path.c_str());
+
+  ASSERT_EQ(lines.size(), 3U);
+  EXPECT_EQ(lines[0], ppc::core::csv_header());
+  EXPECT_EQ(lines[1].rfind("example,seq,pipeline,", 0), 0U);
+  EXPECT_NE(lines[1].find("\"CPU \"\"model\"\", rev 1\""), std::string::npos);
+  EXPECT_EQ(lines[1].substr(lines[1].rfind(',') + 1), "0.25;0.25");
+
+  // every free-form field is quoted when it needs to be
+  record.type_of_running = "task,run";
+  record.memory_placement = "a,b";
+  record.thread_pinning = "\"c\"";
+  auto row = ppc::core::to_csv(record);
+  EXPECT_EQ(row.rfind("example,seq,\"task,run\",", 0), 0U);
+  EXPECT_NE(row.find(",\"a,b\",\"\"\"c\"\"\","), std::string::npos);
+}
+
+TEST(perf_tests, check_perf_task_hardware_counters) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  // Create Perf attributes
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 10;
+  perfAttr->use_hardware_counters = true;
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.task_run(perfAttr, perfResults);
+
+  // Counters may be unavailable here (containers, perf_event_paranoid), wall time is always there
+  const auto &run = perfResults->phase_counters[2];
+  EXPECT_EQ(perfResults->phase_counters[0].calls, 1U);
+  EXPECT_EQ(run.calls, perfAttr->num_running);
+  EXPECT_EQ(perfResults->phase_counters[3].calls, 1U);
+  EXPECT_GE(run.time_sec, 0.0);
+  if (run.has_counters) {
+    EXPECT_GT(run.instructions, 0U);
+    EXPECT_GT(run.ipc(), 0.0);
+  } else {
+    EXPECT_EQ(run.ipc(), 0.0);
+  }
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_perf_pipeline_phase_profile) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  // Create Perf attributes
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 10;
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.pipeline_run(perfAttr, perfResults);
+
+  for (const auto &phase : perfResults->phase_profile.phases) {
+    EXPECT_EQ(phase.calls, perfAttr->num_running);
+    EXPECT_LE(phase.entry, phase.exit);
+  }
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_strong_scaling_amdahl_fit) {
+  std::vector<uint32_t> in;
+  std::vector<uint32_t> out(1, 0);
+  uint64_t current_workers = 1;
+
+  auto scalingAttr = std::make_shared<ppc::core::ScalingAttr>();
+  scalingAttr->num_workers = {1, 2, 4, 8};
+  scalingAttr->input_sizes = {100, 200};
+  scalingAttr->make_task = [&](uint64_t num_workers, uint64_t input_size) {
+    current_workers = num_workers;
+    in.assign(input_size, 1);
+    auto taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskData->inputs_count.emplace_back(in.size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+    taskData->outputs_count.emplace_back(out.size());
+    return std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+  };
+
+  // Fake time of one run follows Amdahl's law with serial fraction 0.2
+  scalingAttr->perf_attr->num_running = 5;
+  double fake_time = 0.0;
+  scalingAttr->perf_attr->current_timer = [&] {
+    auto workers = static_cast<double>(current_workers);
+    return fake_time += 0.001 * (0.2 + 0.8 / workers) * 5;
+  };
+
+  auto scalingResults = std::make_shared<ppc::core::ScalingResults>();
+  ppc::core::Scaling scaling(scalingAttr);
+  scaling.strong_run(scalingResults);
+  const auto flags = std::cout.flags();
+  const auto precision = std::cout.precision();
+  ppc::core::Scaling::print_scaling_statistic(scalingResults);
+  EXPECT_EQ(std::cout.flags(), flags);
+  EXPECT_EQ(std::cout.precision(), precision);
+
+  ASSERT_EQ(scalingResults->curves.size(), 2U);
+  const auto &curve = scalingResults->curves[0];
+  ASSERT_EQ(curve.points.size(), 4U);
+  EXPECT_NEAR(curve.points[0].speedup, 1.0, 1e-9);
+  EXPECT_NEAR(curve.points[3].speedup, 1.0 / (0.2 + 0.8 / 8), 1e-6);
+  EXPECT_NEAR(curve.points[3].efficiency, 1.0 / (0.2 + 0.8 / 8) / 8, 1e-6);
+  EXPECT_NEAR(curve.serial_fraction, 0.2, 1e-6);
+  // efficiency is 0.625 on 4 workers and 0.417 on 8
+  EXPECT_EQ(curve.max_efficient_workers, 4U);
+  EXPECT_EQ(scalingResults->curves[1].points[2].input_size, 200U);
+  EXPECT_EQ(out[0], 200U);
+}
+
+TEST(perf_tests, check_weak_scaling_gustafson_fit) {
+  std::vector<uint32_t> in;
+  std::vector<uint32_t> out(1, 0);
+  uint64_t current_workers = 1;
+
+  auto scalingAttr = std::make_shared<ppc::core::ScalingAttr>();
+  scalingAttr->num_workers = {1, 2, 4, 8};
+  scalingAttr->input_sizes = {100};
+  scalingAttr->make_task = [&](uint64_t num_workers, uint64_t input_size) {
+    current_workers = num_workers;
+    in.assign(input_size, 1);
+    auto taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskData->inputs_count.emplace_back(in.size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+    taskData->outputs_count.emplace_back(out.size());
+    return std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+  };
+
+  // Fake time gives the scaled speedup p - 0.1 * (p - 1)
+  scalingAttr->perf_attr->num_running = 1;
+  double fake_time = 0.0;
+  scalingAttr->perf_attr->current_timer = [&] {
+    auto workers = static_cast<double>(current_workers);
+    return fake_time += 0.001 * workers / (workers - 0.1 * (workers - 1));
+  };
+
+  auto scalingResults = std::make_shared<ppc::core::ScalingResults>();
+  ppc::core::Scaling scaling(scalingAttr);
+  scaling.weak_run(scalingResults);
+
+  ASSERT_EQ(scalingResults->curves.size(), 1U);
+  const auto &curve = scalingResults->curves[0];
+  EXPECT_EQ(curve.points[3].input_size, 800U);
+  EXPECT_NEAR(curve.points[3].speedup, 8 - 0.1 * 7, 1e-6);
+  EXPECT_NEAR(curve.serial_fraction, 0.1, 1e-6);
+  EXPECT_EQ(curve.max_efficient_workers, 8U);
+  EXPECT_EQ(out[0], 800U);
+}
+
+TEST(perf_tests, check_scaling_without_task_factory) {
+  auto scalingAttr = std::make_shared<ppc::core::ScalingAttr>();
+  scalingAttr->num_workers = {1, 2};
+  scalingAttr->input_sizes = {10};
+  EXPECT_ANY_THROW(ppc::core::Scaling scaling(scalingAttr));
+}
+
+TEST(perf_tests, check_perf_pipeline_max_over_ranks) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+
+  // Create Perf attributes, this rank takes 0.5 ms per run and a fake second rank 1.5 ms
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 10;
+  double fake_time = 0.0;
+  perfAttr->current_timer = [&] { return fake_time += 0.0005; };
+  uint64_t num_barriers = 0;
+  perfAttr->synchronize = [&] { num_barriers++; };
+  perfAttr->gather_time = [](double time) { return std::vector<double>{time, 3 * time}; };
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.pipeline_run(perfAttr, perfResults);
+  ppc::core::Perf::print_perf_statistic(perfResults);
+
+  EXPECT_EQ(num_barriers, perfAttr->num_running);
+  EXPECT_NEAR(perfResults->time_sec, 0.015, 1e-9);
+  ASSERT_EQ(perfResults->rank_times.size(), 2U);
+  EXPECT_NEAR(perfResults->rank_times[0], 0.005, 1e-9);
+  EXPECT_NEAR(perfResults->load_imbalance, 50.0, 1e-6);
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_perf_pipeline_allocations) {
+  // Create data
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<uint32_t> out(1, 0);
+
+  // Create TaskData
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+
+  // Create Task
+  auto testTask = std::make_shared<ppc::test::TestTaskWithCopy<uint32_t>>(taskData);
+
+  // Create Perf attributes
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 10;
+  perfAttr->track_allocations = true;
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // Create Perf analyzer
+  ppc::core::Perf perfAnalyzer(testTask);
+  perfAnalyzer.pipeline_run(perfAttr, perfResults);
+  ppc::core::Perf::print_perf_statistic(perfResults);
+
+  const auto &pre_processing = perfResults->phase_memory[static_cast<size_t>(ppc::core::Phase::PRE_PROCESSING)];
+  const auto &run = perfResults->phase_memory[static_cast<size_t>(ppc::core::Phase::RUN)];
+  ASSERT_TRUE(ppc::core::AllocTracker::hooks_installed());
+  // one untimed run is tracked
+  EXPECT_EQ(pre_processing.calls, 1U);
+  EXPECT_EQ(pre_processing.allocations, 1U);
+  EXPECT_GE(pre_processing.allocated_bytes, in.size() * sizeof(uint32_t));
+  EXPECT_GE(pre_processing.peak_bytes, in.size() * sizeof(uint32_t));
+  EXPECT_GT(pre_processing.peak_rss_bytes, 0U);
+  EXPECT_EQ(run.allocations, 0U);
+  EXPECT_EQ(out[0], in.size());
+}
+
+TEST(perf_tests, check_alloc_tracker_aligned_and_nothrow) {
+  ASSERT_TRUE(ppc::core::AllocTracker::hooks_installed());
+  ppc::core::AllocTracker::start();
+  void *aligned = ::operator new(1000, std::align_val_t(64));
+  void *aligned_nothrow = ::operator new[](1000, std::align_val_t(64), std::nothrow);
+  void *nothrow = ::operator new(1000, std::nothrow);
+  const auto live = ppc::core::AllocTracker::stop();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0U);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned_nothrow) % 64, 0U);
+  ppc::core::AllocTracker::start();
+  ::operator delete(aligned, std::align_val_t(64));
+  ::operator delete[](aligned_nothrow, std::align_val_t(64));
+  ::operator delete(nothrow);
+  ppc::core::AllocTracker::stop();
+
+  EXPECT_EQ(live.allocations, 3U);
+  EXPECT_GE(live.allocated_bytes, 3000U);
+  EXPECT_GE(live.peak_bytes, 3000U);
+}
+
+TEST(perf_tests, check_alloc_tracker_counts_mapped_pages) {
+  const size_t bytes = ppc::core::detail::LARGE_BLOCK * 4;
+  ppc::core::AllocTracker::start();
+  void *data = ppc::core::detail::allocate_pages(bytes, ppc::core::MemoryPlacement::DEFAULT);
+  ppc::core::detail::free_pages(data, bytes);
+  const auto memory = ppc::core::AllocTracker::stop();
+
+  EXPECT_GE(memory.allocated_bytes, bytes);
+  EXPECT_GE(memory.peak_bytes, bytes);
+}
+
+TEST(perf_tests, check_alloc_tracker_peak_rss_per_phase) {
+  if (!ppc::core::AllocTracker::reset_peak_rss()) GTEST_SKIP();
+  const size_t bytes = size_t(64) << 20;
+  ppc::core::AllocTracker::start();
+  {
+    std::vector<char> block(bytes, 1);
+    EXPECT_EQ(block[bytes / 2], 1);
+  }
+  const auto large = ppc::core::AllocTracker::stop();
+  ppc::core::AllocTracker::start();
+  const auto small = ppc::core::AllocTracker::stop();
+
+  EXPECT_GE(large.peak_rss_bytes, small.peak_rss_bytes + bytes / 2);
+  EXPECT_GT(small.peak_rss_bytes, 0U);
+}
+
+TEST(perf_tests, check_perf_stream_throughput) {
+  // Create data
+  const size_t count = 20;
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<std::vector<uint32_t>> out(count, std::vector<uint32_t>(1, 0));
+
+  // Create TaskData for every item of the stream
+  std::vector<std::shared_ptr<ppc::core::TaskData>> items;
+  for (size_t i = 0; i < count; i++) {
+    auto taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskData->inputs_count.emplace_back(in.size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out[i].data()));
+    taskData->outputs_count.emplace_back(out[i].size());
+    items.push_back(taskData);
+  }
+
+  // Create executor
+  ppc::core::PipelineExecutor executor([](std::shared_ptr<ppc::core::TaskData> taskData) {
+    return std::make_shared<ppc::test::TestTask<uint32_t>>(taskData);
+  });
+
+  // Create Perf attributes, all runs of the stream take 1 ms of fake time
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 4;
+  double fake_time = 0.0;
+  perfAttr->current_timer = [&] { return fake_time += 0.001; };
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  ppc::core::Perf::stream_run(perfAttr, executor, items, perfResults);
+  ppc::core::Perf::print_perf_statistic(perfResults);
+
+  EXPECT_EQ(perfResults->type_of_running, ppc::core::PerfResults::TypeOfRunning::STREAM);
+  EXPECT_EQ(perfResults->num_items, count);
+  EXPECT_EQ(perfResults->input_size, count * in.size());
+  EXPECT_NEAR(perfResults->throughput, count * 4 / 0.001, 1e-6);
+  for (const auto &item_out : out) {
+    EXPECT_EQ(item_out[0], in.size());
+  }
+}
+
+TEST(perf_tests, check_perf_stream_of_slow_items) {
+  // Create data
+  const size_t count = 2;
+  std::vector<uint32_t> in(2000, 1);
+  std::vector<std::vector<uint32_t>> out(count, std::vector<uint32_t>(1, 0));
+
+  // Create TaskData for every item of the stream
+  std::vector<std::shared_ptr<ppc::core::TaskData>> items;
+  for (size_t i = 0; i < count; i++) {
+    auto taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskData->inputs_count.emplace_back(in.size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out[i].data()));
+    taskData->outputs_count.emplace_back(out[i].size());
+    items.push_back(taskData);
+  }
+
+  // Create executor, the second item waits for the run() of the first one, so it takes
+  // longer than the time limit of a functional test from pre_processing() on
+  ppc::core::PipelineExecutor executor([](std::shared_ptr<ppc::core::TaskData> taskData) {
+    return std::make_shared<ppc::test::TestTaskSlow<uint32_t>>(taskData, std::chrono::milliseconds(600));
+  });
+
+  // Create Perf attributes
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 1;
+
+  // Create and init perf results
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+
+  // the time limit of a functional test would fail here
+  ppc::core::Perf::stream_run(perfAttr, executor, items, perfResults);
+
+  EXPECT_EQ(executor.get_state_of_testing(), ppc::core::TaskData::StateOfTesting::FUNC);
+  for (const auto &item : items) {
+    EXPECT_EQ(item->state_of_testing, ppc::core::TaskData::StateOfTesting::PERF);
+  }
+  for (const auto &item_out : out) {
+    EXPECT_EQ(item_out[0], in.size());
+  }
+}
+
+TEST(perf_tests, check_print_perf_statistic_keeps_format_of_cout) {
+  // every optional line of the report
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+  perfResults->type_of_running = ppc::core::PerfResults::TypeOfRunning::STREAM;
+  perfResults->time_sec = 0.5;
+  perfResults->num_items = 10;
+  perfResults->throughput = 20.0;
+  perfResults->rank_times = {0.25, 0.5};
+  perfResults->load_imbalance = 33.3;
+  for (size_t i = 0; i < ppc::core::PhaseProfile::PHASES.size(); i++) {
+    perfResults->phase_profile.phases[i].time_sec = 0.125;
+    perfResults->phase_counters[i].calls = 1;
+    perfResults->phase_counters[i].time_sec = 0.125;
+  }
+
+  const auto flags = std::cout.flags();
+  const auto precision = std::cout.precision();
+  ppc::core::Perf::print_perf_statistic(perfResults);
+
+  EXPECT_EQ(std::cout.flags(), flags);
+  EXPECT_EQ(std::cout.precision(), precision);
+}
+
+TEST(perf_tests, check_print_perf_statistic_names_counted_threads) {
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+  perfResults->type_of_running = ppc::core::PerfResults::TypeOfRunning::TASK_RUN;
+  perfResults->time_sec = 0.5;
+  auto &run = perfResults->phase_counters[static_cast<size_t>(ppc::core::Phase::RUN)];
+  run.calls = 1;
+  run.has_counters = true;
+  run.cycles = 200;
+  run.instructions = 100;
+
+  testing::internal::CaptureStdout();
+  ppc::core::Perf::print_perf_statistic(perfResults);
+  auto output = testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("ipc=0.500 (calling thread and threads exited in the phase, not pool workers)\n"),
+            std::string::npos);
+}
+
+TEST(perf_tests, check_print_perf_statistic_of_variant) {
+  // a variant gets a task id of its own in every report
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+  perfResults->type_of_running = ppc::core::PerfResults::TypeOfRunning::TASK_RUN;
+  perfResults->time_sec = 0.5;
+  perfResults->variant = "cached_input";
+
+  testing::internal::CaptureStdout();
+  ppc::core::Perf::print_perf_statistic(perfResults);
+  auto output = testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("_cached_input:task_run:0.5000000000\n"), std::string::npos);
+}
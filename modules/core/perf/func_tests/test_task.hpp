@@ -5,7 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #include "core/task/include/task.hpp"
@@ -47,6 +49,58 @@ class TestTask : public ppc::core::Task {
   T *output_{};
 };
 
+// Same as TestTask, but copies the input in pre_processing() like most of the tasks
+template <class T>
+class TestTaskWithCopy : public ppc::core::Task {
+ public:
+  explicit TestTaskWithCopy(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
+  bool pre_processing() override {
+    internal_order_test();
+    auto *tmp_ptr = reinterpret_cast<T *>(taskData->inputs[0]);
+    input_ = std::vector<T>(tmp_ptr, tmp_ptr + taskData->inputs_count[0]);
+    return true;
+  }
+
+  bool validation() override {
+    internal_order_test();
+    return taskData->outputs_count[0] == 1;
+  }
+
+  bool run() override {
+    internal_order_test();
+    res = 0;
+    for (const auto &value : input_) {
+      res += value;
+    }
+    return true;
+  }
+
+  bool post_processing() override {
+    internal_order_test();
+    reinterpret_cast<T *>(taskData->outputs[0])[0] = res;
+    return true;
+  }
+
+ private:
+  std::vector<T> input_;
+  T res{};
+};
+
+// Same as TestTask, but run() takes at least run_time
+template <class T>
+class TestTaskSlow : public TestTask<T> {
+ public:
+  TestTaskSlow(std::shared_ptr<ppc::core::TaskData> taskData_, std::chrono::milliseconds run_time_)
+      : TestTask<T>(taskData_), run_time(run_time_) {}
+  bool run() override {
+    std::this_thread::sleep_for(run_time);
+    return TestTask<T>::run();
+  }
+
+ private:
+  std::chrono::milliseconds run_time;
+};
+
 }  // namespace ppc::test
 
 #endif  // MODULES_CORE_TESTS_TEST_TASK_HPP_
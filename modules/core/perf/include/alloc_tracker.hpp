@@ -0,0 +1,52 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_ALLOC_TRACKER_HPP_
+#define MODULES_CORE_INCLUDE_ALLOC_TRACKER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ppc {
+namespace core {
+
+// Heap usage of one task phase, summed over all calls. Allocations are counted only
+// in binaries linked with perf/alloc_hooks/alloc_hooks.cpp (has_allocations is true).
+// peak_rss_bytes is the peak resident set of the process during the phase where the
+// mark can be reset (Linux), elsewhere the growth of the process mark during the phase
+struct PhaseMemory {
+  uint64_t calls = 0;
+  bool has_allocations = false;
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+  // the largest growth of live heap bytes over the start of a call
+  uint64_t peak_bytes = 0;
+  uint64_t peak_rss_bytes = 0;
+
+  PhaseMemory& operator+=(const PhaseMemory& other);
+};
+
+// Counters of operator new/delete, off unless started. Thread-safe, every thread of
+// the process is counted.
+class AllocTracker {
+ public:
+  // called by the replaced operators
+  static void on_allocation(size_t size);
+  static void on_deallocation(size_t size);
+  static void set_hooks_installed();
+  static bool hooks_installed();
+
+  // reset the counters and start counting
+  static void start();
+  // stop counting, returns the counters since start()
+  static PhaseMemory stop();
+
+  // peak resident set size of the process in bytes since the last reset, 0 if it is unknown
+  static uint64_t peak_rss_bytes();
+  // lower the mark to the current resident set, false if the OS does not allow it
+  static bool reset_peak_rss();
+};
+
+}  // namespace core
+}  // namespace ppc
+
+#endif  // MODULES_CORE_INCLUDE_ALLOC_TRACKER_HPP_
@@ -3,11 +3,17 @@
 #ifndef MODULES_CORE_INCLUDE_PERF_HPP_
 #define MODULES_CORE_INCLUDE_PERF_HPP_
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "core/perf/include/alloc_tracker.hpp"
+#include "core/perf/include/perf_counters.hpp"
+#include "core/perf/include/statistics.hpp"
+#include "core/task/include/pipeline_executor.hpp"
 #include "core/task/include/task.hpp"
 
 namespace ppc {
@@ -17,12 +23,59 @@ struct PerfAttr {
   // count of task's running
   uint64_t num_running;
   std::function<double(void)> current_timer = [&] { return 0.0; };
+  // TOTAL times the whole loop of num_running runs, STATISTICAL times every run on its own.
+  // PPC_PERF_STATISTICAL=<num_warmup> makes every measurement STATISTICAL with at least
+  // that many warmup runs (scripts/generate_perf_results sets it for the baseline test)
+  enum TypeOfMeasurement { TOTAL, STATISTICAL } type_of_measurement = TOTAL;
+  // count of untimed runs before measurement (STATISTICAL only)
+  uint64_t num_warmup = 0;
+  // keep running past num_running until the 95% confidence interval of the mean
+  // is narrower than this fraction of the mean, or MAX_TIME is spent (STATISTICAL only)
+  double target_relative_error = 0.0;
+  // factor of the Tukey fences used to reject outliers, 0 keeps every run (STATISTICAL only)
+  double outlier_iqr_factor = 1.5;
+  // measure every phase with hardware counters (or wall time only if they are not available);
+  // threads of a pool are not counted, see perf_counters.hpp
+  bool use_hardware_counters = false;
+  // measure heap allocations and peak RSS of every phase (see alloc_tracker.hpp) on one
+  // call of it that is not timed
+  bool track_allocations = false;
+  // MPI timing policy (see perf_mpi.hpp): synchronize is called before every timed run
+  // (a barrier), gather_time returns the times of the run on all ranks in rank order.
+  // With gather_time the time of a run is the time of the slowest rank
+  std::function<void(void)> synchronize;
+  std::function<std::vector<double>(double)> gather_time;
 };
 
 struct PerfResults {
-  // measurement of task's time (in seconds)
+  // measurement of task's time (in seconds), in STATISTICAL mode it is the
+  // mean time of one run multiplied by num_running
   double time_sec = 0.0;
-  enum TypeOfRunning { PIPELINE, TASK_RUN, NONE } type_of_running = NONE;
+  enum TypeOfRunning { PIPELINE, TASK_RUN, STREAM, NONE } type_of_running = NONE;
+  // count of task's running and total count of input elements, for reports
+  uint64_t num_running = 0;
+  uint64_t input_size = 0;
+  // time of every timed run in order (STATISTICAL only)
+  std::vector<double> samples;
+  // summary of samples after outlier rejection (STATISTICAL only)
+  SampleStatistics statistics;
+  // counters of every phase indexed by Phase, summed over all runs (use_hardware_counters only)
+  std::array<PhaseCounters, 4> phase_counters;
+  // memory of every phase indexed by Phase on its untimed call (track_allocations only)
+  std::array<PhaseMemory, 4> phase_memory;
+  // entry/exit timestamps and time of every phase, summed over all runs
+  PhaseProfile phase_profile;
+  // timed time of every rank summed over all runs, and (max / mean - 1) of them
+  // in percent (gather_time only)
+  std::vector<double> rank_times;
+  double load_imbalance = 0.0;
+  // count of items in the stream and items processed per second (STREAM only)
+  uint64_t num_items = 0;
+  double throughput = 0.0;
+  // set by the test: appended to the task id of the report ("example" becomes
+  // "example_<variant>"), so that a perf test which measures something other than the
+  // task's own runs keeps its records apart from them; letters, digits and '_' only
+  std::string variant;
   constexpr const static double MAX_TIME = 10.0;
 };
 
@@ -39,13 +92,26 @@ class Perf {
                     const std::shared_ptr<ppc::core::PerfResults>& perfResults);
   // Check performance of task's run() function
   void task_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::shared_ptr<ppc::core::PerfResults>& perfResults);
-  // Pint results for automation checkers
+  // Check throughput of a stream of task instances processed by the executor,
+  // every one of num_running runs processes all items
+  static void stream_run(const std::shared_ptr<PerfAttr>& perfAttr, PipelineExecutor& executor,
+                         const std::vector<std::shared_ptr<TaskData>>& items,
+                         const std::shared_ptr<ppc::core::PerfResults>& perfResults);
+  // Pint results for automation checkers, and append them to the machine-readable
+  // output if it is enabled (see perf_output_path())
   static void print_perf_statistic(const std::shared_ptr<PerfResults>& perfResults);
 
  private:
   std::shared_ptr<Task> task;
+  void init_results(const std::shared_ptr<PerfAttr>& perfAttr,
+                    const std::shared_ptr<ppc::core::PerfResults>& perfResults) const;
+  void run_phase(PerfCounterGroup* counters, bool track_allocations, PerfResults& perfResults, Phase phase);
+  static double timed_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::function<void()>& pipeline,
+                          const std::shared_ptr<ppc::core::PerfResults>& perfResults);
   static void common_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::function<void()>& pipeline,
                          const std::shared_ptr<ppc::core::PerfResults>& perfResults);
+  static void statistical_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::function<void()>& pipeline,
+                              const std::shared_ptr<ppc::core::PerfResults>& perfResults);
 };
 
 }  // namespace core
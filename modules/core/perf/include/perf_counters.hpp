@@ -0,0 +1,60 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_PERF_COUNTERS_HPP_
+#define MODULES_CORE_INCLUDE_PERF_COUNTERS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace ppc {
+namespace core {
+
+// Accumulated hardware counters of one task phase; wall time is always measured,
+// the counters only if has_counters is true
+struct PhaseCounters {
+  uint64_t calls = 0;
+  double time_sec = 0.0;
+  bool has_counters = false;
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cache_misses = 0;
+  uint64_t branch_misses = 0;
+
+  // instructions per cycle, 0 when counters are not available
+  [[nodiscard]] double ipc() const;
+  PhaseCounters& operator+=(const PhaseCounters& other);
+};
+
+// Group of perf_event_open counters (cycles, instructions, cache misses, branch
+// misses) of the thread that creates it and of the threads it starts afterwards. The
+// counts of a started thread are added to the group only when the thread exits, so
+// std::thread workers joined within a phase are counted, but threads still running at
+// stop() are not, nor the workers of a pool (OpenMP, TBB, ThreadPool::shared(), whose
+// threads never exit): for tasks on such pools the counters cover the calling thread
+// only. On other systems or when the kernel refuses to open any of the events (e.g.
+// perf_event_paranoid, containers) only wall time is measured.
+class PerfCounterGroup {
+ public:
+  PerfCounterGroup();
+  PerfCounterGroup(const PerfCounterGroup&) = delete;
+  PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+  ~PerfCounterGroup();
+
+  // all counters are open, or none of them
+  [[nodiscard]] bool available() const { return fds[CYCLES] >= 0; }
+
+  void start();
+  // counters since the last start()
+  PhaseCounters stop();
+
+ private:
+  enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, NUM_EVENTS };
+  std::array<int, NUM_EVENTS> fds{-1, -1, -1, -1};
+  std::chrono::steady_clock::time_point start_time;
+};
+
+}  // namespace core
+}  // namespace ppc
+
+#endif  // MODULES_CORE_INCLUDE_PERF_COUNTERS_HPP_
@@ -0,0 +1,36 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_PERF_MPI_HPP_
+#define MODULES_CORE_INCLUDE_PERF_MPI_HPP_
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/timer.hpp>
+#include <memory>
+#include <vector>
+
+#include "core/perf/include/perf.hpp"
+
+namespace ppc {
+namespace core {
+
+// Time every run of the task as a job of all ranks of comm: the ranks start every run
+// after a barrier and the time of the run is the time of the slowest rank. Must be
+// called on every rank, and print_perf_statistic() gives the same results on all of them.
+// Header-only, so the core library does not depend on MPI.
+inline void set_mpi_timing(const std::shared_ptr<PerfAttr>& perfAttr,
+                           const boost::mpi::communicator& comm = boost::mpi::communicator()) {
+  const boost::mpi::timer timer;
+  perfAttr->current_timer = [timer] { return timer.elapsed(); };
+  perfAttr->synchronize = [comm] { comm.barrier(); };
+  perfAttr->gather_time = [comm](double time) {
+    std::vector<double> times;
+    boost::mpi::all_gather(comm, time, times);
+    return times;
+  };
+}
+
+}  // namespace core
+}  // namespace ppc
+
+#endif  // MODULES_CORE_INCLUDE_PERF_MPI_HPP_
@@ -0,0 +1,84 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_PERF_REPORT_HPP_
+#define MODULES_CORE_INCLUDE_PERF_REPORT_HPP_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/perf/include/alloc_tracker.hpp"
+#include "core/perf/include/perf_counters.hpp"
+#include "core/perf/include/statistics.hpp"
+#include "core/task/include/task.hpp"
+
+namespace ppc {
+namespace core {
+
+struct HardwareInfo {
+  std::string cpu_model = "unknown";
+  uint64_t logical_cores = 0;
+  std::string hostname = "unknown";
+  uint64_t numa_nodes = 1;
+};
+
+// One line of the machine-readable perf output
+struct PerfRecord {
+  // e.g. "example" for tasks/mpi/example
+  std::string task_id;
+  // mpi, omp, seq, stl or tbb
+  std::string backend;
+  // pipeline, task_run, stream or none
+  std::string type_of_running;
+  uint64_t num_processes = 1;
+  uint64_t num_threads = 1;
+  uint64_t input_size = 0;
+  uint64_t num_running = 0;
+  double time_sec = 0.0;
+  // per-iteration times, empty unless the run was STATISTICAL
+  std::vector<double> samples;
+  SampleStatistics statistics;
+  // per-rank times and load imbalance in percent, empty and 0 unless timed over MPI ranks
+  std::vector<double> rank_times;
+  double load_imbalance = 0.0;
+  // items per second, 0 unless type_of_running is stream
+  double throughput = 0.0;
+  // validation, pre_processing, run and post_processing, written only if measured
+  std::array<PhaseCounters, 4> phase_counters;
+  std::array<PhaseMemory, 4> phase_memory;
+  PhaseProfile phase_profile;
+  HardwareInfo hardware;
+  // NumaConfig of the run
+  std::string memory_placement = "default";
+  std::string thread_pinning = "none";
+  // seconds since epoch
+  int64_t timestamp = 0;
+};
+
+// Value of the environment variable or empty string
+std::string get_env_variable(const std::string& name);
+
+HardwareInfo current_hardware_info();
+
+// MPI launchers export the size of the job, plain runs are single-process
+uint64_t current_num_processes();
+
+// PPC_NUM_THREADS, then OMP_NUM_THREADS, then the number of logical cores
+uint64_t current_num_threads();
+
+// Path from --perf_output=<path> in the test's command line, else from PPC_PERF_OUTPUT,
+// empty when machine-readable output is disabled
+std::string perf_output_path();
+
+std::string to_json(const PerfRecord& record);
+std::string csv_header();
+std::string to_csv(const PerfRecord& record);
+
+// Append the record as a JSON line, or as a CSV row if path ends with ".csv"
+void write_perf_record(const std::string& path, const PerfRecord& record);
+
+}  // namespace core
+}  // namespace ppc
+
+#endif  // MODULES_CORE_INCLUDE_PERF_REPORT_HPP_
@@ -0,0 +1,83 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_SCALING_HPP_
+#define MODULES_CORE_INCLUDE_SCALING_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/perf/include/perf.hpp"
+#include "core/task/include/task.hpp"
+
+namespace ppc {
+namespace core {
+
+struct ScalingAttr {
+  // counts of threads (OMP/TBB/STL) or of MPI processes to sweep, ascending
+  std::vector<uint64_t> num_workers;
+  // input sizes of strong scaling, per-worker input sizes of weak scaling
+  std::vector<uint64_t> input_sizes;
+  // Create the task with its data for the given point of the sweep. It is also the
+  // place to set the count of workers: omp_set_num_threads(), tbb::global_control,
+  // a communicator of num_workers ranks made with split() for MPI, etc.
+  std::function<std::shared_ptr<Task>(uint64_t num_workers, uint64_t input_size)> make_task;
+  // attributes of every single measurement
+  std::shared_ptr<PerfAttr> perf_attr = std::make_shared<PerfAttr>();
+  PerfResults::TypeOfRunning type_of_running = PerfResults::TypeOfRunning::PIPELINE;
+  // the task is considered scaling while parallel efficiency is not lower than this
+  double efficiency_threshold = 0.5;
+};
+
+struct ScalingPoint {
+  uint64_t num_workers = 0;
+  uint64_t input_size = 0;
+  // time of one run (in seconds)
+  double time_sec = 0.0;
+  double speedup = 0.0;
+  double efficiency = 0.0;
+};
+
+struct ScalingCurve {
+  // input size for strong scaling, per-worker input size for weak scaling
+  uint64_t input_size = 0;
+  std::vector<ScalingPoint> points;
+  // serial fraction from the Amdahl (strong) or Gustafson (weak) fit
+  double serial_fraction = 0.0;
+  // the largest count of workers with efficiency above the threshold
+  uint64_t max_efficient_workers = 0;
+};
+
+struct ScalingResults {
+  enum TypeOfScaling { STRONG, WEAK, NONE } type_of_scaling = NONE;
+  std::vector<ScalingCurve> curves;
+};
+
+// Least squares fit of S(p) = 1 / (s + (1 - s) / p), returns s
+double fit_amdahl(const std::vector<ScalingPoint>& points);
+// Least squares fit of S(p) = p - s * (p - 1), returns s
+double fit_gustafson(const std::vector<ScalingPoint>& points);
+
+class Scaling {
+ public:
+  explicit Scaling(std::shared_ptr<ScalingAttr> scalingAttr_);
+  // Fixed input size, growing count of workers; speedup is relative to the first
+  // count of workers, which is assumed to scale linearly
+  void strong_run(const std::shared_ptr<ScalingResults>& scalingResults);
+  // Input size growing together with the count of workers; speedup is the scaled
+  // speedup p * T(1, n) / T(p, p * n)
+  void weak_run(const std::shared_ptr<ScalingResults>& scalingResults);
+  // Print curves and fits, one line per point
+  static void print_scaling_statistic(const std::shared_ptr<ScalingResults>& scalingResults);
+
+ private:
+  std::shared_ptr<ScalingAttr> scalingAttr;
+  double measure(uint64_t num_workers, uint64_t input_size);
+  void finish_curve(ScalingCurve& curve, ScalingResults::TypeOfScaling type) const;
+};
+
+}  // namespace core
+}  // namespace ppc
+
+#endif  // MODULES_CORE_INCLUDE_SCALING_HPP_
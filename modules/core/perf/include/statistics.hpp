@@ -0,0 +1,48 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_STATISTICS_HPP_
+#define MODULES_CORE_INCLUDE_STATISTICS_HPP_
+
+#include <cstdint>
+#include <vector>
+
+namespace ppc {
+namespace core {
+
+// Summary of a set of per-iteration measurements (in seconds)
+struct SampleStatistics {
+  uint64_t num_samples = 0;
+  // samples dropped by the Tukey fences before the summary was computed
+  uint64_t num_outliers = 0;
+  double min = 0.0;
+  double max = 0.0;
+  double mean = 0.0;
+  double median = 0.0;
+  double p90 = 0.0;
+  double p99 = 0.0;
+  double stddev = 0.0;
+  // 95% confidence interval of the mean
+  double ci_low = 0.0;
+  double ci_high = 0.0;
+  // half-width of the confidence interval divided by the mean
+  double relative_error = 0.0;
+};
+
+// Linear interpolation between closest ranks, q in [0, 1]; sorted_samples must be sorted
+double percentile(const std::vector<double>& sorted_samples, double q);
+
+// Two-sided 95% quantile of Student's t-distribution
+double student_t_95(uint64_t degrees_of_freedom);
+
+// Half-width of the 95% confidence interval of the mean divided by the mean
+double relative_error(uint64_t num_samples, double mean, double stddev);
+
+// Drop samples outside [Q1 - k * IQR, Q3 + k * IQR]; k <= 0 keeps every sample
+std::vector<double> reject_outliers(const std::vector<double>& samples, double iqr_factor);
+
+SampleStatistics compute_statistics(const std::vector<double>& samples, double iqr_factor = 1.5);
+
+}  // namespace core
+}  // namespace ppc
+
+#endif  // MODULES_CORE_INCLUDE_STATISTICS_HPP_
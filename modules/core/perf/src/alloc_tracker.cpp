@@ -0,0 +1,120 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/perf/include/alloc_tracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <string>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "core/numa/include/numa.hpp"
+
+namespace {
+
+std::atomic<bool> hooks{false};
+std::atomic<bool> enabled{false};
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocated_bytes{0};
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_bytes{0};
+// the mark at start() when it could not be reset
+std::atomic<uint64_t> rss_at_start{0};
+
+// the pages of NumaAllocator, mapped past operator new
+void on_mapping(int64_t bytes) {
+  if (bytes >= 0) {
+    ppc::core::AllocTracker::on_allocation(static_cast<size_t>(bytes));
+  } else {
+    ppc::core::AllocTracker::on_deallocation(static_cast<size_t>(-bytes));
+  }
+}
+
+}  // namespace
+
+ppc::core::PhaseMemory& ppc::core::PhaseMemory::operator+=(const PhaseMemory& other) {
+  calls += other.calls;
+  has_allocations = has_allocations || other.has_allocations;
+  allocations += other.allocations;
+  allocated_bytes += other.allocated_bytes;
+  peak_bytes = std::max(peak_bytes, other.peak_bytes);
+  peak_rss_bytes = std::max(peak_rss_bytes, other.peak_rss_bytes);
+  return *this;
+}
+
+void ppc::core::AllocTracker::on_allocation(size_t size) {
+  if (!enabled.load(std::memory_order_relaxed)) return;
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  auto live = live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed) + static_cast<int64_t>(size);
+  auto peak = peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void ppc::core::AllocTracker::on_deallocation(size_t size) {
+  if (!enabled.load(std::memory_order_relaxed)) return;
+  live_bytes.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+}
+
+void ppc::core::AllocTracker::set_hooks_installed() { hooks = true; }
+
+bool ppc::core::AllocTracker::hooks_installed() { return hooks; }
+
+void ppc::core::AllocTracker::start() {
+  allocations = 0;
+  allocated_bytes = 0;
+  live_bytes = 0;
+  peak_bytes = 0;
+  detail::set_mapping_hook(on_mapping);
+  rss_at_start = reset_peak_rss() ? 0 : peak_rss_bytes();
+  enabled = true;
+}
+
+ppc::core::PhaseMemory ppc::core::AllocTracker::stop() {
+  enabled = false;
+  PhaseMemory memory;
+  memory.calls = 1;
+  memory.has_allocations = hooks_installed();
+  memory.allocations = allocations;
+  memory.allocated_bytes = allocated_bytes;
+  memory.peak_bytes = static_cast<uint64_t>(peak_bytes.load());
+  const auto rss = peak_rss_bytes();
+  memory.peak_rss_bytes = rss - std::min(rss, rss_at_start.load());
+  return memory;
+}
+
+uint64_t ppc::core::AllocTracker::peak_rss_bytes() {
+#ifdef __linux__
+  // unlike ru_maxrss, VmHWM follows reset_peak_rss()
+  std::ifstream status("/proc/self/status");
+  for (std::string line; std::getline(status, line);) {
+    if (line.rfind("VmHWM:", 0) == 0) return std::stoull(line.substr(6)) * 1024;
+  }
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // kilobytes on Linux
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+bool ppc::core::AllocTracker::reset_peak_rss() {
+#ifdef __linux__
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.flush();
+  return static_cast<bool>(clear_refs);
+#else
+  return false;
+#endif
+}
@@ -3,10 +3,59 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <numeric>
 #include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
+
+#include "core/numa/include/numa.hpp"
+#include "core/perf/include/perf_report.hpp"
+
+namespace {
+
+// Cut ".../tasks/<backend>/<task_id>/perf_tests/main.cpp" down to "tasks/<backend>/<task_id>"
+std::string task_path(std::string file) {
+  std::replace(file.begin(), file.end(), '\\', '/');
+  for (const auto* root : {"/tasks/", "/modules/"}) {
+    auto root_position = file.rfind(root);
+    if (root_position != std::string::npos) {
+      file.erase(0, root_position + 1);
+      break;
+    }
+  }
+  for (const auto* tests_dir : {"/perf_tests", "/func_tests"}) {
+    auto tests_position = file.find(tests_dir);
+    if (tests_position != std::string::npos) {
+      file.erase(tests_position);
+      break;
+    }
+  }
+  return file;
+}
+
+// the confidence interval of fewer samples is not worth testing against the target
+constexpr uint64_t MIN_SAMPLES_FOR_ERROR = 3;
+
+// PPC_PERF_STATISTICAL=<warmup runs> times every run of every perf test on its own, after
+// at least that many warmup runs, so that the records carry samples for the baseline test
+std::shared_ptr<ppc::core::PerfAttr> measurement_attr(const std::shared_ptr<ppc::core::PerfAttr>& perfAttr) {
+  auto warmup = ppc::core::get_env_variable("PPC_PERF_STATISTICAL");
+  if (warmup.empty()) return perfAttr;
+  auto attr = std::make_shared<ppc::core::PerfAttr>(*perfAttr);
+  attr->type_of_measurement = ppc::core::PerfAttr::TypeOfMeasurement::STATISTICAL;
+  attr->num_warmup = std::max<uint64_t>(attr->num_warmup, std::strtoull(warmup.c_str(), nullptr, 10));
+  return attr;
+}
+
+}  // namespace
 
 ppc::core::Perf::Perf(std::shared_ptr<Task> task_) { set_task(std::move(task_)); }
 
@@ -18,47 +67,214 @@ void ppc::core::Perf::set_task(std::shared_ptr<Task> task_) {
 void ppc::core::Perf::pipeline_run(const std::shared_ptr<PerfAttr>& perfAttr,
                                    const std::shared_ptr<ppc::core::PerfResults>& perfResults) {
   perfResults->type_of_running = PerfResults::TypeOfRunning::PIPELINE;
+  init_results(perfAttr, perfResults);
 
+  auto counters = perfAttr->use_hardware_counters ? std::make_unique<PerfCounterGroup>() : nullptr;
+  auto& results = *perfResults;
   common_run(
       std::move(perfAttr),
       [&]() {
-        task->validation();
-        task->pre_processing();
-        task->run();
-        task->post_processing();
+        run_phase(counters.get(), false, results, Phase::VALIDATION);
+        run_phase(counters.get(), false, results, Phase::PRE_PROCESSING);
+        run_phase(counters.get(), false, results, Phase::RUN);
+        run_phase(counters.get(), false, results, Phase::POST_PROCESSING);
       },
       std::move(perfResults));
+  perfResults->phase_profile = task->get_phase_profile();
+
+  // the allocation hooks take time of their own, so they count one more, untimed run
+  if (perfAttr->track_allocations) {
+    run_phase(nullptr, true, results, Phase::VALIDATION);
+    run_phase(nullptr, true, results, Phase::PRE_PROCESSING);
+    run_phase(nullptr, true, results, Phase::RUN);
+    run_phase(nullptr, true, results, Phase::POST_PROCESSING);
+  }
 }
 
 void ppc::core::Perf::task_run(const std::shared_ptr<PerfAttr>& perfAttr,
                                const std::shared_ptr<ppc::core::PerfResults>& perfResults) {
   perfResults->type_of_running = PerfResults::TypeOfRunning::TASK_RUN;
+  init_results(perfAttr, perfResults);
 
-  task->validation();
-  task->pre_processing();
-  common_run(std::move(perfAttr), [&]() { task->run(); }, std::move(perfResults));
-  task->post_processing();
+  auto counters = perfAttr->use_hardware_counters ? std::make_unique<PerfCounterGroup>() : nullptr;
+  auto track = perfAttr->track_allocations;
+  auto& results = *perfResults;
+  run_phase(counters.get(), track, results, Phase::VALIDATION);
+  run_phase(counters.get(), track, results, Phase::PRE_PROCESSING);
+  common_run(
+      std::move(perfAttr), [&]() { run_phase(counters.get(), false, results, Phase::RUN); }, std::move(perfResults));
+  run_phase(counters.get(), track, results, Phase::POST_PROCESSING);
+  perfResults->phase_profile = task->get_phase_profile();
 
   task->validation();
   task->pre_processing();
-  task->run();
+  // the allocation hooks take time of their own, so run() is counted on this untimed call
+  if (track) {
+    run_phase(nullptr, true, results, Phase::RUN);
+  } else {
+    task->run();
+  }
   task->post_processing();
 }
 
+void ppc::core::Perf::stream_run(const std::shared_ptr<PerfAttr>& perfAttr, PipelineExecutor& executor,
+                                 const std::vector<std::shared_ptr<TaskData>>& items,
+                                 const std::shared_ptr<ppc::core::PerfResults>& perfResults) {
+  perfResults->type_of_running = PerfResults::TypeOfRunning::STREAM;
+  perfResults->num_running = perfAttr->num_running;
+  perfResults->num_items = items.size();
+  perfResults->phase_counters = {};
+  perfResults->phase_memory = {};
+  perfResults->phase_profile = {};
+  perfResults->rank_times.clear();
+  perfResults->load_imbalance = 0.0;
+  perfResults->input_size = 0;
+  for (const auto& item : items) {
+    for (auto count : item->inputs_count) {
+      perfResults->input_size += count;
+    }
+  }
+
+  // the executor creates the tasks, and their constructors reset the items to FUNC
+  auto state_of_testing = executor.get_state_of_testing();
+  executor.set_state_of_testing(TaskData::StateOfTesting::PERF);
+  uint64_t num_failed = 0;
+  common_run(
+      perfAttr,
+      [&]() {
+        for (auto ok : executor.run(items)) {
+          if (!ok) num_failed++;
+        }
+      },
+      perfResults);
+  executor.set_state_of_testing(state_of_testing);
+  if (num_failed > 0) std::cerr << "Stream: " << num_failed << " items failed" << std::endl;
+
+  auto runs = static_cast<double>(std::max<uint64_t>(perfAttr->num_running, 1));
+  perfResults->throughput =
+      perfResults->time_sec > 0.0 ? static_cast<double>(items.size()) * runs / perfResults->time_sec : 0.0;
+}
+
+void ppc::core::Perf::run_phase(PerfCounterGroup* counters, bool track_allocations, PerfResults& perfResults,
+                                Phase phase) {
+  if (track_allocations) AllocTracker::start();
+  if (counters != nullptr) counters->start();
+  switch (phase) {
+    case Phase::VALIDATION:
+      task->validation();
+      break;
+    case Phase::PRE_PROCESSING:
+      task->pre_processing();
+      break;
+    case Phase::RUN:
+      task->run();
+      break;
+    case Phase::POST_PROCESSING:
+      task->post_processing();
+      break;
+    default:
+      break;
+  }
+  task->end_phase();
+  if (counters != nullptr) perfResults.phase_counters[static_cast<size_t>(phase)] += counters->stop();
+  if (track_allocations) perfResults.phase_memory[static_cast<size_t>(phase)] += AllocTracker::stop();
+}
+
+void ppc::core::Perf::init_results(const std::shared_ptr<PerfAttr>& perfAttr,
+                                   const std::shared_ptr<ppc::core::PerfResults>& perfResults) const {
+  perfResults->num_running = perfAttr->num_running;
+  perfResults->phase_counters = {};
+  perfResults->phase_memory = {};
+  perfResults->rank_times.clear();
+  perfResults->load_imbalance = 0.0;
+  task->reset_phase_profile();
+  perfResults->input_size = 0;
+  for (auto count : task->get_data()->inputs_count) {
+    perfResults->input_size += count;
+  }
+}
+
 void ppc::core::Perf::common_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::function<void()>& pipeline,
                                  const std::shared_ptr<ppc::core::PerfResults>& perfResults) {
+  const auto attr = measurement_attr(perfAttr);
+  if (attr->type_of_measurement == PerfAttr::TypeOfMeasurement::STATISTICAL) {
+    statistical_run(attr, pipeline, perfResults);
+  } else if (attr->synchronize || attr->gather_time) {
+    perfResults->time_sec = 0.0;
+    for (uint64_t i = 0; i < attr->num_running; i++) {
+      perfResults->time_sec += timed_run(attr, pipeline, perfResults);
+    }
+  } else {
+    auto begin = attr->current_timer();
+    for (uint64_t i = 0; i < attr->num_running; i++) {
+      pipeline();
+    }
+    auto end = attr->current_timer();
+    perfResults->time_sec = end - begin;
+  }
+
+  const auto& rank_times = perfResults->rank_times;
+  if (!rank_times.empty()) {
+    auto mean = std::accumulate(rank_times.begin(), rank_times.end(), 0.0) / static_cast<double>(rank_times.size());
+    auto max = *std::max_element(rank_times.begin(), rank_times.end());
+    perfResults->load_imbalance = mean > 0.0 ? 100.0 * (max / mean - 1.0) : 0.0;
+  }
+}
+
+double ppc::core::Perf::timed_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::function<void()>& pipeline,
+                                  const std::shared_ptr<ppc::core::PerfResults>& perfResults) {
+  if (perfAttr->synchronize) perfAttr->synchronize();
   auto begin = perfAttr->current_timer();
-  for (uint64_t i = 0; i < perfAttr->num_running; i++) {
+  pipeline();
+  auto end = perfAttr->current_timer();
+  if (!perfAttr->gather_time) return end - begin;
+
+  // all ranks started together, so the job took as long as its slowest rank
+  auto times = perfAttr->gather_time(end - begin);
+  auto& rank_times = perfResults->rank_times;
+  rank_times.resize(std::max(rank_times.size(), times.size()), 0.0);
+  for (size_t rank = 0; rank < times.size(); rank++) {
+    rank_times[rank] += times[rank];
+  }
+  return times.empty() ? end - begin : *std::max_element(times.begin(), times.end());
+}
+
+void ppc::core::Perf::statistical_run(const std::shared_ptr<PerfAttr>& perfAttr, const std::function<void()>& pipeline,
+                                      const std::shared_ptr<ppc::core::PerfResults>& perfResults) {
+  for (uint64_t i = 0; i < perfAttr->num_warmup; i++) {
     pipeline();
   }
-  auto end = perfAttr->current_timer();
-  perfResults->time_sec = end - begin;
+
+  auto& samples = perfResults->samples;
+  samples.clear();
+  samples.reserve(perfAttr->num_running);
+
+  // Welford's online mean and variance, used only to decide when to stop
+  double mean = 0.0;
+  double m2 = 0.0;
+  double spent = 0.0;
+  while (true) {
+    auto sample = timed_run(perfAttr, pipeline, perfResults);
+    samples.push_back(sample);
+    spent += sample;
+    auto delta = sample - mean;
+    mean += delta / static_cast<double>(samples.size());
+    m2 += delta * (sample - mean);
+
+    if (samples.size() < std::max<uint64_t>(perfAttr->num_running, 1)) continue;
+    if (perfAttr->target_relative_error <= 0.0 || spent >= PerfResults::MAX_TIME) break;
+    if (samples.size() < MIN_SAMPLES_FOR_ERROR) continue;
+    auto stddev = std::sqrt(m2 / static_cast<double>(samples.size() - 1));
+    if (relative_error(samples.size(), mean, stddev) <= perfAttr->target_relative_error) break;
+  }
+
+  perfResults->statistics = compute_statistics(samples, perfAttr->outlier_iqr_factor);
+  perfResults->time_sec = perfResults->statistics.mean * static_cast<double>(perfAttr->num_running);
 }
 
 void ppc::core::Perf::print_perf_statistic(const std::shared_ptr<PerfResults>& perfResults) {
-  std::string relative_path(::testing::UnitTest::GetInstance()->current_test_info()->file());
-  std::string ppc_regex_template("parallel_programming_course");
-  std::string perf_regex_template("perf_tests");
+  std::string relative_path = task_path(::testing::UnitTest::GetInstance()->current_test_info()->file());
+  if (!perfResults->variant.empty()) relative_path += "_" + perfResults->variant;
   std::string type_test_name;
 
   auto time_secs = perfResults->time_sec;
@@ -67,16 +283,12 @@ void ppc::core::Perf::print_perf_statistic(const std::shared_ptr<PerfResults>& p
     type_test_name = "task_run";
   } else if (perfResults->type_of_running == PerfResults::TypeOfRunning::PIPELINE) {
     type_test_name = "pipeline";
+  } else if (perfResults->type_of_running == PerfResults::TypeOfRunning::STREAM) {
+    type_test_name = "stream";
   } else if (perfResults->type_of_running == PerfResults::TypeOfRunning::NONE) {
     type_test_name = "none";
   }
 
-  auto first_found_position = relative_path.find(ppc_regex_template) + ppc_regex_template.length() + 1;
-  relative_path.erase(0, first_found_position);
-
-  auto last_found_position = relative_path.find(perf_regex_template) - 1;
-  relative_path.erase(last_found_position, relative_path.length() - 1);
-
   std::stringstream perf_res_str;
   if (time_secs < PerfResults::MAX_TIME) {
     perf_res_str << std::fixed << std::setprecision(10) << time_secs;
@@ -89,4 +301,104 @@ void ppc::core::Perf::print_perf_statistic(const std::shared_ptr<PerfResults>& p
   }
 
   std::cout << relative_path << ":" << type_test_name << ":" << perf_res_str.str() << std::endl;
+
+  const auto& numa = numa_config();
+  if (numa_topology().nodes.size() > 1 || numa.placement != MemoryPlacement::DEFAULT ||
+      numa.pinning != ThreadPinning::NONE) {
+    std::cout << relative_path << ":" << type_test_name << ":numa: nodes=" << numa_topology().nodes.size()
+              << " placement=" << to_string(numa.placement) << " pinning=" << to_string(numa.pinning) << std::endl;
+  }
+
+  if (perfResults->type_of_running == PerfResults::TypeOfRunning::STREAM) {
+    std::ostringstream line;
+    line << relative_path << ":" << type_test_name << ":throughput: items=" << perfResults->num_items
+         << " items_per_sec=" << std::fixed << std::setprecision(2) << perfResults->throughput;
+    std::cout << line.str() << std::endl;
+  }
+
+  const auto& rank_times = perfResults->rank_times;
+  if (!rank_times.empty()) {
+    auto minmax = std::minmax_element(rank_times.begin(), rank_times.end());
+    std::ostringstream line;
+    line << relative_path << ":" << type_test_name << ":ranks: num_ranks=" << rank_times.size() << " min=" << std::fixed
+         << std::setprecision(10) << *minmax.first << " max=" << *minmax.second
+         << " load_imbalance=" << std::setprecision(2) << perfResults->load_imbalance << "%";
+    std::cout << line.str() << std::endl;
+  }
+
+  const auto& profile = perfResults->phase_profile;
+  auto total_time = profile.total_time_sec();
+  if (total_time > 0.0) {
+    std::ostringstream line;
+    line << relative_path << ":" << type_test_name << ":phases:";
+    for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+      line << " " << PhaseProfile::PHASES[i] << "=" << std::fixed << std::setprecision(10)
+           << profile.phases[i].time_sec << " (" << std::setprecision(1)
+           << 100.0 * profile.phases[i].time_sec / total_time << "%)";
+    }
+    std::cout << line.str() << std::endl;
+  }
+
+  for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+    const auto& phase = perfResults->phase_counters[i];
+    if (phase.calls == 0) continue;
+    std::ostringstream line;
+    line << relative_path << ":" << type_test_name << ":" << PhaseProfile::PHASES[i] << ": time_sec=" << std::fixed
+         << std::setprecision(10) << phase.time_sec;
+    if (phase.has_counters) {
+      line << " cycles=" << phase.cycles << " instructions=" << phase.instructions
+           << " cache_misses=" << phase.cache_misses << " branch_misses=" << phase.branch_misses
+           << " ipc=" << std::setprecision(3) << phase.ipc()
+           << " (calling thread and threads exited in the phase, not pool workers)";
+    } else {
+      line << " (hardware counters are not available)";
+    }
+    std::cout << line.str() << std::endl;
+  }
+
+  for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+    const auto& memory = perfResults->phase_memory[i];
+    if (memory.calls == 0) continue;
+    std::cout << relative_path << ":" << type_test_name << ":" << PhaseProfile::PHASES[i] << ":";
+    if (memory.has_allocations) {
+      std::cout << " allocations=" << memory.allocations << " allocated_bytes=" << memory.allocated_bytes
+                << " peak_bytes=" << memory.peak_bytes;
+    }
+    std::cout << " peak_rss_bytes=" << memory.peak_rss_bytes << std::endl;
+  }
+
+  auto output_path = perf_output_path();
+  if (output_path.empty()) return;
+
+  // relative_path looks like "tasks/<backend>/<task_id>"
+  std::vector<std::string> parts;
+  std::stringstream path_stream(relative_path);
+  for (std::string part; std::getline(path_stream, part, '/');) {
+    parts.push_back(part);
+  }
+
+  PerfRecord record;
+  record.backend = parts.size() > 1 ? parts[1] : "";
+  record.task_id = parts.size() > 2 ? parts[2] : relative_path;
+  record.type_of_running = type_test_name;
+  record.num_processes = current_num_processes();
+  record.num_threads = current_num_threads();
+  record.input_size = perfResults->input_size;
+  record.num_running = perfResults->num_running;
+  record.time_sec = time_secs < PerfResults::MAX_TIME ? time_secs : -1.0;
+  record.samples = perfResults->samples;
+  record.statistics = perfResults->statistics;
+  record.phase_counters = perfResults->phase_counters;
+  record.phase_memory = perfResults->phase_memory;
+  record.phase_profile = perfResults->phase_profile;
+  record.rank_times = perfResults->rank_times;
+  record.load_imbalance = perfResults->load_imbalance;
+  record.throughput = perfResults->throughput;
+  if (!record.rank_times.empty()) record.num_processes = record.rank_times.size();
+  record.hardware = current_hardware_info();
+  record.memory_placement = to_string(numa.placement);
+  record.thread_pinning = to_string(numa.pinning);
+  record.timestamp =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  write_perf_record(output_path, record);
 }
@@ -0,0 +1,123 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/perf/include/perf_counters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+double ppc::core::PhaseCounters::ipc() const {
+  if (!has_counters || cycles == 0) return 0.0;
+  return static_cast<double>(instructions) / static_cast<double>(cycles);
+}
+
+ppc::core::PhaseCounters& ppc::core::PhaseCounters::operator+=(const PhaseCounters& other) {
+  calls += other.calls;
+  time_sec += other.time_sec;
+  has_counters = has_counters || other.has_counters;
+  cycles += other.cycles;
+  instructions += other.instructions;
+  cache_misses += other.cache_misses;
+  branch_misses += other.branch_misses;
+  return *this;
+}
+
+#ifdef __linux__
+namespace {
+
+// read() of a counter with PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+struct CounterValue {
+  uint64_t value;
+  uint64_t time_enabled;
+  uint64_t time_running;
+};
+
+// Counter of the calling thread and of the threads it starts from now on (inherit,
+// their counts arrive when they exit), a member of the group of group_fd or the leader
+// of a new group for -1
+int open_counter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  // the members follow the leader
+  attr.disabled = group_fd < 0 ? 1 : 0;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+}  // namespace
+#endif
+
+ppc::core::PerfCounterGroup::PerfCounterGroup() {
+#ifdef __linux__
+  // one group with cycles as the leader: the kernel schedules the counters together, so
+  // that all of them count the same time even when they are multiplexed
+  const std::array<uint64_t, NUM_EVENTS> configs = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  for (size_t i = 0; i < fds.size(); i++) {
+    fds[i] = open_counter(configs[i], i == CYCLES ? -1 : fds[CYCLES]);
+    if (fds[i] >= 0) continue;
+    // all counters or none, so that ipc() and the others describe the same runs
+    for (auto& fd : fds) {
+      if (fd >= 0) close(fd);
+      fd = -1;
+    }
+    return;
+  }
+#endif
+}
+
+ppc::core::PerfCounterGroup::~PerfCounterGroup() {
+#ifdef __linux__
+  for (auto fd : fds) {
+    if (fd >= 0) close(fd);
+  }
+#endif
+}
+
+void ppc::core::PerfCounterGroup::start() {
+#ifdef __linux__
+  if (available()) {
+    ioctl(fds[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+#endif
+  start_time = std::chrono::steady_clock::now();
+}
+
+ppc::core::PhaseCounters ppc::core::PerfCounterGroup::stop() {
+  auto end_time = std::chrono::steady_clock::now();
+  PhaseCounters counters;
+  counters.calls = 1;
+  counters.time_sec = std::chrono::duration<double>(end_time - start_time).count();
+#ifdef __linux__
+  if (!available()) return counters;
+  ioctl(fds[CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  std::array<uint64_t, NUM_EVENTS> values{};
+  for (size_t i = 0; i < fds.size(); i++) {
+    CounterValue counter{};
+    if (read(fds[i], &counter, sizeof(counter)) != static_cast<ssize_t>(sizeof(counter))) return counters;
+    // the group shares the time it was scheduled, so scaling keeps the ratios of the counters
+    values[i] = counter.time_running == 0 || counter.time_running == counter.time_enabled
+                    ? counter.value
+                    : static_cast<uint64_t>(static_cast<double>(counter.value) *
+                                            static_cast<double>(counter.time_enabled) /
+                                            static_cast<double>(counter.time_running));
+  }
+  counters.has_counters = true;
+  counters.cycles = values[CYCLES];
+  counters.instructions = values[INSTRUCTIONS];
+  counters.cache_misses = values[CACHE_MISSES];
+  counters.branch_misses = values[BRANCH_MISSES];
+#endif
+  return counters;
+}
@@ -0,0 +1,217 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/perf/include/perf_report.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "core/numa/include/numa.hpp"
+#include "core/perf/include/perf.hpp"
+
+namespace {
+
+std::string escape_json(const std::string& str) {
+  std::stringstream out;
+  for (auto c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+    } else {
+      out << c;
+    }
+  }
+  return out.str();
+}
+
+std::string escape_csv(const std::string& str) {
+  if (str.find_first_of(",\"\n") == std::string::npos) return str;
+  std::string out = "\"";
+  for (auto c : str) {
+    if (c == '"') out += '"';
+    out += c;
+  }
+  return out + "\"";
+}
+
+uint64_t env_to_uint(const std::string& name) {
+  auto value = ppc::core::get_env_variable(name);
+  if (value.empty()) return 0;
+  return std::strtoull(value.c_str(), nullptr, 10);
+}
+
+}  // namespace
+
+std::string ppc::core::get_env_variable(const std::string& name) {
+#ifdef _MSC_VER
+  char* buffer = nullptr;
+  size_t size = 0;
+  if (_dupenv_s(&buffer, &size, name.c_str()) != 0 || buffer == nullptr) return {};
+  std::string value(buffer);
+  free(buffer);
+  return value;
+#else
+  const char* value = std::getenv(name.c_str());
+  return value == nullptr ? std::string() : std::string(value);
+#endif
+}
+
+ppc::core::HardwareInfo ppc::core::current_hardware_info() {
+  HardwareInfo info;
+  info.logical_cores = std::thread::hardware_concurrency();
+  info.numa_nodes = numa_topology().nodes.size();
+
+#ifdef __linux__
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) == 0) {
+      auto colon = line.find(':');
+      if (colon != std::string::npos && colon + 2 <= line.size()) info.cpu_model = line.substr(colon + 2);
+      break;
+    }
+  }
+#endif
+
+  for (const auto* name : {"HOSTNAME", "COMPUTERNAME"}) {
+    auto hostname = get_env_variable(name);
+    if (!hostname.empty()) {
+      info.hostname = hostname;
+      break;
+    }
+  }
+  return info;
+}
+
+uint64_t ppc::core::current_num_processes() {
+  for (const auto* name : {"OMPI_COMM_WORLD_SIZE", "PMI_SIZE", "MPI_LOCALNRANKS"}) {
+    auto size = env_to_uint(name);
+    if (size > 0) return size;
+  }
+  return 1;
+}
+
+uint64_t ppc::core::current_num_threads() {
+  for (const auto* name : {"PPC_NUM_THREADS", "OMP_NUM_THREADS"}) {
+    auto threads = env_to_uint(name);
+    if (threads > 0) return threads;
+  }
+  return std::max<uint64_t>(std::thread::hardware_concurrency(), 1);
+}
+
+std::string ppc::core::perf_output_path() {
+  const std::string flag = "--perf_output=";
+  for (const auto& arg : ::testing::internal::GetArgvs()) {
+    if (arg.rfind(flag, 0) == 0) return arg.substr(flag.size());
+  }
+  return get_env_variable("PPC_PERF_OUTPUT");
+}
+
+std::string ppc::core::to_json(const PerfRecord& record) {
+  const auto& stats = record.statistics;
+  std::stringstream out;
+  out << std::setprecision(10);
+  out << "{\"task_id\":\"" << escape_json(record.task_id) << "\",\"backend\":\"" << escape_json(record.backend)
+      << "\",\"type_of_running\":\"" << escape_json(record.type_of_running)
+      << "\",\"num_processes\":" << record.num_processes << ",\"num_threads\":" << record.num_threads
+      << ",\"input_size\":" << record.input_size << ",\"num_running\":" << record.num_running
+      << ",\"time_sec\":" << record.time_sec << ",\"samples\":[";
+  for (size_t i = 0; i < record.samples.size(); i++) {
+    out << (i == 0 ? "" : ",") << record.samples[i];
+  }
+  out << "],\"throughput\":" << record.throughput << ",\"load_imbalance\":" << record.load_imbalance
+      << ",\"rank_times\":[";
+  for (size_t i = 0; i < record.rank_times.size(); i++) {
+    out << (i == 0 ? "" : ",") << record.rank_times[i];
+  }
+  out << "],\"statistics\":{\"num_samples\":" << stats.num_samples << ",\"num_outliers\":" << stats.num_outliers
+      << ",\"min\":" << stats.min << ",\"max\":" << stats.max << ",\"mean\":" << stats.mean
+      << ",\"median\":" << stats.median << ",\"p90\":" << stats.p90 << ",\"p99\":" << stats.p99
+      << ",\"stddev\":" << stats.stddev << ",\"ci_low\":" << stats.ci_low << ",\"ci_high\":" << stats.ci_high
+      << ",\"relative_error\":" << stats.relative_error << "},\"phase_time_sec\":{";
+  for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+    out << (i == 0 ? "" : ",") << "\"" << PhaseProfile::PHASES[i] << "\":" << record.phase_profile.phases[i].time_sec;
+  }
+  out << "},\"phases\":{";
+  bool first_phase = true;
+  for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+    const auto& phase = record.phase_counters[i];
+    if (phase.calls == 0) continue;
+    out << (first_phase ? "" : ",") << "\"" << PhaseProfile::PHASES[i] << "\":{\"calls\":" << phase.calls
+        << ",\"time_sec\":" << phase.time_sec << ",\"has_counters\":" << (phase.has_counters ? "true" : "false");
+    if (phase.has_counters) {
+      out << ",\"cycles\":" << phase.cycles << ",\"instructions\":" << phase.instructions
+          << ",\"cache_misses\":" << phase.cache_misses << ",\"branch_misses\":" << phase.branch_misses
+          << ",\"ipc\":" << phase.ipc();
+    }
+    out << "}";
+    first_phase = false;
+  }
+  out << "},\"memory\":{";
+  bool first_memory = true;
+  for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+    const auto& memory = record.phase_memory[i];
+    if (memory.calls == 0) continue;
+    out << (first_memory ? "" : ",") << "\"" << PhaseProfile::PHASES[i] << "\":{\"calls\":" << memory.calls
+        << ",\"peak_rss_bytes\":" << memory.peak_rss_bytes;
+    if (memory.has_allocations) {
+      out << ",\"allocations\":" << memory.allocations << ",\"allocated_bytes\":" << memory.allocated_bytes
+          << ",\"peak_bytes\":" << memory.peak_bytes;
+    }
+    out << "}";
+    first_memory = false;
+  }
+  out << "},\"hardware\":{\"cpu_model\":\"" << escape_json(record.hardware.cpu_model)
+      << "\",\"logical_cores\":" << record.hardware.logical_cores << ",\"hostname\":\""
+      << escape_json(record.hardware.hostname) << "\",\"numa_nodes\":" << record.hardware.numa_nodes
+      << "},\"numa\":{\"memory_placement\":\"" << escape_json(record.memory_placement) << "\",\"thread_pinning\":\""
+      << escape_json(record.thread_pinning) << "\"},\"timestamp\":" << record.timestamp << "}";
+  return out.str();
+}
+
+std::string ppc::core::csv_header() {
+  return "task_id,backend,type_of_running,num_processes,num_threads,input_size,num_running,time_sec,"
+         "min,median,p90,p99,stddev,relative_error,load_imbalance,cpu_model,logical_cores,hostname,numa_nodes,memory_placement,"
+         "thread_pinning,timestamp,samples";
+}
+
+std::string ppc::core::to_csv(const PerfRecord& record) {
+  const auto& stats = record.statistics;
+  std::stringstream out;
+  out << std::setprecision(10);
+  out << escape_csv(record.task_id) << ',' << escape_csv(record.backend) << ',' << escape_csv(record.type_of_running)
+      << ',' << record.num_processes << ',' << record.num_threads << ',' << record.input_size << ',' << record.num_running
+      << ',' << record.time_sec << ',' << stats.min << ',' << stats.median << ',' << stats.p90 << ',' << stats.p99
+      << ',' << stats.stddev << ',' << stats.relative_error << ',' << record.load_imbalance << ',' << escape_csv(record.hardware.cpu_model) << ','
+      << record.hardware.logical_cores << ',' << escape_csv(record.hardware.hostname) << ','
+      << record.hardware.numa_nodes << ',' << escape_csv(record.memory_placement) << ','
+      << escape_csv(record.thread_pinning) << ','
+      << record.timestamp << ',';
+  for (size_t i = 0; i < record.samples.size(); i++) {
+    out << (i == 0 ? "" : ";") << record.samples[i];
+  }
+  return out.str();
+}
+
+void ppc::core::write_perf_record(const std::string& path, const PerfRecord& record) {
+  bool is_csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+  bool is_new_file = !std::ifstream(path).good();
+
+  std::ofstream out(path, std::ios::app);
+  if (!out) {
+    std::cerr << "Can't open perf output file: " << path << std::endl;
+    return;
+  }
+  if (is_csv) {
+    if (is_new_file) out << csv_header() << '\n';
+    out << to_csv(record) << '\n';
+  } else {
+    out << to_json(record) << '\n';
+  }
+}
@@ -0,0 +1,133 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/perf/include/scaling.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+double ppc::core::fit_amdahl(const std::vector<ScalingPoint>& points) {
+  // 1 / S - 1 / p = s * (1 - 1 / p)
+  double xy = 0.0;
+  double xx = 0.0;
+  for (const auto& point : points) {
+    if (point.speedup <= 0.0 || point.num_workers == 0) continue;
+    auto inv_p = 1.0 / static_cast<double>(point.num_workers);
+    auto x = 1.0 - inv_p;
+    auto y = 1.0 / point.speedup - inv_p;
+    xy += x * y;
+    xx += x * x;
+  }
+  return xx > 0.0 ? std::clamp(xy / xx, 0.0, 1.0) : 0.0;
+}
+
+double ppc::core::fit_gustafson(const std::vector<ScalingPoint>& points) {
+  // p - S = s * (p - 1)
+  double xy = 0.0;
+  double xx = 0.0;
+  for (const auto& point : points) {
+    auto p = static_cast<double>(point.num_workers);
+    auto x = p - 1.0;
+    auto y = p - point.speedup;
+    xy += x * y;
+    xx += x * x;
+  }
+  return xx > 0.0 ? std::clamp(xy / xx, 0.0, 1.0) : 0.0;
+}
+
+ppc::core::Scaling::Scaling(std::shared_ptr<ScalingAttr> scalingAttr_) : scalingAttr(std::move(scalingAttr_)) {
+  if (!scalingAttr->make_task) throw std::invalid_argument("Scaling: make_task is not set");
+  if (scalingAttr->num_workers.empty() || scalingAttr->input_sizes.empty()) {
+    throw std::invalid_argument("Scaling: num_workers and input_sizes can't be empty");
+  }
+}
+
+double ppc::core::Scaling::measure(uint64_t num_workers, uint64_t input_size) {
+  auto task = scalingAttr->make_task(num_workers, input_size);
+  auto perfResults = std::make_shared<PerfResults>();
+  Perf perf(task);
+  if (scalingAttr->type_of_running == PerfResults::TypeOfRunning::TASK_RUN) {
+    perf.task_run(scalingAttr->perf_attr, perfResults);
+  } else {
+    perf.pipeline_run(scalingAttr->perf_attr, perfResults);
+  }
+  return perfResults->time_sec / static_cast<double>(std::max<uint64_t>(scalingAttr->perf_attr->num_running, 1));
+}
+
+void ppc::core::Scaling::strong_run(const std::shared_ptr<ScalingResults>& scalingResults) {
+  scalingResults->type_of_scaling = ScalingResults::TypeOfScaling::STRONG;
+  scalingResults->curves.clear();
+  for (auto input_size : scalingAttr->input_sizes) {
+    ScalingCurve curve;
+    curve.input_size = input_size;
+    for (auto num_workers : scalingAttr->num_workers) {
+      ScalingPoint point;
+      point.num_workers = num_workers;
+      point.input_size = input_size;
+      point.time_sec = measure(num_workers, input_size);
+      curve.points.push_back(point);
+    }
+    finish_curve(curve, ScalingResults::TypeOfScaling::STRONG);
+    scalingResults->curves.push_back(std::move(curve));
+  }
+}
+
+void ppc::core::Scaling::weak_run(const std::shared_ptr<ScalingResults>& scalingResults) {
+  scalingResults->type_of_scaling = ScalingResults::TypeOfScaling::WEAK;
+  scalingResults->curves.clear();
+  for (auto input_size : scalingAttr->input_sizes) {
+    ScalingCurve curve;
+    curve.input_size = input_size;
+    for (auto num_workers : scalingAttr->num_workers) {
+      ScalingPoint point;
+      point.num_workers = num_workers;
+      point.input_size = input_size * num_workers;
+      point.time_sec = measure(num_workers, point.input_size);
+      curve.points.push_back(point);
+    }
+    finish_curve(curve, ScalingResults::TypeOfScaling::WEAK);
+    scalingResults->curves.push_back(std::move(curve));
+  }
+}
+
+void ppc::core::Scaling::finish_curve(ScalingCurve& curve, ScalingResults::TypeOfScaling type) const {
+  const auto& base = curve.points.front();
+  auto base_workers = static_cast<double>(base.num_workers);
+  for (auto& point : curve.points) {
+    if (point.time_sec <= 0.0) continue;
+    auto workers = static_cast<double>(point.num_workers);
+    if (type == ScalingResults::TypeOfScaling::STRONG) {
+      point.speedup = base_workers * base.time_sec / point.time_sec;
+    } else {
+      point.speedup = workers * base.time_sec / point.time_sec / base_workers;
+    }
+    point.efficiency = point.speedup / workers;
+    if (point.efficiency >= scalingAttr->efficiency_threshold) {
+      curve.max_efficient_workers = std::max(curve.max_efficient_workers, point.num_workers);
+    }
+  }
+  curve.serial_fraction =
+      type == ScalingResults::TypeOfScaling::STRONG ? fit_amdahl(curve.points) : fit_gustafson(curve.points);
+}
+
+void ppc::core::Scaling::print_scaling_statistic(const std::shared_ptr<ScalingResults>& scalingResults) {
+  const bool is_strong = scalingResults->type_of_scaling == ScalingResults::TypeOfScaling::STRONG;
+  const std::string type_name = is_strong ? "strong" : "weak";
+  for (const auto& curve : scalingResults->curves) {
+    std::ostringstream line;
+    line << type_name << ":input_size=" << curve.input_size << ":" << (is_strong ? "amdahl" : "gustafson")
+         << "_serial_fraction=" << std::fixed << std::setprecision(4) << curve.serial_fraction
+         << ":max_efficient_workers=" << curve.max_efficient_workers;
+    std::cout << line.str() << std::endl;
+    for (const auto& point : curve.points) {
+      std::ostringstream point_line;
+      point_line << type_name << ":input_size=" << curve.input_size << ":workers=" << point.num_workers
+                 << ":time=" << std::fixed << std::setprecision(10) << point.time_sec
+                 << ":speedup=" << std::setprecision(4) << point.speedup << ":efficiency=" << point.efficiency;
+      std::cout << point_line.str() << std::endl;
+    }
+  }
+}
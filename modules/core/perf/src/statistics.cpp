@@ -0,0 +1,79 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/perf/include/statistics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <numeric>
+
+double ppc::core::percentile(const std::vector<double>& sorted_samples, double q) {
+  if (sorted_samples.empty()) return 0.0;
+  auto position = std::clamp(q, 0.0, 1.0) * static_cast<double>(sorted_samples.size() - 1);
+  auto lower = static_cast<size_t>(std::floor(position));
+  auto upper = std::min(lower + 1, sorted_samples.size() - 1);
+  auto fraction = position - static_cast<double>(lower);
+  return sorted_samples[lower] + fraction * (sorted_samples[upper] - sorted_samples[lower]);
+}
+
+double ppc::core::student_t_95(uint64_t degrees_of_freedom) {
+  static const std::array<double, 30> table = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                               2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                               2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  if (degrees_of_freedom == 0) return table[0];
+  if (degrees_of_freedom <= table.size()) return table[degrees_of_freedom - 1];
+  return 1.960;
+}
+
+double ppc::core::relative_error(uint64_t num_samples, double mean, double stddev) {
+  if (num_samples < 2 || mean <= 0.0) return 0.0;
+  auto half_width = student_t_95(num_samples - 1) * stddev / std::sqrt(static_cast<double>(num_samples));
+  return half_width / mean;
+}
+
+std::vector<double> ppc::core::reject_outliers(const std::vector<double>& samples, double iqr_factor) {
+  if (iqr_factor <= 0.0 || samples.size() < 4) return samples;
+  auto sorted = samples;
+  std::sort(sorted.begin(), sorted.end());
+  auto q1 = percentile(sorted, 0.25);
+  auto q3 = percentile(sorted, 0.75);
+  auto low = q1 - iqr_factor * (q3 - q1);
+  auto high = q3 + iqr_factor * (q3 - q1);
+
+  std::vector<double> kept;
+  kept.reserve(samples.size());
+  std::copy_if(samples.begin(), samples.end(), std::back_inserter(kept),
+               [&](double sample) { return sample >= low && sample <= high; });
+  return kept;
+}
+
+ppc::core::SampleStatistics ppc::core::compute_statistics(const std::vector<double>& samples, double iqr_factor) {
+  SampleStatistics stats;
+  auto kept = reject_outliers(samples, iqr_factor);
+  stats.num_outliers = samples.size() - kept.size();
+  stats.num_samples = kept.size();
+  if (kept.empty()) return stats;
+
+  std::sort(kept.begin(), kept.end());
+  stats.min = kept.front();
+  stats.max = kept.back();
+  stats.median = percentile(kept, 0.5);
+  stats.p90 = percentile(kept, 0.9);
+  stats.p99 = percentile(kept, 0.99);
+  stats.mean = std::accumulate(kept.begin(), kept.end(), 0.0) / static_cast<double>(kept.size());
+
+  if (kept.size() > 1) {
+    double sq_sum = 0.0;
+    for (auto sample : kept) {
+      sq_sum += (sample - stats.mean) * (sample - stats.mean);
+    }
+    stats.stddev = std::sqrt(sq_sum / static_cast<double>(kept.size() - 1));
+  }
+
+  auto half_width =
+      kept.size() > 1 ? student_t_95(kept.size() - 1) * stats.stddev / std::sqrt(static_cast<double>(kept.size())) : 0.0;
+  stats.ci_low = stats.mean - half_width;
+  stats.ci_high = stats.mean + half_width;
+  stats.relative_error = relative_error(kept.size(), stats.mean, stats.stddev);
+  return stats;
+}
@@ -0,0 +1,123 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/random/include/random.hpp"
+#include "core/task/include/execution.hpp"
+
+namespace rng = ppc::core::rng;
+
+TEST(random_tests, check_philox_known_answers) {
+  // known answers of the Random123 library for philox4x32-10
+  EXPECT_EQ(rng::philox({0, 0, 0, 0}, 0), (rng::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  EXPECT_EQ(rng::philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, 0xffffffffffffffff),
+            (rng::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  EXPECT_EQ(rng::philox({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, 0x299f31d0a4093822),
+            (rng::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(random_tests, check_streams_and_discard) {
+  rng::Philox gen(1, 2);
+  std::vector<uint32_t> values(11);
+  for (auto& value : values) value = gen();
+  for (uint64_t skip = 0; skip < values.size(); skip++) {
+    rng::Philox other(1, 2);
+    other.discard(skip);
+    EXPECT_EQ(other(), values[skip]);
+  }
+  // same counter under another seed or in another stream
+  EXPECT_NE(rng::Philox(2, 2)(), values[0]);
+  EXPECT_NE(rng::Philox(1, 3)(), values[0]);
+  // works as the generator of <random> distributions
+  std::uniform_int_distribution<int> dist(1, 6);
+  const int roll = dist(gen);
+  EXPECT_TRUE(roll >= 1 && roll <= 6);
+}
+
+TEST(random_tests, check_fill_does_not_depend_on_policy) {
+  const rng::Uniform<int> dist(-100, 100);
+  const auto expected = rng::make_vector<int>(1000, 42, dist, {ppc::core::Backend::SEQ, 0});
+  for (auto backend : ppc::core::available_backends()) {
+    for (uint64_t num_threads : {1, 3, 8}) {
+      EXPECT_EQ(rng::make_vector<int>(1000, 42, dist, {backend, num_threads}), expected);
+    }
+  }
+  EXPECT_NE(rng::make_vector<int>(1000, 43, dist), expected);
+}
+
+TEST(random_tests, check_slices_match_the_global_fill) {
+  const rng::Normal<double> dist(0.0, 1.0);
+  const auto global = rng::make_vector<double>(1001, 7, dist);
+  // every process of 4 fills its block of the global input on its own
+  const size_t num_procs = 4;
+  for (size_t rank = 0; rank < num_procs; rank++) {
+    const size_t begin = global.size() * rank / num_procs;
+    const size_t end = global.size() * (rank + 1) / num_procs;
+    std::vector<double> local(end - begin);
+    rng::fill(std::span<double>(local), 7, dist, {ppc::core::Backend::STL, 2}, begin);
+    EXPECT_TRUE(std::equal(local.begin(), local.end(), global.begin() + begin));
+  }
+}
+
+TEST(random_tests, check_distributions) {
+  const size_t n = 100000;
+  const auto ints = rng::make_vector<int8_t>(n, 1, rng::Uniform<int8_t>(-3, 3));
+  std::vector<size_t> counts(7);
+  for (auto v : ints) {
+    ASSERT_TRUE(v >= -3 && v <= 3);
+    counts[v + 3]++;
+  }
+  for (auto count : counts) EXPECT_NEAR(static_cast<double>(count), n / 7.0, n / 7.0 * 0.05);
+
+  const auto full = rng::make_vector<uint64_t>(1000, 1, rng::Uniform<uint64_t>(0, UINT64_MAX));
+  EXPECT_TRUE(std::any_of(full.begin(), full.end(), [](uint64_t v) { return v > (uint64_t(1) << 63); }));
+
+  const auto reals = rng::make_vector<float>(n, 2, rng::Uniform<float>(2.0F, 4.0F));
+  double mean = 0;
+  for (auto v : reals) {
+    ASSERT_TRUE(v >= 2.0F && v < 4.0F);
+    mean += v / n;
+  }
+  EXPECT_NEAR(mean, 3.0, 0.01);
+
+  const auto normal = rng::make_matrix<double>(100, 1000, 3, rng::Normal<double>(5.0, 2.0));
+  double sum = 0;
+  double sum_sq = 0;
+  for (auto v : normal) {
+    sum += v;
+    sum_sq += v * v;
+  }
+  mean = sum / normal.size();
+  EXPECT_NEAR(mean, 5.0, 0.02);
+  EXPECT_NEAR(std::sqrt(sum_sq / normal.size() - mean * mean), 2.0, 0.02);
+
+  EXPECT_THROW(rng::Uniform<int>(1, 0), std::invalid_argument);
+  EXPECT_THROW(rng::Normal<double>(0.0, -1.0), std::invalid_argument);
+}
+
+TEST(random_tests, check_seed_for_test) {
+  const uint64_t seed = rng::seed_for_test();
+  EXPECT_EQ(seed, rng::seed_for("random_tests.check_seed_for_test"));
+  EXPECT_NE(seed, rng::seed_for("random_tests.check_distributions"));
+  EXPECT_NE(seed, rng::seed_from_env());
+#ifndef _WIN32
+  // PPC_SEED still changes the input of every test
+  const char* previous = std::getenv("PPC_SEED");
+  const std::string saved = previous != nullptr ? previous : "";
+  setenv("PPC_SEED", "7", 1);
+  EXPECT_NE(rng::seed_for_test(), seed);
+  if (previous != nullptr) {
+    setenv("PPC_SEED", saved.c_str(), 1);
+  } else {
+    unsetenv("PPC_SEED");
+  }
+#endif
+}
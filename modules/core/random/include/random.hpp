@@ -0,0 +1,202 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_RANDOM_HPP_
+#define MODULES_CORE_INCLUDE_RANDOM_HPP_
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "core/task/include/execution.hpp"
+
+namespace ppc::core::rng {
+
+// Test inputs generated from a seed instead of std::random_device, so that every run
+// and every backend sees the same data. Element i of a fill is drawn from its own
+// stream of a counter-based generator, so the elements are independent of each other:
+// they can be generated in any order, on any number of threads, and a process can
+// generate just its slice of a global input (first_index of fill) without talking to
+// the others.
+
+using Block = std::array<uint32_t, 4>;
+
+// Philox4x32-10 of Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (SC'11):
+// a bijection of the 128 bit counter keyed by key
+inline Block philox(Block counter, uint64_t key) {
+  constexpr uint32_t M0 = 0xD2511F53;
+  constexpr uint32_t M1 = 0xCD9E8D57;
+  constexpr uint32_t W0 = 0x9E3779B9;
+  constexpr uint32_t W1 = 0xBB67AE85;
+  auto k0 = static_cast<uint32_t>(key);
+  auto k1 = static_cast<uint32_t>(key >> 32);
+  for (int round = 0; round < 10; round++) {
+    const uint64_t p0 = static_cast<uint64_t>(M0) * counter[0];
+    const uint64_t p1 = static_cast<uint64_t>(M1) * counter[2];
+    counter = {static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ k0, static_cast<uint32_t>(p1),
+               static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ k1, static_cast<uint32_t>(p0)};
+    k0 += W0;
+    k1 += W1;
+  }
+  return counter;
+}
+
+// Stream number stream of the generator seeded with seed. Meets the uniform random bit
+// generator requirements, so the <random> distributions accept it too.
+class Philox {
+ public:
+  using result_type = uint32_t;
+
+  explicit Philox(uint64_t seed_, uint64_t stream_ = 0) : seed(seed_), stream(stream_) {}
+
+  result_type operator()() {
+    if (used == block.size()) {
+      block = philox({static_cast<uint32_t>(position), static_cast<uint32_t>(position >> 32),
+                      static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)},
+                     seed);
+      position++;
+      used = 0;
+    }
+    return block[used++];
+  }
+
+  uint64_t next_u64() {
+    const uint64_t lo = (*this)();
+    return lo | (static_cast<uint64_t>((*this)()) << 32);
+  }
+
+  // uniform in [0, 1) with all 53 bits of the mantissa random
+  double next_double() { return static_cast<double>(next_u64() >> 11) * 0x1.0p-53; }
+
+  void discard(uint64_t n) {
+    const uint64_t buffered = block.size() - used;
+    if (n <= buffered) {
+      used += n;
+      return;
+    }
+    n -= buffered;
+    position += n / block.size();
+    used = block.size();
+    if (n % block.size() != 0) {
+      (*this)();
+      used = n % block.size();
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+ private:
+  uint64_t seed;
+  uint64_t stream;
+  // index of the next block of the stream
+  uint64_t position = 0;
+  Block block{};
+  size_t used = block.size();
+};
+
+// Integers uniform in [a, b], floating point uniform in [a, b). Unlike the <random>
+// distributions, the values do not depend on the standard library.
+template <class T>
+struct Uniform {
+  static_assert(std::is_arithmetic_v<T>);
+  T a;
+  T b;
+
+  Uniform(T a_, T b_) : a(a_), b(b_) {
+    if (b < a) throw std::invalid_argument("Uniform: b is less than a");
+  }
+
+  T operator()(Philox& gen) const {
+    if constexpr (std::is_integral_v<T>) {
+      // number of values less one, so that the full range of uint64_t fits
+      const auto span = static_cast<uint64_t>(static_cast<uint64_t>(b) - static_cast<uint64_t>(a));
+      uint64_t x = gen.next_u64();
+      if (span != std::numeric_limits<uint64_t>::max()) {
+        // drop the 2^64 mod n lowest values, which would make x mod n biased
+        const uint64_t n = span + 1;
+        const uint64_t threshold = (0 - n) % n;
+        while (x < threshold) x = gen.next_u64();
+        x %= n;
+      }
+      return static_cast<T>(static_cast<uint64_t>(a) + x);
+    } else {
+      const T value = a + static_cast<T>((b - a) * gen.next_double());
+      // rounding may give b itself
+      return value < b || a == b ? value : std::nextafter(b, a);
+    }
+  }
+};
+
+// Normal with mean and stddev, by the Box-Muller transform
+template <class T>
+struct Normal {
+  static_assert(std::is_floating_point_v<T>);
+  T mean;
+  T stddev;
+
+  Normal(T mean_, T stddev_) : mean(mean_), stddev(stddev_) {
+    if (!(stddev >= 0)) throw std::invalid_argument("Normal: stddev is negative");
+  }
+
+  T operator()(Philox& gen) const {
+    // 1 - u is in (0, 1], so the log is finite
+    const double radius = std::sqrt(-2.0 * std::log(1.0 - gen.next_double()));
+    const double angle = 2.0 * 3.14159265358979323846 * gen.next_double();
+    return mean + stddev * static_cast<T>(radius * std::cos(angle));
+  }
+};
+
+// Seed of the PPC_SEED environment variable, DEFAULT_SEED when it is not set
+constexpr uint64_t DEFAULT_SEED = 20240901;
+uint64_t seed_from_env();
+// seed_from_env() mixed with name
+uint64_t seed_for(std::string_view name);
+// seed_for("<suite>.<test>") of the running gtest test, so that every functional test
+// checks an input of its own, and rerunning one test alone (or on every rank) gives it
+// the same input; seed_from_env() outside of a test. Perf tests keep seed_from_env() so
+// that their input does not change with the test name.
+uint64_t seed_for_test();
+
+// out[i] = dist(gen) with gen = Philox(seed, first_index + i): out holds the elements
+// [first_index, first_index + out.size()) of the sequence of seed, whatever the policy.
+// dist is anything callable with a Philox& (Uniform, Normal, or a lambda over a <random>
+// distribution), a fresh copy of it is used for every element.
+template <class T, class Dist>
+void fill(std::span<T> out, uint64_t seed, const Dist& dist,
+          const ExecutionPolicy& policy = {Backend::STL, 0}, uint64_t first_index = 0) {
+  const uint64_t count = out.size();
+  const uint64_t num_chunks = detail::num_chunks(policy, count);
+  detail::for_each_chunk(policy, num_chunks, [&](uint64_t c) {
+    const uint64_t end = detail::chunk_begin(count, num_chunks, c + 1);
+    for (uint64_t i = detail::chunk_begin(count, num_chunks, c); i < end; i++) {
+      Philox gen(seed, first_index + i);
+      Dist element_dist = dist;
+      out[i] = static_cast<T>(element_dist(gen));
+    }
+  });
+}
+
+template <class T, class Dist>
+std::vector<T> make_vector(size_t size, uint64_t seed, const Dist& dist,
+                           const ExecutionPolicy& policy = {Backend::STL, 0}) {
+  std::vector<T> result(size);
+  fill(std::span<T>(result), seed, dist, policy);
+  return result;
+}
+
+// rows x cols row-major, element (r, c) has the index r * cols + c in the sequence of seed
+template <class T, class Dist>
+std::vector<T> make_matrix(size_t rows, size_t cols, uint64_t seed, const Dist& dist,
+                           const ExecutionPolicy& policy = {Backend::STL, 0}) {
+  return make_vector<T>(rows * cols, seed, dist, policy);
+}
+
+}  // namespace ppc::core::rng
+
+#endif  // MODULES_CORE_INCLUDE_RANDOM_HPP_
@@ -0,0 +1,30 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/random/include/random.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+
+uint64_t ppc::core::rng::seed_from_env() {
+  if (const char* seed = std::getenv("PPC_SEED")) {
+    return std::stoull(seed, nullptr, 0);
+  }
+  return DEFAULT_SEED;
+}
+
+uint64_t ppc::core::rng::seed_for(std::string_view name) {
+  // FNV-1a of name, then the finalizer of splitmix64 over it and the seed
+  uint64_t hash = 0xcbf29ce484222325;
+  for (const char c : name) hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+  uint64_t seed = seed_from_env() ^ hash;
+  seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9;
+  seed = (seed ^ (seed >> 27)) * 0x94d049bb133111eb;
+  return seed ^ (seed >> 31);
+}
+
+uint64_t ppc::core::rng::seed_for_test() {
+  const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+  if (info == nullptr) return seed_from_env();
+  return seed_for(std::string(info->test_suite_name()) + "." + info->name());
+}
@@ -0,0 +1,116 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "core/perf/include/alloc_tracker.hpp"
+#include "core/task/include/arena.hpp"
+#include "core/task/include/task.hpp"
+
+namespace {
+
+// Sum of the input with a copy of it made in scratch memory on every run
+class ScratchSumTask : public ppc::core::Task {
+ public:
+  explicit ScratchSumTask(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(std::move(taskData_)) {}
+  bool validation() override {
+    internal_order_test();
+    return taskData->outputs_count[0] == 1;
+  }
+  bool pre_processing() override {
+    internal_order_test();
+    auto input = taskData->input_span<int32_t>(0);
+    input_ = std::pmr::vector<int32_t>(input.begin(), input.end(), &scratch);
+    return true;
+  }
+  bool run() override {
+    internal_order_test();
+    std::pmr::vector<int64_t> partial(input_.begin(), input_.end(), &scratch);
+    taskData->output_span<int64_t>(0)[0] = std::accumulate(partial.begin(), partial.end(), int64_t(0));
+    return true;
+  }
+  bool post_processing() override {
+    internal_order_test();
+    return true;
+  }
+
+ private:
+  std::pmr::vector<int32_t> input_{&scratch};
+};
+
+}  // namespace
+
+TEST(arena_tests, check_reset_reuses_blocks) {
+  ppc::core::Arena arena(1024);
+  for (int iteration = 0; iteration < 3; iteration++) {
+    arena.reset();
+    std::pmr::vector<int> small(100, 1, &arena);
+    std::pmr::vector<double> large(10000, 2.0, &arena);
+    EXPECT_EQ(std::accumulate(small.begin(), small.end(), 0), 100);
+    EXPECT_EQ(std::accumulate(large.begin(), large.end(), 0.0), 20000.0);
+  }
+  // the first iteration grew the arena, the others ran in its blocks
+  EXPECT_EQ(arena.stats().allocations, 6U);
+  EXPECT_EQ(arena.stats().upstream_allocations, 2U);
+  EXPECT_GE(arena.capacity(), 100 * sizeof(int) + 10000 * sizeof(double));
+  EXPECT_GE(arena.stats().peak_bytes, 100 * sizeof(int) + 10000 * sizeof(double));
+}
+
+TEST(arena_tests, check_alignment) {
+  ppc::core::Arena arena(256);
+  for (size_t alignment : {size_t(1), size_t(8), size_t(64), size_t(256), size_t(4096)}) {
+    void* data = arena.allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % alignment, 0U);
+  }
+}
+
+TEST(arena_tests, check_rewind_to_mark) {
+  ppc::core::Arena arena;
+  static_cast<void>(arena.allocate(100));
+  const auto mark = arena.mark();
+  const auto used = arena.used();
+  void* first = arena.allocate(1000);
+  arena.rewind(mark);
+  EXPECT_EQ(arena.used(), used);
+  EXPECT_EQ(arena.allocate(1000), first);
+  arena.reset();
+  EXPECT_EQ(arena.used(), 0U);
+  EXPECT_THROW(arena.rewind(mark), std::invalid_argument);
+
+  arena.release();
+  EXPECT_EQ(arena.capacity(), 0U);
+}
+
+TEST(arena_tests, check_task_iterations_without_heap_allocations) {
+  std::vector<int32_t> in(10000, 3);
+  std::vector<int64_t> out(1, 0);
+  auto taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(in);
+  taskData->add_output(out);
+  ScratchSumTask task(taskData);
+
+  const auto iteration = [&](int runs) {
+    ASSERT_TRUE(task.validation());
+    task.pre_processing();
+    for (int i = 0; i < runs; i++) task.run();
+    task.post_processing();
+    EXPECT_EQ(out[0], 30000);
+  };
+  iteration(2);
+  const auto upstream = task.get_scratch().stats().upstream_allocations;
+  const auto peak = task.get_scratch().stats().peak_bytes;
+
+  ppc::core::AllocTracker::start();
+  for (int i = 0; i < 5; i++) iteration(3);
+  const auto memory = ppc::core::AllocTracker::stop();
+  EXPECT_EQ(task.get_scratch().stats().upstream_allocations, upstream);
+  EXPECT_EQ(task.get_scratch().stats().peak_bytes, peak);
+  if (memory.has_allocations) {
+    EXPECT_EQ(memory.allocations, 0U);
+  }
+}
@@ -1,10 +1,22 @@
 // Copyright 2023 Nesterov Alexander
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "core/task/func_tests/test_task.hpp"
+#include "core/task/include/batch.hpp"
+#include "core/task/include/execution.hpp"
+#include "core/task/include/pipeline_executor.hpp"
 #include "core/task/include/task.hpp"
+#include "core/task/include/thread_pool.hpp"
 
 TEST(task_tests, check_int32_t) {
   // Create data
@@ -154,6 +166,368 @@ TEST(task_tests, check_wrong_order) {
   ASSERT_ANY_THROW(testTask.post_processing());
 }
 
+TEST(task_tests, check_wrong_order_message) {
+  // Create data
+  std::vector<float> in(20, 1);
+  std::vector<float> out(1, 0);
+
+  // Create TaskData
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(in);
+  taskData->add_output(out);
+
+  // Create Task
+  ppc::test::TestTask<float> testTask(taskData);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(testTask.validation(), true);
+    testTask.pre_processing();
+    testTask.run();
+    testTask.run();
+    testTask.post_processing();
+  }
+  ASSERT_EQ(testTask.validation(), true);
+  std::string message;
+  try {
+    testTask.run();
+  } catch (const std::invalid_argument &e) {
+    message = e.what();
+  }
+  EXPECT_EQ(message,
+            "ORDER OF FUCTIONS IS NOT RIGHT: \nSerial number: 14\nYours function: run\nExpected function: "
+            "pre_processing");
+  // the task can't get back into the right order
+  ASSERT_ANY_THROW(testTask.pre_processing());
+}
+
+TEST(task_tests, check_typed_input_is_zero_copy) {
+  // Create data
+  std::vector<int32_t> in(20, 1);
+  std::vector<int32_t> out(1, 0);
+
+  // Create TaskData
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(in);
+  taskData->add_output(out);
+
+  ASSERT_EQ(taskData->inputs_count[0], in.size());
+  auto span = taskData->input_span<int32_t>(0);
+  EXPECT_EQ(span.data(), in.data());
+  EXPECT_EQ(span.size(), in.size());
+  EXPECT_EQ(taskData->input(0).dtype, ppc::core::DataType::INT32);
+  EXPECT_ANY_THROW(static_cast<void>(taskData->input_span<float>(0)));
+
+  // Create Task
+  ppc::test::TestTask<int32_t> testTask(taskData);
+  ASSERT_EQ(testTask.validation(), true);
+  testTask.pre_processing();
+  testTask.run();
+  testTask.post_processing();
+  ASSERT_EQ(static_cast<size_t>(out[0]), in.size());
+}
+
+TEST(task_tests, check_strided_view) {
+  // 3x4 matrix, view of its 3x2 left part and of its transpose
+  std::vector<double> matrix = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(matrix.data(), {3, 2}, {4, 1});
+  taskData->add_input(matrix.data(), {4, 3}, {1, 4});
+  taskData->add_input(matrix.data(), {3, 4});
+
+  EXPECT_FALSE(taskData->input(0).is_contiguous());
+  EXPECT_ANY_THROW(static_cast<void>(taskData->input_span<double>(0)));
+  EXPECT_EQ(taskData->input(0).to_vector<double>(), std::vector<double>({0, 1, 4, 5, 8, 9}));
+  EXPECT_EQ(taskData->input(1).to_vector<double>(), std::vector<double>({0, 4, 8, 1, 5, 9, 2, 6, 10, 3, 7, 11}));
+  EXPECT_TRUE(taskData->input(2).is_contiguous());
+  EXPECT_EQ(taskData->input(2).size(), matrix.size());
+  EXPECT_ANY_THROW(taskData->add_input(matrix.data(), {3, 4}, {1}));
+}
+
+TEST(task_tests, check_raw_input_has_untyped_view) {
+  std::vector<float> in(20, 1);
+  std::vector<float> typed(5, 2);
+
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->add_input(typed);
+
+  EXPECT_EQ(taskData->input(0).dtype, ppc::core::DataType::UNKNOWN);
+  EXPECT_EQ(taskData->input_span<float>(0).size(), in.size());
+  EXPECT_EQ(taskData->input(1).dtype, ppc::core::DataType::FLOAT32);
+  EXPECT_EQ(taskData->input_span<float>(1).data(), typed.data());
+}
+
+TEST(task_tests, check_phase_profile) {
+  // Create data
+  std::vector<int32_t> in(20, 1);
+  std::vector<int32_t> out(1, 0);
+
+  // Create TaskData
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->add_input(in);
+  taskData->add_output(out);
+
+  // Create Task
+  ppc::test::TestTask<int32_t> testTask(taskData);
+  ASSERT_EQ(testTask.validation(), true);
+  testTask.pre_processing();
+  testTask.run();
+  testTask.post_processing();
+
+  // post_processing stays open until end_phase() or the next phase
+  const auto &profile = testTask.get_phase_profile();
+  EXPECT_EQ(profile.phases[3].calls, 0U);
+  testTask.end_phase();
+  for (size_t i = 0; i < profile.phases.size(); i++) {
+    EXPECT_EQ(profile.phases[i].calls, 1U);
+    EXPECT_LE(profile.phases[i].entry, profile.phases[i].exit);
+    if (i > 0) {
+      EXPECT_LE(profile.phases[i - 1].exit, profile.phases[i].entry);
+    }
+  }
+  EXPECT_GE(profile.total_time_sec(), 0.0);
+
+  testTask.reset_phase_profile();
+  EXPECT_EQ(profile.phases[0].calls, 0U);
+}
+
+TEST(task_tests, check_pipeline_executor) {
+  // Create data, item i sums i ones, item 7 has a wrong output
+  const size_t count = 50;
+  std::vector<std::vector<int32_t>> in(count);
+  std::vector<std::vector<int32_t>> out(count, std::vector<int32_t>(1, -1));
+  out[7].resize(2);
+
+  // Create TaskData for every item
+  std::vector<std::shared_ptr<ppc::core::TaskData>> items;
+  for (size_t i = 0; i < count; i++) {
+    in[i].assign(i, 1);
+    auto taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in[i].data()));
+    taskData->inputs_count.emplace_back(in[i].size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out[i].data()));
+    taskData->outputs_count.emplace_back(out[i].size());
+    items.push_back(taskData);
+  }
+
+  ppc::core::PipelineExecutor executor(
+      [](std::shared_ptr<ppc::core::TaskData> taskData) {
+        return std::make_shared<ppc::test::TestTask<int32_t>>(taskData);
+      },
+      1);
+  auto results = executor.run(items);
+
+  ASSERT_EQ(results.size(), count);
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(results[i], i != 7);
+    EXPECT_EQ(out[i][0], i != 7 ? static_cast<int32_t>(i) : -1);
+  }
+}
+
+TEST(task_tests, check_pipeline_executor_rethrows) {
+  std::vector<int32_t> in(10, 1);
+  std::vector<std::vector<int32_t>> out(20, std::vector<int32_t>(1, 0));
+  std::vector<std::shared_ptr<ppc::core::TaskData>> items;
+  for (size_t i = 0; i < out.size(); i++) {
+    auto taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskData->inputs_count.emplace_back(in.size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out[i].data()));
+    taskData->outputs_count.emplace_back(out[i].size());
+    items.push_back(taskData);
+  }
+
+  size_t created = 0;
+  ppc::core::PipelineExecutor executor([&](std::shared_ptr<ppc::core::TaskData> taskData) {
+    if (++created == 5) throw std::runtime_error("can't create task");
+    return std::make_shared<ppc::test::TestTask<int32_t>>(taskData);
+  });
+  EXPECT_THROW(executor.run(items), std::runtime_error);
+  EXPECT_ANY_THROW(ppc::core::PipelineExecutor(nullptr));
+}
+
+TEST(task_tests, check_batch) {
+  std::vector<int32_t> data(100, 1);
+  std::vector<uint64_t> offsets = {0, 10, 10, 100};
+  ppc::core::Batch<int32_t> batch(data, offsets);
+  EXPECT_EQ(batch.size(), 3U);
+  EXPECT_EQ(batch.total_size(), 100U);
+  EXPECT_EQ(batch[1].size(), 0U);
+  EXPECT_EQ(batch[2].size(), 90U);
+
+  std::vector<uint64_t> decreasing = {0, 10, 5};
+  std::vector<uint64_t> out_of_data = {0, 101};
+  EXPECT_THROW(ppc::core::Batch<int32_t>(data, std::vector<uint64_t>()), std::invalid_argument);
+  EXPECT_THROW(ppc::core::Batch<int32_t>(data, decreasing), std::invalid_argument);
+  EXPECT_THROW(ppc::core::Batch<int32_t>(data, out_of_data), std::invalid_argument);
+}
+
+TEST(task_tests, check_parallel_for_batch) {
+  // Every index is visited exactly once on the parallel path
+  std::vector<int32_t> visited(1000, 0);
+  ppc::core::parallel_for_batch(
+      visited.size(), 100 * ppc::core::MIN_BATCH_WORK,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) visited[i]++;
+      },
+      4);
+  EXPECT_EQ(std::count(visited.begin(), visited.end(), 1), 1000);
+
+  EXPECT_THROW(ppc::core::parallel_for_batch(
+                   visited.size(), 100 * ppc::core::MIN_BATCH_WORK,
+                   [&](size_t begin, size_t) {
+                     if (begin > 0) throw std::runtime_error("can't process range");
+                   },
+                   4),
+               std::runtime_error);
+}
+
+TEST(task_tests, check_parallel_for_batch_reuses_threads) {
+  // Repeated batches run on the workers of the shared pool, not on threads of their own
+  // (ids of joined threads may be reused, a thread_local flag is fresh on every new thread)
+  auto &pool = ppc::core::ThreadPool::shared();
+  std::atomic<uint64_t> threads{0};
+  for (int run = 0; run < 3; run++) {
+    ppc::core::parallel_for_batch(
+        64, 100 * ppc::core::MIN_BATCH_WORK,
+        [&](size_t, size_t) {
+          thread_local bool seen = false;
+          if (!seen) threads++;
+          seen = true;
+        },
+        4);
+  }
+  EXPECT_LE(threads.load(), pool.size() + 1);
+}
+
+TEST(task_tests, check_task_on_every_backend) {
+  // Create data
+  std::vector<int32_t> in(1000, 1);
+
+  for (auto backend : ppc::core::available_backends()) {
+    std::vector<int32_t> out(1, 0);
+    std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskData->inputs_count.emplace_back(in.size());
+    taskData->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+    taskData->outputs_count.emplace_back(out.size());
+
+    ppc::test::TestTaskPolicy<int32_t> testTask(taskData, {backend, 4});
+    ASSERT_EQ(testTask.validation(), true);
+    testTask.pre_processing();
+    testTask.run();
+    testTask.post_processing();
+    EXPECT_EQ(static_cast<size_t>(out[0]), in.size()) << ppc::core::to_string(backend);
+  }
+}
+
+TEST(task_tests, check_execution_primitives) {
+  std::vector<double> in(1001);
+  for (size_t i = 0; i < in.size(); i++) {
+    in[i] = 1.0 / static_cast<double>(i + 1);
+  }
+  std::vector<double> expected_scan(in.size());
+  std::partial_sum(in.begin(), in.end(), expected_scan.begin());
+
+  // With the same count of threads every backend reduces in the same order
+  const ppc::core::ExecutionPolicy reference{ppc::core::Backend::STL, 3};
+  const double expected_sum = ppc::core::parallel_reduce(
+      reference, in.size(), 0.0, [&](uint64_t i) { return in[i]; }, std::plus<>());
+  for (auto backend : ppc::core::available_backends()) {
+    const ppc::core::ExecutionPolicy policy{backend, 3};
+    std::vector<int32_t> visited(in.size(), 0);
+    ppc::core::parallel_for(policy, visited.size(), [&](uint64_t i) { visited[i]++; });
+    EXPECT_EQ(std::count(visited.begin(), visited.end(), 1), 1001);
+
+    const double sum = ppc::core::parallel_reduce(
+        policy, in.size(), 0.0, [&](uint64_t i) { return in[i]; }, std::plus<>());
+    if (backend != ppc::core::Backend::SEQ) {
+      EXPECT_EQ(sum, expected_sum);
+    }
+    EXPECT_NEAR(sum, expected_scan.back(), 1e-12);
+
+    std::vector<double> scan(in.size());
+    ppc::core::parallel_scan<double>(policy, in, scan, 0.0, std::plus<>());
+    for (size_t i = 0; i < in.size(); i++) {
+      ASSERT_NEAR(scan[i], expected_scan[i], 1e-12);
+    }
+
+    auto fail_at_7 = [](uint64_t i) {
+      if (i == 7) throw std::runtime_error("can't process 7");
+    };
+    EXPECT_THROW(ppc::core::parallel_for(policy, 10, fail_at_7), std::runtime_error);
+  }
+
+  EXPECT_EQ(ppc::core::backend_from_string("stl"), ppc::core::Backend::STL);
+  EXPECT_THROW(ppc::core::backend_from_string("cuda"), std::invalid_argument);
+}
+
+TEST(task_tests, check_thread_pool) {
+  ppc::core::ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4U);
+
+  // Jobs submit jobs to their own deques and wait for them, idle workers steal them
+  std::function<uint64_t(uint64_t, uint64_t)> sum = [&](uint64_t begin, uint64_t end) -> uint64_t {
+    if (end - begin <= 16) {
+      uint64_t res = 0;
+      for (uint64_t i = begin; i < end; i++) res += i;
+      return res;
+    }
+    const uint64_t middle = (begin + end) / 2;
+    auto left = pool.submit([&, begin, middle] { return sum(begin, middle); });
+    const uint64_t right = sum(middle, end);
+    return pool.wait(left) + right;
+  };
+  auto total = pool.submit([&] { return sum(0, 10000); });
+  EXPECT_EQ(pool.wait(total), 10000U * 9999U / 2);
+
+  std::vector<int32_t> visited(1000, 0);
+  pool.for_each(visited.size(), [&](uint64_t i) { visited[i]++; });
+  EXPECT_EQ(std::count(visited.begin(), visited.end(), 1), 1000);
+
+  auto failed = pool.submit([]() -> int32_t { throw std::runtime_error("can't run job"); });
+  EXPECT_THROW(failed.get(), std::runtime_error);
+  EXPECT_THROW(pool.for_each(10, [](uint64_t i) {
+    if (i == 7) throw std::runtime_error("can't run job 7");
+  }),
+               std::runtime_error);
+}
+
+#ifdef __linux__
+TEST(task_tests, check_thread_pool_wait_sleeps) {
+  ppc::core::ThreadPool pool(1);
+  const auto cpu_time = [] {
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+  };
+  // the worker takes the job and sleeps, the waiting thread has nothing to run and must not spin
+  std::promise<void> started;
+  auto slow = pool.submit([&] {
+    started.set_value();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  });
+  started.get_future().wait();
+  auto start = cpu_time();
+  pool.wait(slow);
+  EXPECT_LT(cpu_time() - start, std::chrono::milliseconds(100));
+
+  std::promise<void> second_started;
+  auto second = second_started.get_future();
+  start = cpu_time();
+  pool.for_each(2, [&](uint64_t i) {
+    if (i == 0) {
+      second.wait();
+    } else {
+      second_started.set_value();
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+  });
+  EXPECT_LT(cpu_time() - start, std::chrono::milliseconds(100));
+}
+#endif
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -5,9 +5,11 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
 #include <memory>
 #include <vector>
 
+#include "core/task/include/execution.hpp"
 #include "core/task/include/task.hpp"
 
 namespace ppc::test {
@@ -47,6 +49,44 @@ class TestTask : public ppc::core::Task {
   T *output_{};
 };
 
+// Same sum as TestTask written once against parallel_reduce, the backend is picked
+// by the policy
+template <class T>
+class TestTaskPolicy : public ppc::core::Task {
+ public:
+  TestTaskPolicy(std::shared_ptr<ppc::core::TaskData> taskData_, ppc::core::ExecutionPolicy policy_)
+      : Task(taskData_), policy(policy_) {}
+  bool pre_processing() override {
+    internal_order_test();
+    input_ = reinterpret_cast<T *>(taskData->inputs[0]);
+    output_ = reinterpret_cast<T *>(taskData->outputs[0]);
+    output_[0] = 0;
+    return true;
+  }
+
+  bool validation() override {
+    internal_order_test();
+    return taskData->outputs_count[0] == 1;
+  }
+
+  bool run() override {
+    internal_order_test();
+    output_[0] = ppc::core::parallel_reduce(
+        policy, taskData->inputs_count[0], T(0), [&](uint64_t i) { return input_[i]; }, std::plus<T>());
+    return true;
+  }
+
+  bool post_processing() override {
+    internal_order_test();
+    return true;
+  }
+
+ private:
+  ppc::core::ExecutionPolicy policy;
+  T *input_{};
+  T *output_{};
+};
+
 }  // namespace ppc::test
 
 #endif  // MODULES_CORE_TESTS_TEST_TASK_HPP_
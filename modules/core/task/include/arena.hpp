@@ -0,0 +1,87 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_ARENA_HPP_
+#define MODULES_CORE_INCLUDE_ARENA_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace ppc::core {
+
+struct ArenaStats {
+  // calls of allocate() and the bytes they asked for
+  uint64_t allocations = 0;
+  uint64_t allocated_bytes = 0;
+  // blocks taken from the upstream resource, the only heap allocations of the arena
+  uint64_t upstream_allocations = 0;
+  uint64_t upstream_bytes = 0;
+  // the most bytes in use at once, alignment padding included
+  uint64_t peak_bytes = 0;
+};
+
+// Bump allocator for scratch buffers with a std::pmr interface, e.g.
+// std::pmr::vector<int> buffer(n, &arena). Freeing memory does nothing; it is given
+// back all at once by reset() or rewind() and the blocks are kept for the next
+// allocations, so code that repeats the same allocations after a reset runs without
+// heap allocations. Not thread-safe.
+class Arena : public std::pmr::memory_resource {
+ public:
+  // position of the arena, allocations after it are dropped by rewind()
+  struct Mark {
+    size_t block = 0;
+    size_t offset = 0;
+  };
+
+  static constexpr size_t DEFAULT_BLOCK_SIZE = size_t(1) << 16;
+
+  // block_size is the size of the first block, later blocks grow geometrically
+  explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE,
+                 std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  ~Arena() override;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  [[nodiscard]] Mark mark() const { return {current, offset}; }
+  // drop the allocations made after mark; throws std::invalid_argument for a mark ahead
+  // of the current position
+  void rewind(Mark mark);
+  // drop all allocations and keep the blocks
+  void reset() { rewind({}); }
+  // drop all allocations and give the blocks back to upstream
+  void release();
+
+  [[nodiscard]] const ArenaStats& stats() const { return stats_; }
+  [[nodiscard]] size_t capacity() const;
+  [[nodiscard]] size_t used() const { return used_before + offset; }
+
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* /*data*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  struct Block {
+    std::byte* data;
+    size_t size;
+  };
+  // move to the next block, a new one is inserted when the kept one has less than bytes
+  void next_block(size_t bytes);
+
+  std::pmr::memory_resource* upstream;
+  size_t block_size;
+  std::vector<Block> blocks;
+  // block being filled and the bytes used in it
+  size_t current = 0;
+  size_t offset = 0;
+  // sizes of the blocks before current
+  size_t used_before = 0;
+  ArenaStats stats_;
+};
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_ARENA_HPP_
@@ -0,0 +1,46 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_BATCH_HPP_
+#define MODULES_CORE_INCLUDE_BATCH_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+
+namespace ppc::core {
+
+// Many small inputs laid out contiguously: input i is data[offsets[i], offsets[i + 1]),
+// so offsets has one entry more than there are inputs
+template <class T>
+struct Batch {
+  std::span<const T> data;
+  std::span<const uint64_t> offsets;
+
+  Batch(std::span<const T> data_, std::span<const uint64_t> offsets_) : data(data_), offsets(offsets_) {
+    if (offsets.empty()) throw std::invalid_argument("Batch: offsets need at least one entry");
+    for (size_t i = 1; i < offsets.size(); i++) {
+      if (offsets[i] < offsets[i - 1]) throw std::invalid_argument("Batch: offsets must not decrease");
+    }
+    if (offsets.back() > data.size()) throw std::invalid_argument("Batch: offsets are out of data");
+  }
+
+  // count of inputs
+  [[nodiscard]] size_t size() const { return offsets.size() - 1; }
+  // count of elements of all inputs
+  [[nodiscard]] uint64_t total_size() const { return offsets.back() - offsets.front(); }
+  std::span<const T> operator[](size_t i) const { return data.subspan(offsets[i], offsets[i + 1] - offsets[i]); }
+};
+
+// Call body(begin, end) on contiguous ranges of [0, count) in parallel, as jobs of
+// ThreadPool::shared(). Ranges get at least MIN_BATCH_WORK elements of total_work each,
+// so small batches stay on the calling thread; num_threads = 0 means hardware_concurrency.
+// The parallelism is over inputs only: each input is still processed on its own, by
+// whatever kernel body calls for it.
+constexpr const static uint64_t MIN_BATCH_WORK = 1 << 15;
+void parallel_for_batch(size_t count, uint64_t total_work, const std::function<void(size_t, size_t)>& body,
+                        size_t num_threads = 0);
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_BATCH_HPP_
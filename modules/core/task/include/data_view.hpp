@@ -0,0 +1,96 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_DATA_VIEW_HPP_
+#define MODULES_CORE_INCLUDE_DATA_VIEW_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ppc::core {
+
+enum class DataType { UNKNOWN, INT8, UINT8, INT16, UINT16, INT32, UINT32, INT64, UINT64, FLOAT32, FLOAT64 };
+
+template <class T>
+constexpr DataType data_type_of() {
+  using U = std::remove_cv_t<T>;
+  if constexpr (std::is_same_v<U, int8_t>) return DataType::INT8;
+  if constexpr (std::is_same_v<U, uint8_t>) return DataType::UINT8;
+  if constexpr (std::is_same_v<U, int16_t>) return DataType::INT16;
+  if constexpr (std::is_same_v<U, uint16_t>) return DataType::UINT16;
+  if constexpr (std::is_same_v<U, int32_t>) return DataType::INT32;
+  if constexpr (std::is_same_v<U, uint32_t>) return DataType::UINT32;
+  if constexpr (std::is_same_v<U, int64_t>) return DataType::INT64;
+  if constexpr (std::is_same_v<U, uint64_t>) return DataType::UINT64;
+  if constexpr (std::is_same_v<U, float>) return DataType::FLOAT32;
+  if constexpr (std::is_same_v<U, double>) return DataType::FLOAT64;
+  return DataType::UNKNOWN;
+}
+
+// size of one element in bytes, 0 for UNKNOWN
+size_t data_type_size(DataType dtype);
+std::string data_type_name(DataType dtype);
+
+// Non-owning typed view of caller memory with shape and strides. Strides are
+// counted in elements; empty strides mean dense row-major layout.
+// UNKNOWN dtype views come from the legacy uint8_t* API and are not type-checked.
+struct DataView {
+  uint8_t *data = nullptr;
+  DataType dtype = DataType::UNKNOWN;
+  std::vector<uint64_t> shape;
+  std::vector<uint64_t> strides;
+
+  // count of elements
+  [[nodiscard]] uint64_t size() const;
+  [[nodiscard]] bool is_contiguous() const;
+
+  // Zero-copy access, only for contiguous views
+  template <class T>
+  [[nodiscard]] std::span<T> span() const {
+    check_type<T>();
+    if (!is_contiguous()) throw std::invalid_argument("DataView: span() of non-contiguous view, use to_vector()");
+    return std::span<T>(reinterpret_cast<T *>(data), size());
+  }
+
+  // Copy of the elements in row-major order, gathers strided views
+  template <class T>
+  [[nodiscard]] std::vector<std::remove_cv_t<T>> to_vector() const {
+    check_type<T>();
+    std::vector<std::remove_cv_t<T>> result(size());
+    const auto *ptr = reinterpret_cast<const std::remove_cv_t<T> *>(data);
+    if (is_contiguous()) {
+      std::copy(ptr, ptr + result.size(), result.begin());
+      return result;
+    }
+    std::vector<uint64_t> index(shape.size(), 0);
+    for (auto &value : result) {
+      uint64_t offset = 0;
+      for (size_t d = 0; d < shape.size(); d++) {
+        offset += index[d] * strides[d];
+      }
+      value = ptr[offset];
+      for (size_t d = shape.size(); d-- > 0;) {
+        if (++index[d] < shape[d]) break;
+        index[d] = 0;
+      }
+    }
+    return result;
+  }
+
+ private:
+  template <class T>
+  void check_type() const {
+    if (dtype != DataType::UNKNOWN && dtype != data_type_of<T>()) {
+      throw std::invalid_argument("DataView: requested " + data_type_name(data_type_of<T>()) + ", stored " +
+                                  data_type_name(dtype));
+    }
+  }
+};
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_DATA_VIEW_HPP_
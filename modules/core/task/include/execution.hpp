@@ -0,0 +1,144 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_EXECUTION_HPP_
+#define MODULES_CORE_INCLUDE_EXECUTION_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/numa/include/numa.hpp"
+
+namespace ppc::core {
+
+// Parallel primitives a task can be written against once and run on any backend.
+// The parallel backends run in src/execution.cpp, so they are the same for every
+// target linked with core_module_lib: OMP where it is compiled with OpenMP, TBB where
+// it is built with USE_TBB (PPC_EXECUTION_TBB), SEQ and STL (std::thread, on the shared
+// ThreadPool) everywhere.
+enum class Backend { SEQ, OMP, TBB, STL };
+
+struct ExecutionPolicy {
+  Backend backend = Backend::SEQ;
+  // 0 means hardware_concurrency; SEQ always uses one thread
+  uint64_t num_threads = 0;
+  // cores of the OMP and TBB workers; the calling thread is never pinned
+  ThreadPinning pinning = numa_config().pinning;
+};
+
+bool is_available(Backend backend);
+
+inline std::vector<Backend> available_backends() {
+  std::vector<Backend> backends;
+  for (auto backend : {Backend::SEQ, Backend::OMP, Backend::TBB, Backend::STL}) {
+    if (is_available(backend)) backends.push_back(backend);
+  }
+  return backends;
+}
+
+// "seq", "omp", "tbb" or "stl"
+std::string to_string(Backend backend);
+Backend backend_from_string(const std::string& name);
+
+// Policy given by the PPC_BACKEND and PPC_NUM_THREADS environment variables, SEQ with
+// the default count of threads when they are not set. Throws if the backend is unknown
+// or not compiled in.
+ExecutionPolicy policy_from_env();
+
+namespace detail {
+
+inline uint64_t num_chunks(const ExecutionPolicy& policy, uint64_t count) {
+  if (!is_available(policy.backend)) {
+    throw std::invalid_argument("ExecutionPolicy: backend " + to_string(policy.backend) + " is not compiled in");
+  }
+  if (policy.backend == Backend::SEQ) return std::min<uint64_t>(count, 1);
+  uint64_t num_threads = policy.num_threads;
+  if (num_threads == 0) num_threads = std::max(1U, std::thread::hardware_concurrency());
+  return std::min(num_threads, count);
+}
+
+// chunk(c) for every c in [0, num_chunks) on the parallel backend of the policy, one
+// chunk per thread; the first exception of a chunk is rethrown
+void run_chunks(const ExecutionPolicy& policy, uint64_t num_chunks, const std::function<void(uint64_t)>& chunk);
+
+// Call chunk(c) for every c in [0, num_chunks) on the backend of the policy
+template <class Chunk>
+void for_each_chunk(const ExecutionPolicy& policy, uint64_t num_chunks, const Chunk& chunk) {
+  if (num_chunks <= 1 || policy.backend == Backend::SEQ) {
+    for (uint64_t c = 0; c < num_chunks; c++) chunk(c);
+    return;
+  }
+  run_chunks(policy, num_chunks, chunk);
+}
+
+inline uint64_t chunk_begin(uint64_t count, uint64_t num_chunks, uint64_t c) { return count * c / num_chunks; }
+
+}  // namespace detail
+
+// body(i) for every i in [0, count)
+template <class Body>
+void parallel_for(const ExecutionPolicy& policy, uint64_t count, const Body& body) {
+  const uint64_t num_chunks = detail::num_chunks(policy, count);
+  detail::for_each_chunk(policy, num_chunks, [&](uint64_t c) {
+    const uint64_t end = detail::chunk_begin(count, num_chunks, c + 1);
+    for (uint64_t i = detail::chunk_begin(count, num_chunks, c); i < end; i++) body(i);
+  });
+}
+
+// reduce(...reduce(identity, map(0)), ..., map(count - 1)) with the order of reduce
+// fixed by the count of threads only, so every backend gives the same result for the
+// same num_threads even for floating point
+template <class T, class Map, class Reduce>
+T parallel_reduce(const ExecutionPolicy& policy, uint64_t count, T identity, const Map& map, const Reduce& reduce) {
+  const uint64_t num_chunks = detail::num_chunks(policy, count);
+  std::vector<T> partial(num_chunks, identity);
+  detail::for_each_chunk(policy, num_chunks, [&](uint64_t c) {
+    T acc = identity;
+    const uint64_t end = detail::chunk_begin(count, num_chunks, c + 1);
+    for (uint64_t i = detail::chunk_begin(count, num_chunks, c); i < end; i++) acc = reduce(acc, map(i));
+    partial[c] = acc;
+  });
+  T result = identity;
+  for (const auto& value : partial) result = reduce(result, value);
+  return result;
+}
+
+// Inclusive scan of in into out (they may be the same span): out[i] = in[0] op ... op in[i].
+// Every chunk is scanned on its own, then shifted by the total of the chunks before it.
+template <class T, class Op>
+void parallel_scan(const ExecutionPolicy& policy, std::span<const T> in, std::span<T> out, T identity,
+                   const Op& op) {
+  if (in.size() != out.size()) throw std::invalid_argument("parallel_scan: in and out differ in size");
+  const uint64_t count = in.size();
+  const uint64_t num_chunks = detail::num_chunks(policy, count);
+  std::vector<T> carry(num_chunks, identity);
+  detail::for_each_chunk(policy, num_chunks, [&](uint64_t c) {
+    T acc = identity;
+    const uint64_t end = detail::chunk_begin(count, num_chunks, c + 1);
+    for (uint64_t i = detail::chunk_begin(count, num_chunks, c); i < end; i++) {
+      acc = op(acc, in[i]);
+      out[i] = acc;
+    }
+    carry[c] = acc;
+  });
+  T acc = identity;
+  for (auto& value : carry) {
+    T total = op(acc, value);
+    value = acc;
+    acc = total;
+  }
+  detail::for_each_chunk(policy, num_chunks, [&](uint64_t c) {
+    if (c == 0) return;
+    const uint64_t end = detail::chunk_begin(count, num_chunks, c + 1);
+    for (uint64_t i = detail::chunk_begin(count, num_chunks, c); i < end; i++) out[i] = op(carry[c], out[i]);
+  });
+}
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_EXECUTION_HPP_
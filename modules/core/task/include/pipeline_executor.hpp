@@ -0,0 +1,45 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_PIPELINE_EXECUTOR_HPP_
+#define MODULES_CORE_INCLUDE_PIPELINE_EXECUTOR_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "core/task/include/task.hpp"
+
+namespace ppc::core {
+
+// Runs a stream of independent TaskData through instances of one task type with the
+// phases of different instances overlapped: validation() and pre_processing() of item
+// N+1, run() of item N and post_processing() of item N-1 go on three threads at once.
+// Every item gets its own task instance, so a task's phases are never called
+// concurrently. Between the stages at most buffer_size items wait.
+class PipelineExecutor {
+ public:
+  using TaskFactory = std::function<std::shared_ptr<Task>(std::shared_ptr<TaskData>)>;
+
+  explicit PipelineExecutor(TaskFactory factory_, uint64_t buffer_size_ = 2);
+
+  // Process all items, result i is true if every phase of item i returned true
+  // (a failed validation skips the other phases of the item). An exception of any
+  // phase stops the pipeline and is rethrown here.
+  std::vector<bool> run(const std::vector<std::shared_ptr<TaskData>>& items);
+
+  // State of testing of the created tasks. The Task constructor resets it to FUNC, so
+  // the executor sets it again after factory; PERF drops the time limit of a functional
+  // test, which would count the time an item waits between the stages.
+  void set_state_of_testing(TaskData::StateOfTesting state) { state_of_testing = state; }
+  [[nodiscard]] TaskData::StateOfTesting get_state_of_testing() const { return state_of_testing; }
+
+ private:
+  TaskFactory factory;
+  uint64_t buffer_size;
+  TaskData::StateOfTesting state_of_testing = TaskData::StateOfTesting::FUNC;
+};
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_PIPELINE_EXECUTOR_HPP_
@@ -3,6 +3,7 @@
 #ifndef MODULES_CORE_INCLUDE_TASK_HPP_
 #define MODULES_CORE_INCLUDE_TASK_HPP_
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <iostream>
@@ -10,6 +11,9 @@
 #include <string>
 #include <vector>
 
+#include "core/task/include/arena.hpp"
+#include "core/task/include/data_view.hpp"
+
 namespace ppc::core {
 
 struct TaskData {
@@ -18,6 +22,90 @@ struct TaskData {
   std::vector<uint8_t *> outputs;
   std::vector<std::uint32_t> outputs_count;
   enum StateOfTesting { FUNC, PERF } state_of_testing;
+
+  // Typed views of the same buffers, filled by add_input()/add_output(). Index i
+  // matches inputs[i]/outputs[i]; buffers added through the raw vectors have no view.
+  std::vector<DataView> input_views;
+  std::vector<DataView> output_views;
+
+  // Register caller memory without copying. Shape is in elements (empty means
+  // one dimension of count elements), strides in elements (empty means dense).
+  // inputs_count/outputs_count get the element count saturated to 32 bits.
+  template <class T>
+  void add_input(T *data, std::vector<uint64_t> shape, std::vector<uint64_t> strides = {}) {
+    add_view(inputs, inputs_count, input_views, make_view(data, std::move(shape), std::move(strides)));
+  }
+  template <class T, class Allocator>
+  void add_input(std::vector<T, Allocator> &data) {
+    add_input(data.data(), {data.size()});
+  }
+  // Register a view made elsewhere, e.g. MappedDataset::view()
+  void add_input(DataView view) { add_view(inputs, inputs_count, input_views, std::move(view)); }
+  template <class T>
+  void add_output(T *data, std::vector<uint64_t> shape, std::vector<uint64_t> strides = {}) {
+    add_view(outputs, outputs_count, output_views, make_view(data, std::move(shape), std::move(strides)));
+  }
+  template <class T, class Allocator>
+  void add_output(std::vector<T, Allocator> &data) {
+    add_output(data.data(), {data.size()});
+  }
+
+  // View of the i-th buffer; for buffers without a typed view it is an untyped
+  // one-dimensional view of inputs_count[i] elements
+  [[nodiscard]] DataView input(size_t i) const;
+  [[nodiscard]] DataView output(size_t i) const;
+
+  // Same as input(i).span<T>() without copying the view, so they don't allocate
+  template <class T>
+  [[nodiscard]] std::span<const T> input_span(size_t i) const {
+    return get_span<const T>(inputs, inputs_count, input_views, i);
+  }
+  template <class T>
+  [[nodiscard]] std::span<T> output_span(size_t i) const {
+    return get_span<T>(outputs, outputs_count, output_views, i);
+  }
+
+ private:
+  template <class T>
+  static DataView make_view(T *data, std::vector<uint64_t> shape, std::vector<uint64_t> strides) {
+    return DataView{reinterpret_cast<uint8_t *>(const_cast<std::remove_cv_t<T> *>(data)), data_type_of<T>(),
+                    std::move(shape), std::move(strides)};
+  }
+  static void add_view(std::vector<uint8_t *> &buffers, std::vector<std::uint32_t> &counts,
+                       std::vector<DataView> &views, DataView view);
+  static bool has_view(const std::vector<uint8_t *> &buffers, const std::vector<DataView> &views, size_t i) {
+    return i < views.size() && views[i].data != nullptr && views[i].data == buffers[i];
+  }
+  template <class T>
+  static std::span<T> get_span(const std::vector<uint8_t *> &buffers, const std::vector<std::uint32_t> &counts,
+                               const std::vector<DataView> &views, size_t i) {
+    if (has_view(buffers, views, i)) return views[i].span<T>();
+    return std::span<T>(reinterpret_cast<T *>(buffers.at(i)), i < counts.size() ? counts[i] : 0);
+  }
+  static DataView get_view(const std::vector<uint8_t *> &buffers, const std::vector<std::uint32_t> &counts,
+                           const std::vector<DataView> &views, size_t i);
+};
+
+// Phases of the task in the order they have to be called, NONE for any other function
+enum class Phase { VALIDATION, PRE_PROCESSING, RUN, POST_PROCESSING, NONE };
+
+// Entry and exit timestamps of the task's phases, kept in FUNC and PERF modes
+struct PhaseProfile {
+  using Clock = std::chrono::high_resolution_clock;
+  struct PhaseTiming {
+    // timestamps of the last call
+    Clock::time_point entry;
+    Clock::time_point exit;
+    // count of finished calls and their summed time (in seconds)
+    uint64_t calls = 0;
+    double time_sec = 0.0;
+  };
+  constexpr const static std::array<const char *, 4> PHASES = {"validation", "pre_processing", "run",
+                                                               "post_processing"};
+  // indexed by Phase
+  std::array<PhaseTiming, 4> phases;
+
+  [[nodiscard]] double total_time_sec() const;
 };
 
 // Memory of inputs and outputs need to be initialized before create object of
@@ -44,17 +132,44 @@ class Task {
   // get input and output data
   [[nodiscard]] std::shared_ptr<TaskData> get_data() const;
 
+  // timestamps of the phases since set_data() or reset_phase_profile()
+  [[nodiscard]] const PhaseProfile &get_phase_profile() const;
+  void reset_phase_profile();
+
+  // mark exit of the current phase; without it a phase is closed on entry of the next one
+  void end_phase();
+
+  // scratch memory of the task, see scratch below
+  [[nodiscard]] const Arena &get_scratch() const;
+
   virtual ~Task();
 
  protected:
-  void internal_order_test(const std::string &str = __builtin_FUNCTION());
+  void internal_order_test(const char *str = __builtin_FUNCTION());
   std::shared_ptr<TaskData> taskData;
+  // Memory for temporaries of the phases, e.g. std::pmr::vector<int> buffer(n, &scratch).
+  // What validation() and pre_processing() allocate stays until validation() is called
+  // again, what run() allocates until the next run() or validation(). The blocks are kept,
+  // so repeated iterations with the same allocations don't touch the heap. Members holding
+  // scratch memory have to be assigned again in every iteration before they are used.
+  Arena scratch;
 
  private:
-  std::vector<std::string> functions_order;
-  std::vector<std::string> right_functions_order = {"validation", "pre_processing", "run", "post_processing"};
+  // Order of calls is checked by a state machine: count of checked calls and the
+  // last phase. The first wrong call is remembered and reported again on every
+  // following call, as the task can't get back into the right order.
+  uint64_t num_calls = 0;
+  Phase last_phase = Phase::NONE;
+  uint64_t wrong_call_number = 0;
+  const char *wrong_function = nullptr;
   const double max_test_time = 1.0;
-  std::chrono::high_resolution_clock::time_point tmp_time_point;
+  PhaseProfile phase_profile;
+  // phase that is entered and not exited yet
+  Phase open_phase = Phase::NONE;
+  // position of scratch after pre_processing(), every run() starts from it
+  Arena::Mark run_mark;
+  void reset_order();
+  void close_phase(PhaseProfile::Clock::time_point now);
 };
 
 }  // namespace ppc::core
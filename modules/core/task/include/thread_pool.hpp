@@ -0,0 +1,73 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_CORE_INCLUDE_THREAD_POOL_HPP_
+#define MODULES_CORE_INCLUDE_THREAD_POOL_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "core/numa/include/numa.hpp"
+
+namespace ppc::core {
+
+// Persistent pool of worker threads with work stealing. Every worker owns a deque: jobs
+// submitted from a worker go to the bottom of its own deque and are popped from there,
+// idle workers steal from the top of the other deques without locks. Jobs submitted from
+// other threads go through a shared queue. Idle workers sleep until a job arrives.
+class ThreadPool {
+ public:
+  // num_threads = 0 means hardware_concurrency; worker i runs on cpu_for_thread(i, pinning)
+  explicit ThreadPool(uint64_t num_threads = 0, ThreadPinning pinning = ThreadPinning::NONE);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // count of worker threads
+  [[nodiscard]] uint64_t size() const;
+
+  // Queue f() and return its result (or exception) as a future
+  template <class F>
+  std::future<std::invoke_result_t<F>> submit(F&& f) {
+    using R = std::invoke_result_t<F>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+    std::future<R> future = task->get_future();
+    push([task] { (*task)(); });
+    return future;
+  }
+
+  // Wait for the future running queued jobs on the calling thread meanwhile, so jobs can
+  // wait for the jobs they submitted without blocking a worker
+  template <class T>
+  T wait(std::future<T>& future) {
+    help_until([&] { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+    return future.get();
+  }
+
+  // Call body(i) for every i in [0, count), each as a job; the calling thread takes part.
+  // Rethrows the first exception of body after all calls are done.
+  void for_each(uint64_t count, const std::function<void(uint64_t)>& body);
+
+  // Run one queued job on the calling thread, false if there was none
+  bool run_pending();
+
+  // Pool of hardware_concurrency workers created on first use, pinned by PPC_PIN_THREADS
+  static ThreadPool& shared();
+
+ private:
+  struct Impl;
+  void push(std::function<void()> job);
+  // Run queued jobs until done(); when there are none, spin a little and then sleep until
+  // a job is queued or finishes
+  void help_until(const std::function<bool()>& done);
+
+  std::unique_ptr<Impl> impl;
+};
+
+}  // namespace ppc::core
+
+#endif  // MODULES_CORE_INCLUDE_THREAD_POOL_HPP_
@@ -0,0 +1,75 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/task/include/arena.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t BLOCK_ALIGNMENT = 64;
+
+}  // namespace
+
+ppc::core::Arena::Arena(size_t block_size_, std::pmr::memory_resource* upstream_)
+    : upstream(upstream_), block_size(std::max<size_t>(block_size_, BLOCK_ALIGNMENT)) {}
+
+ppc::core::Arena::~Arena() { release(); }
+
+void ppc::core::Arena::rewind(Mark mark) {
+  if (mark.block > current || (mark.block == current && mark.offset > offset)) {
+    throw std::invalid_argument("Arena: can't rewind to a mark ahead of the current position");
+  }
+  current = mark.block;
+  offset = mark.offset;
+  used_before = 0;
+  for (size_t i = 0; i < current; i++) used_before += blocks[i].size;
+}
+
+void ppc::core::Arena::release() {
+  for (const auto& block : blocks) upstream->deallocate(block.data, block.size, BLOCK_ALIGNMENT);
+  blocks.clear();
+  current = 0;
+  offset = 0;
+  used_before = 0;
+}
+
+size_t ppc::core::Arena::capacity() const {
+  return std::accumulate(blocks.begin(), blocks.end(), size_t(0),
+                         [](size_t sum, const Block& block) { return sum + block.size; });
+}
+
+void* ppc::core::Arena::do_allocate(size_t bytes, size_t alignment) {
+  // blocks are aligned to BLOCK_ALIGNMENT, stricter alignments may need padding up to alignment
+  const size_t needed = std::max<size_t>(bytes, 1) + (alignment > BLOCK_ALIGNMENT ? alignment : 0);
+  for (;;) {
+    if (current < blocks.size()) {
+      const auto& block = blocks[current];
+      const auto address = reinterpret_cast<uintptr_t>(block.data) + offset;
+      const size_t begin = offset + (alignment - address % alignment) % alignment;
+      if (begin <= block.size && bytes <= block.size - begin) {
+        offset = begin + bytes;
+        stats_.allocations++;
+        stats_.allocated_bytes += bytes;
+        stats_.peak_bytes = std::max<uint64_t>(stats_.peak_bytes, used());
+        return block.data + begin;
+      }
+    }
+    next_block(needed);
+  }
+}
+
+void ppc::core::Arena::next_block(size_t bytes) {
+  const size_t next = blocks.empty() ? 0 : current + 1;
+  if (next == blocks.size() || blocks[next].size < bytes) {
+    // double the capacity, so a growing workload needs few blocks
+    const size_t size = std::max({bytes, block_size, capacity()});
+    auto* data = static_cast<std::byte*>(upstream->allocate(size, BLOCK_ALIGNMENT));
+    blocks.insert(blocks.begin() + static_cast<std::ptrdiff_t>(next), Block{data, size});
+    stats_.upstream_allocations++;
+    stats_.upstream_bytes += size;
+  }
+  if (next != current) used_before += blocks[current].size;
+  current = next;
+  offset = 0;
+}
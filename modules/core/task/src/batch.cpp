@@ -0,0 +1,23 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/task/include/batch.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "core/task/include/thread_pool.hpp"
+
+void ppc::core::parallel_for_batch(size_t count, uint64_t total_work, const std::function<void(size_t, size_t)>& body,
+                                   size_t num_threads) {
+  if (count == 0) return;
+  if (num_threads == 0) num_threads = std::max(1U, std::thread::hardware_concurrency());
+  num_threads = std::min<uint64_t>({num_threads, count, std::max<uint64_t>(total_work / MIN_BATCH_WORK, 1)});
+  if (num_threads == 1) {
+    body(0, count);
+    return;
+  }
+
+  // chunks run as jobs of the shared pool, so a batch starts no threads of its own
+  ThreadPool::shared().for_each(num_threads, [&](uint64_t t) {
+    body(count * t / num_threads, count * (t + 1) / num_threads);
+  });
+}
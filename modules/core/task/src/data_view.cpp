@@ -0,0 +1,69 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/task/include/data_view.hpp"
+
+size_t ppc::core::data_type_size(DataType dtype) {
+  switch (dtype) {
+    case DataType::INT8:
+    case DataType::UINT8:
+      return 1;
+    case DataType::INT16:
+    case DataType::UINT16:
+      return 2;
+    case DataType::INT32:
+    case DataType::UINT32:
+    case DataType::FLOAT32:
+      return 4;
+    case DataType::INT64:
+    case DataType::UINT64:
+    case DataType::FLOAT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+std::string ppc::core::data_type_name(DataType dtype) {
+  switch (dtype) {
+    case DataType::INT8:
+      return "int8";
+    case DataType::UINT8:
+      return "uint8";
+    case DataType::INT16:
+      return "int16";
+    case DataType::UINT16:
+      return "uint16";
+    case DataType::INT32:
+      return "int32";
+    case DataType::UINT32:
+      return "uint32";
+    case DataType::INT64:
+      return "int64";
+    case DataType::UINT64:
+      return "uint64";
+    case DataType::FLOAT32:
+      return "float32";
+    case DataType::FLOAT64:
+      return "float64";
+    default:
+      return "unknown";
+  }
+}
+
+uint64_t ppc::core::DataView::size() const {
+  if (shape.empty()) return 0;
+  uint64_t count = 1;
+  for (auto extent : shape) {
+    count *= extent;
+  }
+  return count;
+}
+
+bool ppc::core::DataView::is_contiguous() const {
+  if (strides.empty()) return true;
+  uint64_t expected = 1;
+  for (size_t d = shape.size(); d-- > 0;) {
+    if (shape[d] != 1 && strides[d] != expected) return false;
+    expected *= shape[d];
+  }
+  return true;
+}
@@ -0,0 +1,123 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/task/include/execution.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// defined for core_module_lib when the project is built with USE_TBB
+#ifdef PPC_EXECUTION_TBB
+#include <tbb/tbb.h>
+#endif
+
+#include "core/task/include/thread_pool.hpp"
+
+bool ppc::core::is_available(Backend backend) {
+  switch (backend) {
+    case Backend::SEQ:
+    case Backend::STL:
+      return true;
+    case Backend::OMP:
+#ifdef _OPENMP
+      return true;
+#else
+      return false;
+#endif
+    case Backend::TBB:
+#ifdef PPC_EXECUTION_TBB
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+std::string ppc::core::to_string(Backend backend) {
+  switch (backend) {
+    case Backend::SEQ:
+      return "seq";
+    case Backend::OMP:
+      return "omp";
+    case Backend::TBB:
+      return "tbb";
+    case Backend::STL:
+      return "stl";
+  }
+  return "unknown";
+}
+
+ppc::core::Backend ppc::core::backend_from_string(const std::string& name) {
+  for (auto backend : {Backend::SEQ, Backend::OMP, Backend::TBB, Backend::STL}) {
+    if (to_string(backend) == name) return backend;
+  }
+  throw std::invalid_argument("Unknown execution backend: " + name);
+}
+
+ppc::core::ExecutionPolicy ppc::core::policy_from_env() {
+  ExecutionPolicy policy;
+  if (const char* backend = std::getenv("PPC_BACKEND")) {
+    policy.backend = backend_from_string(backend);
+    if (!is_available(policy.backend)) {
+      throw std::invalid_argument("Execution backend " + std::string(backend) + " is not compiled in");
+    }
+  }
+  if (const char* num_threads = std::getenv("PPC_NUM_THREADS")) {
+    policy.num_threads = std::stoull(num_threads);
+  }
+  return policy;
+}
+
+void ppc::core::detail::run_chunks(const ExecutionPolicy& policy, uint64_t num_chunks,
+                                   const std::function<void(uint64_t)>& chunk) {
+  // the calling thread runs chunks of the OMP and TBB regions too, but pinning it would
+  // bind it, and every thread it starts afterwards, to one core for good
+  const auto caller = std::this_thread::get_id();
+  [[maybe_unused]] const auto pin_worker = [&](uint64_t index) {
+    if (std::this_thread::get_id() != caller) pin_current_thread_once(index, policy.pinning);
+  };
+  switch (policy.backend) {
+    case Backend::OMP: {
+#ifdef _OPENMP
+      // exceptions must not leave an OpenMP region
+      std::vector<std::exception_ptr> errors(num_chunks);
+      const auto count = static_cast<int64_t>(num_chunks);
+#pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(num_chunks))
+      for (int64_t c = 0; c < count; c++) {
+        try {
+          pin_worker(static_cast<uint64_t>(omp_get_thread_num()));
+          chunk(static_cast<uint64_t>(c));
+        } catch (...) {
+          errors[c] = std::current_exception();
+        }
+      }
+      for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+      }
+#endif
+      break;
+    }
+    case Backend::TBB: {
+#ifdef PPC_EXECUTION_TBB
+      // an arena of its own holds the work to num_chunks threads, as num_threads does
+      // for the other backends
+      tbb::task_arena arena(static_cast<int>(num_chunks));
+      arena.execute([&] {
+        tbb::parallel_for(uint64_t(0), num_chunks, [&](uint64_t c) {
+          pin_worker(static_cast<uint64_t>(tbb::this_task_arena::current_thread_index()));
+          chunk(c);
+        });
+      });
+#endif
+      break;
+    }
+    default:
+      ThreadPool::shared().for_each(num_chunks, chunk);
+  }
+}
@@ -0,0 +1,131 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/task/include/pipeline_executor.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace {
+
+struct Item {
+  size_t index = 0;
+  std::shared_ptr<ppc::core::Task> task;
+  bool ok = false;
+};
+
+// Blocking queue of at most capacity items; after close() push() fails and pop()
+// fails once the queue is empty
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(uint64_t capacity_) : capacity(capacity_) {}
+
+  bool push(Item item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_full.wait(lock, [&] { return closed || items.size() < capacity; });
+    if (closed) return false;
+    items.push_back(std::move(item));
+    not_empty.notify_one();
+    return true;
+  }
+
+  bool pop(Item& item) {
+    std::unique_lock<std::mutex> lock(mutex);
+    not_empty.wait(lock, [&] { return closed || !items.empty(); });
+    if (items.empty()) return false;
+    item = std::move(items.front());
+    items.pop_front();
+    not_full.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    not_full.notify_all();
+    not_empty.notify_all();
+  }
+
+ private:
+  uint64_t capacity;
+  bool closed = false;
+  std::deque<Item> items;
+  std::mutex mutex;
+  std::condition_variable not_full;
+  std::condition_variable not_empty;
+};
+
+}  // namespace
+
+ppc::core::PipelineExecutor::PipelineExecutor(TaskFactory factory_, uint64_t buffer_size_)
+    : factory(std::move(factory_)), buffer_size(buffer_size_) {
+  if (!factory) throw std::invalid_argument("PipelineExecutor: task factory is not set");
+  if (buffer_size == 0) throw std::invalid_argument("PipelineExecutor: buffer size must be positive");
+}
+
+std::vector<bool> ppc::core::PipelineExecutor::run(const std::vector<std::shared_ptr<TaskData>>& items) {
+  std::vector<char> results(items.size(), 0);
+  BoundedQueue to_run(buffer_size);
+  BoundedQueue to_write(buffer_size);
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto fail = [&](std::exception_ptr exception) {
+    {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::move(exception);
+    }
+    to_run.close();
+    to_write.close();
+  };
+
+  std::thread runner([&] {
+    try {
+      Item item;
+      while (to_run.pop(item)) {
+        if (item.ok) item.ok = item.task->run();
+        if (!to_write.push(std::move(item))) break;
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+    to_write.close();
+  });
+
+  std::thread writer([&] {
+    try {
+      Item item;
+      while (to_write.pop(item)) {
+        if (item.ok) item.ok = item.task->post_processing();
+        results[item.index] = item.ok ? 1 : 0;
+        // release the task and its buffers as soon as the item is written out
+        item.task.reset();
+      }
+    } catch (...) {
+      fail(std::current_exception());
+    }
+  });
+
+  try {
+    for (size_t i = 0; i < items.size(); i++) {
+      Item item;
+      item.index = i;
+      item.task = factory(items[i]);
+      item.task->get_data()->state_of_testing = state_of_testing;
+      item.ok = item.task->validation();
+      if (item.ok) item.ok = item.task->pre_processing();
+      if (!to_run.push(std::move(item))) break;
+    }
+  } catch (...) {
+    fail(std::current_exception());
+  }
+  to_run.close();
+  runner.join();
+  writer.join();
+
+  if (error) std::rethrow_exception(error);
+  return {results.begin(), results.end()};
+}
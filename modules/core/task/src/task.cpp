@@ -3,39 +3,139 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <utility>
 
+void ppc::core::TaskData::add_view(std::vector<uint8_t *> &buffers, std::vector<std::uint32_t> &counts,
+                                   std::vector<DataView> &views, DataView view) {
+  if (view.shape.empty()) throw std::invalid_argument("TaskData: shape of a buffer can't be empty");
+  if (!view.strides.empty() && view.strides.size() != view.shape.size()) {
+    throw std::invalid_argument("TaskData: strides and shape have different dimensions");
+  }
+  // keep views aligned with buffers that were added through the raw vectors
+  views.resize(buffers.size());
+  auto count = std::min<uint64_t>(view.size(), std::numeric_limits<std::uint32_t>::max());
+  buffers.emplace_back(view.data);
+  counts.emplace_back(static_cast<std::uint32_t>(count));
+  views.emplace_back(std::move(view));
+}
+
+ppc::core::DataView ppc::core::TaskData::get_view(const std::vector<uint8_t *> &buffers,
+                                                  const std::vector<std::uint32_t> &counts,
+                                                  const std::vector<DataView> &views, size_t i) {
+  if (has_view(buffers, views, i)) return views[i];
+  DataView view;
+  view.data = buffers.at(i);
+  view.shape = {i < counts.size() ? counts[i] : 0};
+  return view;
+}
+
+ppc::core::DataView ppc::core::TaskData::input(size_t i) const {
+  return get_view(inputs, inputs_count, input_views, i);
+}
+
+ppc::core::DataView ppc::core::TaskData::output(size_t i) const {
+  return get_view(outputs, outputs_count, output_views, i);
+}
+
+double ppc::core::PhaseProfile::total_time_sec() const {
+  double total = 0.0;
+  for (const auto &phase : phases) {
+    total += phase.time_sec;
+  }
+  return total;
+}
+
 void ppc::core::Task::set_data(std::shared_ptr<TaskData> taskData_) {
   taskData_->state_of_testing = TaskData::StateOfTesting::FUNC;
-  functions_order.clear();
+  reset_order();
+  reset_phase_profile();
   taskData = std::move(taskData_);
 }
 
 std::shared_ptr<ppc::core::TaskData> ppc::core::Task::get_data() const { return taskData; }
 
+const ppc::core::PhaseProfile &ppc::core::Task::get_phase_profile() const { return phase_profile; }
+
+const ppc::core::Arena &ppc::core::Task::get_scratch() const { return scratch; }
+
+void ppc::core::Task::reset_phase_profile() {
+  phase_profile = PhaseProfile();
+  open_phase = Phase::NONE;
+}
+
+void ppc::core::Task::end_phase() { close_phase(PhaseProfile::Clock::now()); }
+
+void ppc::core::Task::reset_order() {
+  num_calls = 0;
+  last_phase = Phase::NONE;
+  wrong_call_number = 0;
+  wrong_function = nullptr;
+}
+
+void ppc::core::Task::close_phase(PhaseProfile::Clock::time_point now) {
+  if (open_phase == Phase::NONE) return;
+  auto &phase = phase_profile.phases[static_cast<size_t>(open_phase)];
+  phase.exit = now;
+  phase.calls++;
+  phase.time_sec += std::chrono::duration<double>(now - phase.entry).count();
+  open_phase = Phase::NONE;
+}
+
 ppc::core::Task::Task(std::shared_ptr<TaskData> taskData_) { set_data(std::move(taskData_)); }
 
-void ppc::core::Task::internal_order_test(const std::string& str) {
-  if (!functions_order.empty() && str == functions_order.back() && str == "run") return;
+void ppc::core::Task::internal_order_test(const char* str) {
+  auto now = PhaseProfile::Clock::now();
+  auto phase = Phase::NONE;
+  for (size_t i = 0; i < PhaseProfile::PHASES.size(); i++) {
+    if (std::strcmp(str, PhaseProfile::PHASES[i]) == 0) {
+      phase = static_cast<Phase>(i);
+      break;
+    }
+  }
+
+  close_phase(now);
+  if (phase != Phase::NONE) {
+    phase_profile.phases[static_cast<size_t>(phase)].entry = now;
+    open_phase = phase;
+  }
+
+  if (phase == Phase::VALIDATION) {
+    scratch.reset();
+  } else if (phase == Phase::RUN) {
+    // repeated runs drop the allocations of the previous one
+    if (last_phase == Phase::RUN) {
+      scratch.rewind(run_mark);
+    } else {
+      run_mark = scratch.mark();
+    }
+  }
 
-  functions_order.push_back(str);
+  if (phase == Phase::RUN && last_phase == Phase::RUN) return;
 
-  for (size_t i = 0; i < functions_order.size(); i++) {
-    if (functions_order[i] != right_functions_order[i % right_functions_order.size()]) {
-      throw std::invalid_argument("ORDER OF FUCTIONS IS NOT RIGHT: \n" + std::string("Serial number: ") +
-                                  std::to_string(i + 1) + "\n" + std::string("Yours function: ") + functions_order[i] +
-                                  "\n" + std::string("Expected function: ") + right_functions_order[i]);
+  if (wrong_call_number == 0) {
+    auto expected = static_cast<Phase>(num_calls % PhaseProfile::PHASES.size());
+    if (phase != expected) {
+      wrong_call_number = num_calls + 1;
+      wrong_function = str;
     }
   }
+  num_calls++;
+  last_phase = phase;
 
-  if (str == "pre_processing" && taskData->state_of_testing == TaskData::StateOfTesting::FUNC) {
-    tmp_time_point = std::chrono::high_resolution_clock::now();
+  if (wrong_call_number != 0) {
+    auto expected = PhaseProfile::PHASES[(wrong_call_number - 1) % PhaseProfile::PHASES.size()];
+    throw std::invalid_argument("ORDER OF FUCTIONS IS NOT RIGHT: \n" + std::string("Serial number: ") +
+                                std::to_string(wrong_call_number) + "\n" + std::string("Yours function: ") +
+                                wrong_function + "\n" + std::string("Expected function: ") + expected);
   }
 
-  if (str == "post_processing" && taskData->state_of_testing == TaskData::StateOfTesting::FUNC) {
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - tmp_time_point).count();
+  if (phase == Phase::POST_PROCESSING && taskData->state_of_testing == TaskData::StateOfTesting::FUNC) {
+    const auto &pre_processing = phase_profile.phases[static_cast<size_t>(Phase::PRE_PROCESSING)];
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - pre_processing.entry).count();
     auto current_time = static_cast<double>(duration) * 1e-9;
     if (current_time > max_test_time) {
       std::cerr << "Current test work more than " << max_test_time << " secs: " << current_time << std::endl;
@@ -44,4 +144,4 @@ void ppc::core::Task::internal_order_test(const std::string& str) {
   }
 }
 
-ppc::core::Task::~Task() { functions_order.clear(); }
+ppc::core::Task::~Task() = default;
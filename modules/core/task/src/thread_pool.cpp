@@ -0,0 +1,255 @@
+// Copyright 2024 Nesterov Alexander
+#include "core/task/include/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Job = std::function<void()>;
+
+// Chase-Lev deque: the owner pushes and pops at the bottom, thieves take from the top
+// with a compare-and-swap. Buffers replaced on growth are kept until the deque dies,
+// since a thief may still read from them.
+class StealingDeque {
+ public:
+  StealingDeque() { buffers.push_back(std::make_unique<Buffer>(64)); buffer.store(buffers.back().get()); }
+
+  // owner only
+  void push(Job* job) {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    if (b - t >= a->capacity) a = grow(a, t, b);
+    a->put(b, job);
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  // owner only
+  Job* pop() {
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_seq_cst);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Job* job = a->get(b);
+    if (t == b) {
+      // the last job, race the thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst)) job = nullptr;
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  // any thread
+  Job* steal() {
+    int64_t t = top.load(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_seq_cst);
+    if (t >= b) return nullptr;
+    Job* job = buffer.load(std::memory_order_acquire)->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst)) return nullptr;
+    return job;
+  }
+
+ private:
+  struct Buffer {
+    explicit Buffer(int64_t capacity_) : capacity(capacity_), jobs(capacity_) {}
+    Job* get(int64_t i) const { return jobs[i % capacity].load(std::memory_order_relaxed); }
+    void put(int64_t i, Job* job) { jobs[i % capacity].store(job, std::memory_order_relaxed); }
+
+    int64_t capacity;
+    std::vector<std::atomic<Job*>> jobs;
+  };
+
+  Buffer* grow(Buffer* a, int64_t t, int64_t b) {
+    buffers.push_back(std::make_unique<Buffer>(a->capacity * 2));
+    Buffer* grown = buffers.back().get();
+    for (int64_t i = t; i < b; i++) grown->put(i, a->get(i));
+    buffer.store(grown, std::memory_order_release);
+    return grown;
+  }
+
+  std::atomic<int64_t> top{0};
+  std::atomic<int64_t> bottom{0};
+  std::atomic<Buffer*> buffer;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+// index of the worker running on this thread in the pool it belongs to
+thread_local const void* current_pool = nullptr;
+thread_local uint64_t current_worker = 0;
+
+}  // namespace
+
+struct ppc::core::ThreadPool::Impl {
+  std::vector<std::unique_ptr<StealingDeque>> deques;
+  std::vector<std::thread> threads;
+
+  std::mutex injected_mutex;
+  std::deque<Job*> injected;
+
+  // jobs pushed and not yet taken, idle workers sleep while it is zero
+  std::atomic<int64_t> queued{0};
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stop = false;
+
+  // threads sleeping in help_until, woken on every push and every finished job
+  std::atomic<int64_t> helpers{0};
+  std::condition_variable progress;
+
+  // the fences pair with the one in help_until: a helper either sees the change done
+  // before the call or is counted in helpers
+  void notify_helpers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (helpers.load() == 0) return;
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    progress.notify_all();
+  }
+
+  // own deque first, then the shared queue, then steal from the other workers
+  Job* take(bool is_worker, uint64_t index) {
+    Job* job = nullptr;
+    if (is_worker) job = deques[index]->pop();
+    if (job == nullptr) {
+      std::lock_guard<std::mutex> lock(injected_mutex);
+      if (!injected.empty()) {
+        job = injected.front();
+        injected.pop_front();
+      }
+    }
+    for (uint64_t i = 1; job == nullptr && i <= deques.size(); i++) {
+      job = deques[(index + i) % deques.size()]->steal();
+    }
+    if (job != nullptr) queued.fetch_sub(1);
+    return job;
+  }
+
+  void run(Job* job) {
+    {
+      std::unique_ptr<Job> owned(job);
+      (*owned)();
+    }
+    notify_helpers();
+  }
+
+  void worker(uint64_t index) {
+    current_pool = this;
+    current_worker = index;
+    while (true) {
+      if (Job* job = take(true, index)) {
+        run(job);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex);
+      wake.wait(lock, [&] { return stop || queued.load() > 0; });
+      if (stop && queued.load() == 0) return;
+    }
+  }
+};
+
+ppc::core::ThreadPool::ThreadPool(uint64_t num_threads, ThreadPinning pinning) : impl(std::make_unique<Impl>()) {
+  if (num_threads == 0) num_threads = std::max(1U, std::thread::hardware_concurrency());
+  for (uint64_t i = 0; i < num_threads; i++) {
+    impl->deques.push_back(std::make_unique<StealingDeque>());
+  }
+  for (uint64_t i = 0; i < num_threads; i++) {
+    impl->threads.emplace_back([this, i, pinning] {
+      if (pinning != ThreadPinning::NONE) pin_current_thread(cpu_for_thread(i, pinning));
+      impl->worker(i);
+    });
+  }
+}
+
+ppc::core::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(impl->sleep_mutex);
+    impl->stop = true;
+  }
+  impl->wake.notify_all();
+  for (auto& thread : impl->threads) {
+    thread.join();
+  }
+}
+
+uint64_t ppc::core::ThreadPool::size() const { return impl->threads.size(); }
+
+void ppc::core::ThreadPool::push(std::function<void()> job) {
+  auto* owned = new Job(std::move(job));
+  if (current_pool == impl.get()) {
+    impl->deques[current_worker]->push(owned);
+  } else {
+    std::lock_guard<std::mutex> lock(impl->injected_mutex);
+    impl->injected.push_back(owned);
+  }
+  impl->queued.fetch_add(1);
+  // taking the lock orders the notification after a sleeper's check of queued
+  { std::lock_guard<std::mutex> lock(impl->sleep_mutex); }
+  impl->wake.notify_one();
+  impl->notify_helpers();
+}
+
+bool ppc::core::ThreadPool::run_pending() {
+  const bool is_worker = current_pool == impl.get();
+  Job* job = impl->take(is_worker, is_worker ? current_worker : 0);
+  if (job == nullptr) return false;
+  impl->run(job);
+  return true;
+}
+
+void ppc::core::ThreadPool::help_until(const std::function<bool()>& done) {
+  // rounds of yield before sleeping, short waits are cheaper to spin through
+  constexpr int SPINS = 64;
+  int spins = 0;
+  while (!done()) {
+    if (run_pending()) {
+      spins = 0;
+    } else if (spins < SPINS) {
+      spins++;
+      std::this_thread::yield();
+    } else {
+      std::unique_lock<std::mutex> lock(impl->sleep_mutex);
+      impl->helpers.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      impl->progress.wait(lock, [&] { return done() || impl->queued.load() > 0; });
+      impl->helpers.fetch_sub(1);
+      spins = 0;
+    }
+  }
+}
+
+void ppc::core::ThreadPool::for_each(uint64_t count, const std::function<void(uint64_t)>& body) {
+  if (count == 0) return;
+  std::vector<std::exception_ptr> errors(count);
+  std::atomic<uint64_t> remaining{count};
+  auto call = [&](uint64_t i) {
+    try {
+      body(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+    remaining.fetch_sub(1);
+  };
+  for (uint64_t i = 1; i < count; i++) {
+    push([&call, i] { call(i); });
+  }
+  call(0);
+  help_until([&] { return remaining.load() == 0; });
+  for (const auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+ppc::core::ThreadPool& ppc::core::ThreadPool::shared() {
+  static ThreadPool pool(0, numa_config().pinning);
+  return pool;
+}
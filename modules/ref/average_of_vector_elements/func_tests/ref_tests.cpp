@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
 #include "ref/average_of_vector_elements/include/ref_task.hpp"
 
@@ -133,3 +134,34 @@ TEST(average_of_vector_elements, check_float) {
   testTask.post_processing();
   EXPECT_NEAR(out[0], 1.5, 1e-5);
 }
+
+TEST(average_of_vector_elements, check_batch_matches_single) {
+  // Create 5000 small inputs of 1..20 elements laid out contiguously
+  std::vector<uint64_t> offsets(1, 0);
+  for (size_t i = 0; i < 5000; i++) {
+    offsets.push_back(offsets.back() + i % 20 + 1);
+  }
+  std::vector<int32_t> data(offsets.back());
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<int32_t>(static_cast<int64_t>(i * 7919 % 201) - 100);
+  }
+
+  // Run the batch on 4 threads
+  std::vector<double> out(offsets.size() - 1, -1);
+  ppc::core::Batch<int32_t> batch(data, offsets);
+  ppc::reference::AverageOfVectorElements<int32_t, double>::run_batch(batch, out.data(), 4);
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    std::vector<int32_t> in(batch[i].begin(), batch[i].end());
+    std::vector<double> single_out(1, 0);
+    std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->add_input(in);
+    taskData->add_output(single_out);
+    ppc::reference::AverageOfVectorElements<int32_t, double> testTask(taskData);
+    ASSERT_EQ(testTask.validation(), true);
+    testTask.pre_processing();
+    testTask.run();
+    testTask.post_processing();
+    ASSERT_EQ(out[i], single_out[0]);
+  }
+}
@@ -6,10 +6,12 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <numeric>
+#include <span>
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -17,7 +19,9 @@ namespace reference {
 template <class InType, class OutType>
 class AverageOfVectorElements : public ppc::core::Task {
  public:
-  explicit AverageOfVectorElements(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
+  explicit AverageOfVectorElements(std::shared_ptr<ppc::core::TaskData> taskData_,
+                                   kernels::Summation summation_ = kernels::Summation::PAIRWISE)
+      : Task(taskData_), summation(summation_) {}
   bool pre_processing() override {
     internal_order_test();
     // Init vectors
@@ -39,8 +43,7 @@ class AverageOfVectorElements : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    average = static_cast<OutType>(std::accumulate(input_.begin(), input_.end(), 0.0));
-    average /= static_cast<OutType>(taskData->inputs_count[0]);
+    average = average_of(input_, summation);
     return true;
   }
 
@@ -50,9 +53,27 @@ class AverageOfVectorElements : public ppc::core::Task {
     return true;
   }
 
+  // Batched path for many small inputs, the average of input i goes to out[i]
+  static void run_batch(const ppc::core::Batch<InType>& batch, OutType* out, size_t num_threads = 0) {
+    ppc::core::parallel_for_batch(
+        batch.size(), batch.total_size(),
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            out[i] = average_of(batch[i], kernels::Summation::PAIRWISE);
+          }
+        },
+        num_threads);
+  }
+
  private:
   std::vector<InType> input_;
   OutType average;
+  kernels::Summation summation;
+
+  static OutType average_of(std::span<const InType> input, kernels::Summation summation) {
+    auto result = static_cast<OutType>(kernels::sum_of(input, summation));
+    return result / static_cast<OutType>(input.size());
+  }
 };
 
 }  // namespace reference
@@ -0,0 +1,202 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ref/kernels/include/kernels.hpp"
+#include "ref/kernels/include/neighbor_kernels.hpp"
+
+namespace kernels = ppc::reference::kernels;
+
+namespace {
+
+// Run check on every instruction set this CPU and build support
+template <class Check>
+void for_each_isa(const Check& check) {
+  const auto initial = kernels::active_isa();
+  for (auto isa : {kernels::Isa::SCALAR, kernels::Isa::SSE2, kernels::Isa::AVX2, kernels::Isa::AVX512}) {
+    try {
+      kernels::set_isa(isa);
+    } catch (const std::invalid_argument&) {
+      continue;
+    }
+    SCOPED_TRACE(kernels::to_string(isa));
+    check();
+  }
+  kernels::set_isa(initial);
+}
+
+template <class T>
+size_t first_min(const std::vector<T>& x) {
+  return std::distance(x.begin(), std::min_element(x.begin(), x.end()));
+}
+
+template <class T>
+size_t first_max(const std::vector<T>& x) {
+  return std::distance(x.begin(), std::max_element(x.begin(), x.end()));
+}
+
+// Feed x in chunks of random sizes, empty ones included
+template <class Scan, class T>
+Scan scan_in_chunks(const std::vector<T>& x, std::mt19937& gen) {
+  std::uniform_int_distribution<size_t> chunk(0, 9);
+  std::span<const T> rest(x);
+  Scan scan;
+  while (!rest.empty()) {
+    const size_t n = std::min(chunk(gen), rest.size());
+    scan.feed(rest.first(n));
+    rest = rest.subspan(n);
+  }
+  return scan;
+}
+
+}  // namespace
+
+TEST(kernels, check_detected_isa_is_active) {
+  EXPECT_EQ(kernels::active_isa(), kernels::detected_isa());
+  EXPECT_NO_THROW(kernels::set_isa(kernels::Isa::SCALAR));
+  EXPECT_EQ(kernels::active_isa(), kernels::Isa::SCALAR);
+  kernels::set_isa(kernels::detected_isa());
+}
+
+TEST(kernels, check_int32_t) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int32_t> dist(INT32_MIN, INT32_MAX);
+  for_each_isa([&] {
+    // every size up to a few registers covers the tails of all lane counts
+    for (size_t n = 0; n < 70; n++) {
+      std::vector<int32_t> x(n);
+      std::vector<int32_t> y(n);
+      for (size_t i = 0; i < n; i++) {
+        x[i] = dist(gen);
+        y[i] = dist(gen) % 1000;
+      }
+      int64_t expected_sum = 0;
+      int64_t expected_dot = 0;
+      for (size_t i = 0; i < n; i++) {
+        expected_sum += x[i];
+        expected_dot += static_cast<int64_t>(x[i]) * y[i];
+      }
+      ASSERT_EQ(kernels::sum(x.data(), n), expected_sum);
+      ASSERT_EQ(kernels::dot(x.data(), y.data(), n), expected_dot);
+      if (n == 0) continue;
+      ASSERT_EQ(kernels::min_index(x.data(), n), first_min(x));
+      ASSERT_EQ(kernels::max_index(x.data(), n), first_max(x));
+    }
+  });
+}
+
+TEST(kernels, check_floating_point) {
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  std::vector<double> x(100003);
+  std::vector<double> y(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = dist(gen);
+    y[i] = dist(gen);
+  }
+  std::vector<float> xf(x.begin(), x.end());
+  std::vector<float> yf(y.begin(), y.end());
+  // long double as the reference where it is wider than double
+  long double expected_sum = 0;
+  long double expected_dot = 0;
+  long double expected_sum_f = 0;
+  for (size_t i = 0; i < x.size(); i++) {
+    expected_sum += x[i];
+    expected_dot += static_cast<long double>(x[i]) * y[i];
+    expected_sum_f += xf[i];
+  }
+
+  for_each_isa([&] {
+    for (auto summation : {kernels::Summation::SIMPLE, kernels::Summation::PAIRWISE, kernels::Summation::KAHAN}) {
+      EXPECT_NEAR(kernels::sum(x.data(), x.size(), summation), static_cast<double>(expected_sum), 1e-9);
+      EXPECT_NEAR(kernels::dot(x.data(), y.data(), x.size(), summation), static_cast<double>(expected_dot), 1e-9);
+      EXPECT_NEAR(kernels::sum(xf.data(), xf.size(), summation), static_cast<double>(expected_sum_f), 1e-9);
+    }
+    EXPECT_EQ(kernels::min_index(x.data(), x.size()), first_min(x));
+    EXPECT_EQ(kernels::max_index(x.data(), x.size()), first_max(x));
+    EXPECT_EQ(kernels::min_index(xf.data(), xf.size()), first_min(xf));
+    EXPECT_EQ(kernels::max_index(xf.data(), xf.size()), first_max(xf));
+  });
+}
+
+TEST(kernels, check_first_of_equal_extremes) {
+  std::vector<double> x(37, 1.0);
+  x[5] = x[20] = x[33] = 2.0;
+  x[9] = x[30] = 0.0;
+  for_each_isa([&] {
+    EXPECT_EQ(kernels::max_index(x.data(), x.size()), 5U);
+    EXPECT_EQ(kernels::min_index(x.data(), x.size()), 9U);
+  });
+}
+
+TEST(kernels, check_kahan_keeps_small_terms) {
+  // 1 followed by many terms below half an ulp of 1: a plain sum never moves off 1
+  std::vector<double> x(1 << 20, 1e-17);
+  x[0] = 1.0;
+  const double expected = 1.0 + 1e-17 * static_cast<double>(x.size() - 1);
+  for_each_isa([&] {
+    EXPECT_NEAR(kernels::sum(x.data(), x.size(), kernels::Summation::KAHAN), expected, 1e-15);
+    EXPECT_NEAR(kernels::sum(x.data(), x.size(), kernels::Summation::PAIRWISE), expected, 1e-14);
+  });
+}
+
+TEST(kernels, check_accumulator_types) {
+  static_assert(std::is_same_v<kernels::accumulator_t<int32_t>, int64_t>);
+  static_assert(std::is_same_v<kernels::accumulator_t<uint8_t>, uint64_t>);
+  static_assert(std::is_same_v<kernels::accumulator_t<float>, double>);
+  static_assert(std::is_same_v<kernels::accumulator_t<double>, double>);
+
+  std::vector<uint8_t> x(1000, 255);
+  EXPECT_EQ(kernels::sum_of<uint8_t>(x), 255000U);
+  std::vector<int32_t> y(4, INT32_MAX);
+  EXPECT_EQ(kernels::sum_of<int32_t>(y), 4 * static_cast<int64_t>(INT32_MAX));
+}
+
+TEST(kernels, check_neighbor_scans_match_naive) {
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int32_t> dist(-20, 20);
+  const ppc::core::ExecutionPolicy policy{ppc::core::Backend::STL, 3};
+  for (size_t n : {0, 1, 2, 3, 17, 1000}) {
+    std::vector<int32_t> x(n);
+    for (auto& v : x) v = dist(gen);
+    const std::span<const int32_t> xs(x);
+    uint64_t alternations = 0;
+    uint64_t violations = 0;
+    size_t nearest = 0;
+    size_t farthest = 0;
+    for (size_t i = 0; i + 1 < n; i++) {
+      alternations += static_cast<uint64_t>((x[i] < 0 && x[i + 1] > 0) || (x[i] > 0 && x[i + 1] < 0));
+      violations += static_cast<uint64_t>(x[i] > x[i + 1]);
+      if (std::abs(x[i] - x[i + 1]) < std::abs(x[nearest] - x[nearest + 1])) nearest = i;
+      if (std::abs(x[i] - x[i + 1]) > std::abs(x[farthest] - x[farthest + 1])) farthest = i;
+    }
+    SCOPED_TRACE(n);
+    EXPECT_EQ(scan_in_chunks<kernels::SignAlternations<int32_t>>(x, gen).op.count, alternations);
+    EXPECT_EQ(kernels::scan_blocks<kernels::SignAlternations<int32_t>>(xs, policy, 7).op.count, alternations);
+    EXPECT_EQ(scan_in_chunks<kernels::OrderViolations<int32_t>>(x, gen).op.count, violations);
+    EXPECT_EQ(kernels::scan_blocks<kernels::OrderViolations<int32_t>>(xs, policy, 7).op.count, violations);
+    if (n < 2) continue;
+    EXPECT_EQ(scan_in_chunks<kernels::NearestNeighbors<int32_t>>(x, gen).op.index, nearest);
+    EXPECT_EQ(kernels::scan_blocks<kernels::NearestNeighbors<int32_t>>(xs, policy, 7).op.index, nearest);
+    EXPECT_EQ(scan_in_chunks<kernels::MostDifferentNeighbors<int32_t>>(x, gen).op.index, farthest);
+    EXPECT_EQ(kernels::scan_blocks<kernels::MostDifferentNeighbors<int32_t>>(xs, policy, 7).op.index, farthest);
+  }
+}
+
+TEST(kernels, check_neighbor_scans_do_not_overflow) {
+  std::vector<int8_t> x = {-100, 100, -1, 0, 1};
+  kernels::MostDifferentNeighbors<int8_t> farthest;
+  farthest.feed(x);
+  EXPECT_EQ(farthest.op.index, 0U);
+  EXPECT_EQ(farthest.op.best, 200U);
+  std::vector<int32_t> y = {INT32_MAX, INT32_MIN, 1, -1};
+  kernels::SignAlternations<int32_t> alternations;
+  alternations.feed(y);
+  EXPECT_EQ(alternations.op.count, 3U);
+}
@@ -0,0 +1,110 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_REFERENCE_KERNELS_KERNELS_HPP_
+#define MODULES_REFERENCE_KERNELS_KERNELS_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+
+namespace ppc {
+namespace reference {
+namespace kernels {
+
+// Reduction kernels of the reference tasks. int32_t, float and double inputs run on the
+// widest instruction set the CPU supports (SSE2, AVX2 or AVX-512, chosen at runtime),
+// other types on a scalar loop.
+enum class Isa { SCALAR, SSE2, AVX2, AVX512 };
+
+// How floating point sums are accumulated: SIMPLE adds every element into the SIMD lanes,
+// PAIRWISE adds blocks pairwise (error grows with log n), KAHAN compensates every lane
+enum class Summation { SIMPLE, PAIRWISE, KAHAN };
+
+// Sums of integers go to 64 bits, of float to double
+template <class T>
+using accumulator_t =
+    std::conditional_t<std::is_floating_point_v<T>, std::conditional_t<(sizeof(T) < sizeof(double)), double, T>,
+                       std::conditional_t<std::is_integral_v<T>,
+                                          std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>, T>>;
+
+// best instruction set of this CPU compiled in
+Isa detected_isa();
+// instruction set the kernels run on, detected_isa() unless set_isa() was called
+Isa active_isa();
+// Force the kernels to isa, e.g. to compare instruction sets; throws if the CPU or the
+// build does not support it
+void set_isa(Isa isa);
+std::string to_string(Isa isa);
+
+int64_t sum(const int32_t* x, size_t n);
+double sum(const float* x, size_t n, Summation summation);
+double sum(const double* x, size_t n, Summation summation);
+
+int64_t dot(const int32_t* x, const int32_t* y, size_t n);
+double dot(const float* x, const float* y, size_t n, Summation summation);
+double dot(const double* x, const double* y, size_t n, Summation summation);
+
+// index of the first minimum / maximum, 0 for an empty input; unspecified with NaN
+size_t min_index(const int32_t* x, size_t n);
+size_t min_index(const float* x, size_t n);
+size_t min_index(const double* x, size_t n);
+size_t max_index(const int32_t* x, size_t n);
+size_t max_index(const float* x, size_t n);
+size_t max_index(const double* x, size_t n);
+
+template <class T>
+constexpr bool has_simd_kernel_v =
+    std::is_same_v<T, int32_t> || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+template <class T>
+accumulator_t<T> sum_of(std::span<const T> x, Summation summation = Summation::PAIRWISE) {
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return sum(x.data(), x.size());
+  } else if constexpr (has_simd_kernel_v<T>) {
+    return sum(x.data(), x.size(), summation);
+  } else {
+    accumulator_t<T> result = 0;
+    for (const auto& value : x) result += value;
+    return result;
+  }
+}
+
+template <class T>
+accumulator_t<T> dot_of(std::span<const T> x, std::span<const T> y, Summation summation = Summation::PAIRWISE) {
+  if constexpr (std::is_same_v<T, int32_t>) {
+    return dot(x.data(), y.data(), x.size());
+  } else if constexpr (has_simd_kernel_v<T>) {
+    return dot(x.data(), y.data(), x.size(), summation);
+  } else {
+    accumulator_t<T> result = 0;
+    for (size_t i = 0; i < x.size(); i++) result += static_cast<accumulator_t<T>>(x[i]) * y[i];
+    return result;
+  }
+}
+
+template <class T>
+size_t min_index_of(std::span<const T> x) {
+  if constexpr (has_simd_kernel_v<T>) {
+    return min_index(x.data(), x.size());
+  } else {
+    return x.empty() ? 0 : std::distance(x.begin(), std::min_element(x.begin(), x.end()));
+  }
+}
+
+template <class T>
+size_t max_index_of(std::span<const T> x) {
+  if constexpr (has_simd_kernel_v<T>) {
+    return max_index(x.data(), x.size());
+  } else {
+    return x.empty() ? 0 : std::distance(x.begin(), std::max_element(x.begin(), x.end()));
+  }
+}
+
+}  // namespace kernels
+}  // namespace reference
+}  // namespace ppc
+
+#endif  // MODULES_REFERENCE_KERNELS_KERNELS_HPP_
@@ -0,0 +1,157 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_REFERENCE_KERNELS_NEIGHBOR_KERNELS_HPP_
+#define MODULES_REFERENCE_KERNELS_NEIGHBOR_KERNELS_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+
+#include "core/task/include/execution.hpp"
+
+namespace ppc {
+namespace reference {
+namespace kernels {
+
+// One pass over the adjacent pairs (x[i], x[i + 1]) of a sequence fed in consecutive
+// chunks of any size: the last element of a chunk is carried over to pair with the
+// first element of the next one. Scans of consecutive ranges built independently (in
+// parallel, say) are joined with merge(), which pairs the boundary elements. Op gets
+// every pair with the index of its left element through pair() and joins with the Op
+// of the range after it through merge().
+template <class T, class Op>
+class NeighborScan {
+ public:
+  Op op;
+
+  void feed(std::span<const T> chunk) {
+    if (chunk.empty()) return;
+    size_t i = 0;
+    if (count == 0) {
+      first = chunk[0];
+      last = chunk[0];
+      i = 1;
+    }
+    // the left element of (prev, chunk[i]) has the index count + i - 1
+    T prev = last;
+    for (; i < chunk.size(); i++) {
+      op.pair(prev, chunk[i], count + i - 1);
+      prev = chunk[i];
+    }
+    last = prev;
+    count += chunk.size();
+  }
+
+  // next must cover the elements right after the ones of this scan
+  void merge(const NeighborScan& next) {
+    if (next.count == 0) return;
+    if (count == 0) {
+      *this = next;
+      return;
+    }
+    op.pair(last, next.first, count - 1);
+    op.merge(next.op, count);
+    last = next.last;
+    count += next.count;
+  }
+
+  // count of elements fed
+  [[nodiscard]] size_t size() const { return count; }
+
+ private:
+  size_t count = 0;
+  T first{};
+  T last{};
+};
+
+// |a - b| without overflow: integers get their unsigned type, which holds any difference
+template <class T>
+using distance_t = typename std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>,
+                                               std::type_identity<T>>::type;
+
+template <class T>
+distance_t<T> distance(T a, T b) {
+  using D = distance_t<T>;
+  return a < b ? static_cast<D>(static_cast<D>(b) - static_cast<D>(a))
+               : static_cast<D>(static_cast<D>(a) - static_cast<D>(b));
+}
+
+// count of pairs of opposite signs (zero has no sign)
+template <class T>
+struct SignAlternationsOp {
+  uint64_t count = 0;
+  void pair(T a, T b, size_t) { count += static_cast<uint64_t>((a < 0 && b > 0) || (a > 0 && b < 0)); }
+  void merge(const SignAlternationsOp& next, size_t) { count += next.count; }
+};
+
+// count of pairs with a > b
+template <class T>
+struct OrderViolationsOp {
+  uint64_t count = 0;
+  void pair(T a, T b, size_t) { count += static_cast<uint64_t>(a > b); }
+  void merge(const OrderViolationsOp& next, size_t) { count += next.count; }
+};
+
+// first pair of the smallest (Better = std::less) or largest (std::greater) distance
+template <class T, class Better>
+struct NeighborDistanceOp {
+  bool found = false;
+  distance_t<T> best{};
+  size_t index = 0;
+  T left{};
+  T right{};
+
+  void pair(T a, T b, size_t i) {
+    const auto d = distance(a, b);
+    if (!found || Better()(d, best)) {
+      found = true;
+      best = d;
+      index = i;
+      left = a;
+      right = b;
+    }
+  }
+  // on a tie the earlier pair, which is this one, stays
+  void merge(const NeighborDistanceOp& next, size_t offset) {
+    if (next.found && (!found || Better()(next.best, best))) {
+      *this = next;
+      index += offset;
+    }
+  }
+};
+
+template <class T>
+using SignAlternations = NeighborScan<T, SignAlternationsOp<T>>;
+template <class T>
+using OrderViolations = NeighborScan<T, OrderViolationsOp<T>>;
+template <class T>
+using NearestNeighbors = NeighborScan<T, NeighborDistanceOp<T, std::less<>>>;
+template <class T>
+using MostDifferentNeighbors = NeighborScan<T, NeighborDistanceOp<T, std::greater<>>>;
+
+// Scan x in blocks of block_size elements on the backend of policy and merge the
+// blocks in order; the result is the same as feeding x at once
+template <class Scan, class T>
+Scan scan_blocks(std::span<const T> x, const ppc::core::ExecutionPolicy& policy, size_t block_size = 1 << 16) {
+  const size_t num_blocks = (x.size() + block_size - 1) / block_size;
+  return ppc::core::parallel_reduce(
+      policy, num_blocks, Scan{},
+      [&](uint64_t b) {
+        Scan scan;
+        scan.feed(x.subspan(b * block_size, std::min(block_size, x.size() - b * block_size)));
+        return scan;
+      },
+      [](Scan lhs, const Scan& rhs) {
+        lhs.merge(rhs);
+        return lhs;
+      });
+}
+
+}  // namespace kernels
+}  // namespace reference
+}  // namespace ppc
+
+#endif  // MODULES_REFERENCE_KERNELS_NEIGHBOR_KERNELS_HPP_
@@ -0,0 +1,195 @@
+// Copyright 2024 Nesterov Alexander
+#include "ref/kernels/include/kernels.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#include "ref/kernels/src/kernels_impl.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace {
+
+using ppc::reference::kernels::Isa;
+using ppc::reference::kernels::Summation;
+using ppc::reference::kernels::detail::KernelTable;
+
+// below this many elements PAIRWISE adds a block with the simple kernel
+constexpr size_t PAIRWISE_BLOCK = 512;
+
+bool cpu_supports(Isa isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  switch (isa) {
+    case Isa::SCALAR:
+      return true;
+    case Isa::SSE2:
+      return __builtin_cpu_supports("sse2");
+    case Isa::AVX2:
+      return __builtin_cpu_supports("avx2");
+    case Isa::AVX512:
+      return __builtin_cpu_supports("avx512f");
+  }
+  return false;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+  __cpuid(info, 1);
+  const bool sse2 = (info[3] & (1 << 26)) != 0;
+  // the OS must save the AVX (and AVX-512) registers on context switches
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  const uint64_t xcr0 = osxsave ? _xgetbv(0) : 0;
+  bool avx2 = false;
+  bool avx512 = false;
+  if (max_leaf >= 7) {
+    __cpuidex(info, 7, 0);
+    avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+  }
+  switch (isa) {
+    case Isa::SCALAR:
+      return true;
+    case Isa::SSE2:
+      return sse2;
+    case Isa::AVX2:
+      return avx2;
+    case Isa::AVX512:
+      return avx512;
+  }
+  return false;
+#else
+  return isa == Isa::SCALAR;
+#endif
+}
+
+const KernelTable& table_of(Isa isa) {
+  static const KernelTable scalar = ppc::reference::kernels::detail::scalar_table();
+  static const KernelTable sse2 = ppc::reference::kernels::detail::sse2_table();
+  static const KernelTable avx2 = ppc::reference::kernels::detail::avx2_table();
+  static const KernelTable avx512 = ppc::reference::kernels::detail::avx512_table();
+  switch (isa) {
+    case Isa::SSE2:
+      return sse2;
+    case Isa::AVX2:
+      return avx2;
+    case Isa::AVX512:
+      return avx512;
+    default:
+      return scalar;
+  }
+}
+
+bool is_usable(Isa isa) { return table_of(isa).available && cpu_supports(isa); }
+
+std::atomic<const KernelTable*> active_table{nullptr};
+std::atomic<Isa> active{Isa::SCALAR};
+
+const KernelTable& table() {
+  const KernelTable* result = active_table.load(std::memory_order_acquire);
+  if (result == nullptr) {
+    const Isa isa = ppc::reference::kernels::detected_isa();
+    active.store(isa);
+    result = &table_of(isa);
+    active_table.store(result, std::memory_order_release);
+  }
+  return *result;
+}
+
+template <class T, class Simple>
+double pairwise(const T* x, size_t n, const Simple& simple) {
+  if (n <= PAIRWISE_BLOCK) return simple(x, n);
+  // split on a multiple of the block so that the SIMD lanes stay full
+  const size_t half = (n / 2 + PAIRWISE_BLOCK - 1) / PAIRWISE_BLOCK * PAIRWISE_BLOCK;
+  return pairwise(x, half, simple) + pairwise(x + half, n - half, simple);
+}
+
+template <class T, class Simple>
+double pairwise_dot(const T* x, const T* y, size_t n, const Simple& simple) {
+  if (n <= PAIRWISE_BLOCK) return simple(x, y, n);
+  const size_t half = (n / 2 + PAIRWISE_BLOCK - 1) / PAIRWISE_BLOCK * PAIRWISE_BLOCK;
+  return pairwise_dot(x, y, half, simple) + pairwise_dot(x + half, y + half, n - half, simple);
+}
+
+}  // namespace
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::scalar_table() {
+  return make_table<ScalarAcc<int64_t>, ScalarAcc<double>, ScalarLanes<int32_t>, ScalarLanes<float>,
+                    ScalarLanes<double>>();
+}
+
+ppc::reference::kernels::Isa ppc::reference::kernels::detected_isa() {
+  for (auto isa : {Isa::AVX512, Isa::AVX2, Isa::SSE2}) {
+    if (is_usable(isa)) return isa;
+  }
+  return Isa::SCALAR;
+}
+
+ppc::reference::kernels::Isa ppc::reference::kernels::active_isa() {
+  table();
+  return active.load();
+}
+
+void ppc::reference::kernels::set_isa(Isa isa) {
+  if (!is_usable(isa)) throw std::invalid_argument("Instruction set " + to_string(isa) + " is not supported");
+  active.store(isa);
+  active_table.store(&table_of(isa), std::memory_order_release);
+}
+
+std::string ppc::reference::kernels::to_string(Isa isa) {
+  switch (isa) {
+    case Isa::SCALAR:
+      return "scalar";
+    case Isa::SSE2:
+      return "sse2";
+    case Isa::AVX2:
+      return "avx2";
+    case Isa::AVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+int64_t ppc::reference::kernels::sum(const int32_t* x, size_t n) { return table().sum_i32(x, n); }
+
+double ppc::reference::kernels::sum(const float* x, size_t n, Summation summation) {
+  const auto& t = table();
+  if (summation == Summation::KAHAN) return t.sum_f32_kahan(x, n);
+  if (summation == Summation::PAIRWISE) return pairwise(x, n, t.sum_f32);
+  return t.sum_f32(x, n);
+}
+
+double ppc::reference::kernels::sum(const double* x, size_t n, Summation summation) {
+  const auto& t = table();
+  if (summation == Summation::KAHAN) return t.sum_f64_kahan(x, n);
+  if (summation == Summation::PAIRWISE) return pairwise(x, n, t.sum_f64);
+  return t.sum_f64(x, n);
+}
+
+int64_t ppc::reference::kernels::dot(const int32_t* x, const int32_t* y, size_t n) {
+  return table().dot_i32(x, y, n);
+}
+
+double ppc::reference::kernels::dot(const float* x, const float* y, size_t n, Summation summation) {
+  const auto& t = table();
+  if (summation == Summation::KAHAN) return t.dot_f32_kahan(x, y, n);
+  if (summation == Summation::PAIRWISE) return pairwise_dot(x, y, n, t.dot_f32);
+  return t.dot_f32(x, y, n);
+}
+
+double ppc::reference::kernels::dot(const double* x, const double* y, size_t n, Summation summation) {
+  const auto& t = table();
+  if (summation == Summation::KAHAN) return t.dot_f64_kahan(x, y, n);
+  if (summation == Summation::PAIRWISE) return pairwise_dot(x, y, n, t.dot_f64);
+  return t.dot_f64(x, y, n);
+}
+
+size_t ppc::reference::kernels::min_index(const int32_t* x, size_t n) { return table().min_i32(x, n); }
+size_t ppc::reference::kernels::min_index(const float* x, size_t n) { return table().min_f32(x, n); }
+size_t ppc::reference::kernels::min_index(const double* x, size_t n) { return table().min_f64(x, n); }
+size_t ppc::reference::kernels::max_index(const int32_t* x, size_t n) { return table().max_i32(x, n); }
+size_t ppc::reference::kernels::max_index(const float* x, size_t n) { return table().max_f32(x, n); }
+size_t ppc::reference::kernels::max_index(const double* x, size_t n) { return table().max_f64(x, n); }
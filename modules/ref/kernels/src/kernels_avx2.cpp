@@ -0,0 +1,85 @@
+// Copyright 2024 Nesterov Alexander
+#include "ref/kernels/src/kernels_impl.hpp"
+
+// compiled with -mavx2 (/arch:AVX2) on x86, see modules/ref/CMakeLists.txt
+#ifdef __AVX2__
+#include <immintrin.h>
+
+namespace {
+
+struct I64 {
+  using Scalar = int64_t;
+  using Reg = __m256i;
+  static constexpr size_t W = 4;
+  static constexpr bool HAS_MUL = true;
+  static Reg zero() { return _mm256_setzero_si256(); }
+  static Reg load(const int32_t* p) {
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  }
+  static Reg add(Reg a, Reg b) { return _mm256_add_epi64(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm256_sub_epi64(a, b); }
+  // lanes hold sign extended 32 bit values, so the signed 32 x 32 -> 64 bit product is exact
+  static Reg mul(Reg a, Reg b) { return _mm256_mul_epi32(a, b); }
+  static void store(int64_t* out, Reg a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a); }
+};
+
+struct F64 {
+  using Scalar = double;
+  using Reg = __m256d;
+  static constexpr size_t W = 4;
+  static Reg zero() { return _mm256_setzero_pd(); }
+  static Reg load(const double* p) { return _mm256_loadu_pd(p); }
+  static Reg load(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+  static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+  static void store(double* out, Reg a) { _mm256_storeu_pd(out, a); }
+};
+
+struct LI32 {
+  using T = int32_t;
+  using Reg = __m256i;
+  static constexpr size_t W = 8;
+  static Reg load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  static Reg set1(T value) { return _mm256_set1_epi32(value); }
+  static Reg min(Reg a, Reg b) { return _mm256_min_epi32(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm256_max_epi32(a, b); }
+  static void store(T* out, Reg a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+};
+
+struct LF32 {
+  using T = float;
+  using Reg = __m256;
+  static constexpr size_t W = 8;
+  static Reg load(const T* p) { return _mm256_loadu_ps(p); }
+  static Reg set1(T value) { return _mm256_set1_ps(value); }
+  static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+  static void store(T* out, Reg a) { _mm256_storeu_ps(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+};
+
+struct LF64 {
+  using T = double;
+  using Reg = __m256d;
+  static constexpr size_t W = 4;
+  static Reg load(const T* p) { return _mm256_loadu_pd(p); }
+  static Reg set1(T value) { return _mm256_set1_pd(value); }
+  static Reg min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+  static void store(T* out, Reg a) { _mm256_storeu_pd(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+};
+
+}  // namespace
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::avx2_table() {
+  return make_table<I64, F64, LI32, LF32, LF64>();
+}
+
+#else
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::avx2_table() { return {}; }
+
+#endif
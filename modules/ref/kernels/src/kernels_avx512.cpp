@@ -0,0 +1,89 @@
+// Copyright 2024 Nesterov Alexander
+#include "ref/kernels/src/kernels_impl.hpp"
+
+// compiled with -mavx512f (/arch:AVX512) on x86, see modules/ref/CMakeLists.txt
+#ifdef __AVX512F__
+#include <immintrin.h>
+
+// The unmasked forms of some intrinsics in GCC's avx512fintrin.h pass _mm512_undefined_*()
+// as the source of the masked builtin, which -Wmaybe-uninitialized reports; the kernels
+// use the masked forms with every lane selected and a defined source instead.
+
+namespace {
+
+struct I64 {
+  using Scalar = int64_t;
+  using Reg = __m512i;
+  static constexpr size_t W = 8;
+  static constexpr bool HAS_MUL = true;
+  static Reg zero() { return _mm512_setzero_si512(); }
+  static Reg load(const int32_t* p) {
+    return _mm512_mask_cvtepi32_epi64(zero(), 0xFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+  }
+  static Reg add(Reg a, Reg b) { return _mm512_add_epi64(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm512_sub_epi64(a, b); }
+  // lanes hold sign extended 32 bit values, so the signed 32 x 32 -> 64 bit product is exact
+  static Reg mul(Reg a, Reg b) { return _mm512_mask_mul_epi32(a, 0xFF, a, b); }
+  static void store(int64_t* out, Reg a) { _mm512_storeu_si512(out, a); }
+};
+
+struct F64 {
+  using Scalar = double;
+  using Reg = __m512d;
+  static constexpr size_t W = 8;
+  static Reg zero() { return _mm512_setzero_pd(); }
+  static Reg load(const double* p) { return _mm512_loadu_pd(p); }
+  static Reg load(const float* p) { return _mm512_mask_cvtps_pd(zero(), 0xFF, _mm256_loadu_ps(p)); }
+  static Reg add(Reg a, Reg b) { return _mm512_add_pd(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm512_sub_pd(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm512_mul_pd(a, b); }
+  static void store(double* out, Reg a) { _mm512_storeu_pd(out, a); }
+};
+
+struct LI32 {
+  using T = int32_t;
+  using Reg = __m512i;
+  static constexpr size_t W = 16;
+  static Reg load(const T* p) { return _mm512_loadu_si512(p); }
+  static Reg set1(T value) { return _mm512_set1_epi32(value); }
+  static Reg min(Reg a, Reg b) { return _mm512_mask_min_epi32(a, 0xFFFF, a, b); }
+  static Reg max(Reg a, Reg b) { return _mm512_mask_max_epi32(a, 0xFFFF, a, b); }
+  static void store(T* out, Reg a) { _mm512_storeu_si512(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm512_cmpeq_epi32_mask(a, b); }
+};
+
+struct LF32 {
+  using T = float;
+  using Reg = __m512;
+  static constexpr size_t W = 16;
+  static Reg load(const T* p) { return _mm512_loadu_ps(p); }
+  static Reg set1(T value) { return _mm512_set1_ps(value); }
+  static Reg min(Reg a, Reg b) { return _mm512_mask_min_ps(a, 0xFFFF, a, b); }
+  static Reg max(Reg a, Reg b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); }
+  static void store(T* out, Reg a) { _mm512_storeu_ps(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+};
+
+struct LF64 {
+  using T = double;
+  using Reg = __m512d;
+  static constexpr size_t W = 8;
+  static Reg load(const T* p) { return _mm512_loadu_pd(p); }
+  static Reg set1(T value) { return _mm512_set1_pd(value); }
+  static Reg min(Reg a, Reg b) { return _mm512_mask_min_pd(a, 0xFF, a, b); }
+  static Reg max(Reg a, Reg b) { return _mm512_mask_max_pd(a, 0xFF, a, b); }
+  static void store(T* out, Reg a) { _mm512_storeu_pd(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+};
+
+}  // namespace
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::avx512_table() {
+  return make_table<I64, F64, LI32, LF32, LF64>();
+}
+
+#else
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::avx512_table() { return {}; }
+
+#endif
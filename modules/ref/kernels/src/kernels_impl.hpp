@@ -0,0 +1,251 @@
+// Copyright 2024 Nesterov Alexander
+
+#ifndef MODULES_REFERENCE_KERNELS_KERNELS_IMPL_HPP_
+#define MODULES_REFERENCE_KERNELS_KERNELS_IMPL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Kernels written once against a small set of lane operations. Every instruction set
+// has its own translation unit compiled for it, which defines the operations on its
+// registers and builds a KernelTable with make_table(); the scalar operations below are
+// the fallback. Only the translation unit of an instruction set the CPU supports is
+// ever called.
+
+namespace ppc {
+namespace reference {
+namespace kernels {
+namespace detail {
+
+struct KernelTable {
+  bool available = false;
+  int64_t (*sum_i32)(const int32_t*, size_t) = nullptr;
+  double (*sum_f32)(const float*, size_t) = nullptr;
+  double (*sum_f32_kahan)(const float*, size_t) = nullptr;
+  double (*sum_f64)(const double*, size_t) = nullptr;
+  double (*sum_f64_kahan)(const double*, size_t) = nullptr;
+  int64_t (*dot_i32)(const int32_t*, const int32_t*, size_t) = nullptr;
+  double (*dot_f32)(const float*, const float*, size_t) = nullptr;
+  double (*dot_f32_kahan)(const float*, const float*, size_t) = nullptr;
+  double (*dot_f64)(const double*, const double*, size_t) = nullptr;
+  double (*dot_f64_kahan)(const double*, const double*, size_t) = nullptr;
+  size_t (*min_i32)(const int32_t*, size_t) = nullptr;
+  size_t (*max_i32)(const int32_t*, size_t) = nullptr;
+  size_t (*min_f32)(const float*, size_t) = nullptr;
+  size_t (*max_f32)(const float*, size_t) = nullptr;
+  size_t (*min_f64)(const double*, size_t) = nullptr;
+  size_t (*max_f64)(const double*, size_t) = nullptr;
+};
+
+KernelTable scalar_table();
+KernelTable sse2_table();
+KernelTable avx2_table();
+KernelTable avx512_table();
+
+// The code below is compiled by every translation unit for its own instruction set. The
+// unnamed namespace gives all of it internal linkage, ScalarAcc instantiations included,
+// so the linker never merges the copy of one unit into another; for the same reason it
+// calls no inline library function such as std::countr_zero.
+namespace {
+
+// index of the lowest set bit of a nonzero mask
+inline size_t lowest_set_bit(uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  unsigned long index = 0;
+  _BitScanForward64(&index, mask);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctzll(mask));
+#endif
+}
+
+// Accumulator lanes: Reg holds W values of Scalar, load() widens W inputs into them
+template <class S>
+struct ScalarAcc {
+  using Scalar = S;
+  using Reg = S;
+  static constexpr size_t W = 1;
+  static constexpr bool HAS_MUL = true;
+  static Reg zero() { return 0; }
+  template <class In>
+  static Reg load(const In* p) {
+    return static_cast<S>(*p);
+  }
+  static Reg add(Reg a, Reg b) { return a + b; }
+  static Reg sub(Reg a, Reg b) { return a - b; }
+  static Reg mul(Reg a, Reg b) { return a * b; }
+  static void store(S* out, Reg a) { out[0] = a; }
+};
+
+// Value lanes for min / max: eq_mask() has bit j set if lane j of a and b are equal
+template <class T_>
+struct ScalarLanes {
+  using T = T_;
+  using Reg = T_;
+  static constexpr size_t W = 1;
+  static Reg load(const T* p) { return *p; }
+  static Reg set1(T value) { return value; }
+  static Reg min(Reg a, Reg b) { return b < a ? b : a; }
+  static Reg max(Reg a, Reg b) { return a < b ? b : a; }
+  static void store(T* out, Reg a) { out[0] = a; }
+  static uint64_t eq_mask(Reg a, Reg b) { return a == b ? 1 : 0; }
+};
+
+// term(i) gives the lanes of elements [i, i + W), scalar_term(i) element i alone
+template <class A, class Term, class ScalarTerm>
+typename A::Scalar reduce_simple(size_t n, const Term& term, const ScalarTerm& scalar_term) {
+  using S = typename A::Scalar;
+  // two independent chains hide the latency of the additions
+  auto acc0 = A::zero();
+  auto acc1 = A::zero();
+  size_t i = 0;
+  for (; i + 2 * A::W <= n; i += 2 * A::W) {
+    acc0 = A::add(acc0, term(i));
+    acc1 = A::add(acc1, term(i + A::W));
+  }
+  if (i + A::W <= n) {
+    acc0 = A::add(acc0, term(i));
+    i += A::W;
+  }
+  S lanes[A::W];
+  A::store(lanes, A::add(acc0, acc1));
+  S result = 0;
+  for (size_t j = 0; j < A::W; j++) result += lanes[j];
+  for (; i < n; i++) result += scalar_term(i);
+  return result;
+}
+
+template <class A, class Term, class ScalarTerm>
+typename A::Scalar reduce_kahan(size_t n, const Term& term, const ScalarTerm& scalar_term) {
+  using S = typename A::Scalar;
+  auto sum = A::zero();
+  auto compensation = A::zero();
+  size_t i = 0;
+  for (; i + A::W <= n; i += A::W) {
+    auto y = A::sub(term(i), compensation);
+    auto t = A::add(sum, y);
+    compensation = A::sub(A::sub(t, sum), y);
+    sum = t;
+  }
+  S sum_lanes[A::W];
+  S compensation_lanes[A::W];
+  A::store(sum_lanes, sum);
+  A::store(compensation_lanes, compensation);
+  S result = 0;
+  S c = 0;
+  auto add = [&](S value) {
+    S y = value - c;
+    S t = result + y;
+    c = (t - result) - y;
+    result = t;
+  };
+  for (size_t j = 0; j < A::W; j++) {
+    add(sum_lanes[j]);
+    add(-compensation_lanes[j]);
+  }
+  for (; i < n; i++) add(scalar_term(i));
+  return result;
+}
+
+template <class A, class In>
+typename A::Scalar sum_simple(const In* x, size_t n) {
+  using S = typename A::Scalar;
+  return reduce_simple<A>(
+      n, [&](size_t i) { return A::load(x + i); }, [&](size_t i) { return static_cast<S>(x[i]); });
+}
+
+template <class A, class In>
+typename A::Scalar sum_kahan(const In* x, size_t n) {
+  using S = typename A::Scalar;
+  return reduce_kahan<A>(
+      n, [&](size_t i) { return A::load(x + i); }, [&](size_t i) { return static_cast<S>(x[i]); });
+}
+
+template <class A, class In>
+typename A::Scalar dot_simple(const In* x, const In* y, size_t n) {
+  using S = typename A::Scalar;
+  return reduce_simple<A>(
+      n, [&](size_t i) { return A::mul(A::load(x + i), A::load(y + i)); },
+      [&](size_t i) { return static_cast<S>(x[i]) * static_cast<S>(y[i]); });
+}
+
+template <class A, class In>
+typename A::Scalar dot_kahan(const In* x, const In* y, size_t n) {
+  using S = typename A::Scalar;
+  return reduce_kahan<A>(
+      n, [&](size_t i) { return A::mul(A::load(x + i), A::load(y + i)); },
+      [&](size_t i) { return static_cast<S>(x[i]) * static_cast<S>(y[i]); });
+}
+
+// First find the extreme value with the lanes, then the first element equal to it
+template <class L, bool IS_MAX>
+size_t extreme_index(const typename L::T* x, size_t n) {
+  using T = typename L::T;
+  if (n == 0) return 0;
+  auto better = [](T a, T b) { return IS_MAX ? (a < b ? b : a) : (b < a ? b : a); };
+  T best = x[0];
+  size_t i = 0;
+  if (n >= L::W) {
+    auto acc = L::load(x);
+    for (i = L::W; i + L::W <= n; i += L::W) {
+      acc = IS_MAX ? L::max(acc, L::load(x + i)) : L::min(acc, L::load(x + i));
+    }
+    T lanes[L::W];
+    L::store(lanes, acc);
+    best = lanes[0];
+    for (size_t j = 1; j < L::W; j++) best = better(best, lanes[j]);
+  }
+  for (; i < n; i++) best = better(best, x[i]);
+
+  const auto target = L::set1(best);
+  size_t j = 0;
+  for (; j + L::W <= n; j += L::W) {
+    const uint64_t mask = L::eq_mask(L::load(x + j), target);
+    if (mask != 0) return j + lowest_set_bit(mask);
+  }
+  for (; j < n; j++) {
+    if (x[j] == best) return j;
+  }
+  return 0;
+}
+
+template <class I64, class F64, class LI32, class LF32, class LF64>
+KernelTable make_table() {
+  KernelTable table;
+  table.available = true;
+  table.sum_i32 = [](const int32_t* x, size_t n) -> int64_t { return sum_simple<I64>(x, n); };
+  table.sum_f32 = [](const float* x, size_t n) -> double { return sum_simple<F64>(x, n); };
+  table.sum_f32_kahan = [](const float* x, size_t n) -> double { return sum_kahan<F64>(x, n); };
+  table.sum_f64 = [](const double* x, size_t n) -> double { return sum_simple<F64>(x, n); };
+  table.sum_f64_kahan = [](const double* x, size_t n) -> double { return sum_kahan<F64>(x, n); };
+  if constexpr (I64::HAS_MUL) {
+    table.dot_i32 = [](const int32_t* x, const int32_t* y, size_t n) -> int64_t { return dot_simple<I64>(x, y, n); };
+  } else {
+    table.dot_i32 = [](const int32_t* x, const int32_t* y, size_t n) -> int64_t {
+      return dot_simple<ScalarAcc<int64_t>>(x, y, n);
+    };
+  }
+  table.dot_f32 = [](const float* x, const float* y, size_t n) -> double { return dot_simple<F64>(x, y, n); };
+  table.dot_f32_kahan = [](const float* x, const float* y, size_t n) -> double { return dot_kahan<F64>(x, y, n); };
+  table.dot_f64 = [](const double* x, const double* y, size_t n) -> double { return dot_simple<F64>(x, y, n); };
+  table.dot_f64_kahan = [](const double* x, const double* y, size_t n) -> double { return dot_kahan<F64>(x, y, n); };
+  table.min_i32 = [](const int32_t* x, size_t n) -> size_t { return extreme_index<LI32, false>(x, n); };
+  table.max_i32 = [](const int32_t* x, size_t n) -> size_t { return extreme_index<LI32, true>(x, n); };
+  table.min_f32 = [](const float* x, size_t n) -> size_t { return extreme_index<LF32, false>(x, n); };
+  table.max_f32 = [](const float* x, size_t n) -> size_t { return extreme_index<LF32, true>(x, n); };
+  table.min_f64 = [](const double* x, size_t n) -> size_t { return extreme_index<LF64, false>(x, n); };
+  table.max_f64 = [](const double* x, size_t n) -> size_t { return extreme_index<LF64, true>(x, n); };
+  return table;
+}
+
+}  // namespace
+}  // namespace detail
+}  // namespace kernels
+}  // namespace reference
+}  // namespace ppc
+
+#endif  // MODULES_REFERENCE_KERNELS_KERNELS_IMPL_HPP_
@@ -0,0 +1,88 @@
+// Copyright 2024 Nesterov Alexander
+#include "ref/kernels/src/kernels_impl.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+
+namespace {
+
+struct I64 {
+  using Scalar = int64_t;
+  using Reg = __m128i;
+  static constexpr size_t W = 2;
+  // no signed 32 x 32 -> 64 bit multiplication before SSE4.1
+  static constexpr bool HAS_MUL = false;
+  static Reg zero() { return _mm_setzero_si128(); }
+  static Reg load(const int32_t* p) {
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+    return _mm_unpacklo_epi32(v, _mm_srai_epi32(v, 31));
+  }
+  static Reg add(Reg a, Reg b) { return _mm_add_epi64(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm_sub_epi64(a, b); }
+  static void store(int64_t* out, Reg a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), a); }
+};
+
+struct F64 {
+  using Scalar = double;
+  using Reg = __m128d;
+  static constexpr size_t W = 2;
+  static Reg zero() { return _mm_setzero_pd(); }
+  static Reg load(const double* p) { return _mm_loadu_pd(p); }
+  static Reg load(const float* p) {
+    return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+  }
+  static Reg add(Reg a, Reg b) { return _mm_add_pd(a, b); }
+  static Reg sub(Reg a, Reg b) { return _mm_sub_pd(a, b); }
+  static Reg mul(Reg a, Reg b) { return _mm_mul_pd(a, b); }
+  static void store(double* out, Reg a) { _mm_storeu_pd(out, a); }
+};
+
+struct LI32 {
+  using T = int32_t;
+  using Reg = __m128i;
+  static constexpr size_t W = 4;
+  static Reg load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+  static Reg set1(T value) { return _mm_set1_epi32(value); }
+  // no pminsd / pmaxsd before SSE4.1, select with a comparison mask
+  static Reg select(Reg mask, Reg a, Reg b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+  static Reg min(Reg a, Reg b) { return select(_mm_cmplt_epi32(a, b), a, b); }
+  static Reg max(Reg a, Reg b) { return select(_mm_cmpgt_epi32(a, b), a, b); }
+  static void store(T* out, Reg a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+};
+
+struct LF32 {
+  using T = float;
+  using Reg = __m128;
+  static constexpr size_t W = 4;
+  static Reg load(const T* p) { return _mm_loadu_ps(p); }
+  static Reg set1(T value) { return _mm_set1_ps(value); }
+  static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+  static void store(T* out, Reg a) { _mm_storeu_ps(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+};
+
+struct LF64 {
+  using T = double;
+  using Reg = __m128d;
+  static constexpr size_t W = 2;
+  static Reg load(const T* p) { return _mm_loadu_pd(p); }
+  static Reg set1(T value) { return _mm_set1_pd(value); }
+  static Reg min(Reg a, Reg b) { return _mm_min_pd(a, b); }
+  static Reg max(Reg a, Reg b) { return _mm_max_pd(a, b); }
+  static void store(T* out, Reg a) { _mm_storeu_pd(out, a); }
+  static uint64_t eq_mask(Reg a, Reg b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+};
+
+}  // namespace
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::sse2_table() {
+  return make_table<I64, F64, LI32, LF32, LF64>();
+}
+
+#else
+
+ppc::reference::kernels::detail::KernelTable ppc::reference::kernels::detail::sse2_table() { return {}; }
+
+#endif
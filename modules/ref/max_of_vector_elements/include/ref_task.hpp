@@ -5,12 +5,15 @@
 
 #include <gtest/gtest.h>
 
-#include <algorithm>
 #include <memory>
-#include <numeric>
+#include <span>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -46,9 +49,7 @@ class MaxOfVectorElements : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    auto result = std::max_element(input_.begin(), input_.end());
-    max = static_cast<InOutType>(*result);
-    max_index = static_cast<IndexType>(std::distance(input_.begin(), result));
+    std::tie(max, max_index) = max_of(input_);
     return true;
   }
 
@@ -59,10 +60,31 @@ class MaxOfVectorElements : public ppc::core::Task {
     return true;
   }
 
+  // Batched path for many small inputs, the maximum of input i and its index go to
+  // values[i] and indexes[i]
+  static void run_batch(const ppc::core::Batch<InOutType>& batch, InOutType* values, IndexType* indexes,
+                        size_t num_threads = 0) {
+    ppc::core::parallel_for_batch(
+        batch.size(), batch.total_size(),
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            std::tie(values[i], indexes[i]) = max_of(batch[i]);
+          }
+        },
+        num_threads);
+  }
+
  private:
   std::vector<InOutType> input_;
   InOutType max;
   IndexType max_index;
+
+  // value and index of the first maximum, zeros for an empty input
+  static std::pair<InOutType, IndexType> max_of(std::span<const InOutType> input) {
+    if (input.empty()) return {InOutType{}, IndexType{}};
+    const size_t index = kernels::max_index_of(input);
+    return {input[index], static_cast<IndexType>(index)};
+  }
 };
 
 }  // namespace reference
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
 #include "ref/min_of_vector_elements/include/ref_task.hpp"
 
@@ -181,3 +182,38 @@ TEST(min_of_vector_elements, check_float) {
   EXPECT_NEAR(out[0], -1.01f, 1e-6f);
   ASSERT_EQ(out_index[0], 0ull);
 }
+
+TEST(min_of_vector_elements, check_batch_matches_single) {
+  // Create 5000 small inputs of 1..20 elements laid out contiguously
+  std::vector<uint64_t> offsets(1, 0);
+  for (size_t i = 0; i < 5000; i++) {
+    offsets.push_back(offsets.back() + i % 20 + 1);
+  }
+  std::vector<int32_t> data(offsets.back());
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<int32_t>(static_cast<int64_t>(i * 7919 % 201) - 100);
+  }
+
+  // Run the batch on 4 threads
+  std::vector<int32_t> out(offsets.size() - 1, -1);
+  std::vector<uint64_t> out_index(offsets.size() - 1, 0);
+  ppc::core::Batch<int32_t> batch(data, offsets);
+  ppc::reference::MinOfVectorElements<int32_t, uint64_t>::run_batch(batch, out.data(), out_index.data(), 4);
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    std::vector<int32_t> in(batch[i].begin(), batch[i].end());
+    std::vector<int32_t> single_out(1, 0);
+    std::vector<uint64_t> single_out_index(1, 0);
+    std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->add_input(in);
+    taskData->add_output(single_out);
+    taskData->add_output(single_out_index);
+    ppc::reference::MinOfVectorElements<int32_t, uint64_t> testTask(taskData);
+    ASSERT_EQ(testTask.validation(), true);
+    testTask.pre_processing();
+    testTask.run();
+    testTask.post_processing();
+    ASSERT_EQ(out[i], single_out[0]);
+    ASSERT_EQ(out_index[i], single_out_index[0]);
+  }
+}
@@ -5,12 +5,15 @@
 
 #include <gtest/gtest.h>
 
-#include <algorithm>
 #include <memory>
-#include <numeric>
+#include <span>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -46,9 +49,7 @@ class MinOfVectorElements : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    auto result = std::min_element(input_.begin(), input_.end());
-    min = static_cast<InOutType>(*result);
-    min_index = static_cast<IndexType>(std::distance(input_.begin(), result));
+    std::tie(min, min_index) = min_of(input_);
     return true;
   }
 
@@ -59,10 +60,31 @@ class MinOfVectorElements : public ppc::core::Task {
     return true;
   }
 
+  // Batched path for many small inputs, the minimum of input i and its index go to
+  // values[i] and indexes[i]
+  static void run_batch(const ppc::core::Batch<InOutType>& batch, InOutType* values, IndexType* indexes,
+                        size_t num_threads = 0) {
+    ppc::core::parallel_for_batch(
+        batch.size(), batch.total_size(),
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            std::tie(values[i], indexes[i]) = min_of(batch[i]);
+          }
+        },
+        num_threads);
+  }
+
  private:
   std::vector<InOutType> input_;
   InOutType min;
   IndexType min_index;
+
+  // value and index of the first minimum, zeros for an empty input
+  static std::pair<InOutType, IndexType> min_of(std::span<const InOutType> input) {
+    if (input.empty()) return {InOutType{}, IndexType{}};
+    const size_t index = kernels::min_index_of(input);
+    return {input[index], static_cast<IndexType>(index)};
+  }
 };
 
 }  // namespace reference
@@ -5,13 +5,11 @@
 
 #include <gtest/gtest.h>
 
-#include <algorithm>
-#include <functional>
 #include <memory>
-#include <numeric>
-#include <vector>
+#include <span>
 
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/neighbor_kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -22,12 +20,8 @@ class NearestNeighborElements : public ppc::core::Task {
   explicit NearestNeighborElements(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
   bool pre_processing() override {
     internal_order_test();
-    // Init vectors
-    input_ = std::vector<InOutType>(taskData->inputs_count[0]);
-    auto tmp_ptr = reinterpret_cast<InOutType*>(taskData->inputs[0]);
-    for (unsigned i = 0; i < taskData->inputs_count[0]; i++) {
-      input_[i] = tmp_ptr[i];
-    }
+    // Work on caller memory, no copy
+    input_ = taskData->input_span<InOutType>(0);
     // Init value for output
     l_elem = r_elem = 0;
     l_elem_index = r_elem_index = 0;
@@ -42,20 +36,14 @@ class NearestNeighborElements : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    auto rotate_in = input_;
-    int rot_left = 1;
-    rotate(rotate_in.begin(), rotate_in.begin() + rot_left, rotate_in.end());
-
-    auto temp_res = std::vector<InOutType>(input_.size());
-    std::transform(input_.begin(), input_.end(), rotate_in.begin(), temp_res.begin(),
-                   [](InOutType x, InOutType y) { return std::abs(x - y); });
-
-    auto result = std::min_element(temp_res.begin(), temp_res.end() - 1);
-    l_elem_index = static_cast<IndexType>(std::distance(temp_res.begin(), result));
-    l_elem = input_[l_elem_index];
-
+    // One pass over the neighbor pairs, no rotated copy or temporaries
+    kernels::NearestNeighbors<InOutType> scan;
+    scan.feed(input_);
+    if (!scan.op.found) return true;
+    l_elem = scan.op.left;
+    r_elem = scan.op.right;
+    l_elem_index = static_cast<IndexType>(scan.op.index);
     r_elem_index = l_elem_index + 1;
-    r_elem = input_[r_elem_index];
     return true;
   }
 
@@ -69,7 +57,7 @@ class NearestNeighborElements : public ppc::core::Task {
   }
 
  private:
-  std::vector<InOutType> input_;
+  std::span<const InOutType> input_;
   InOutType l_elem, r_elem;
   IndexType l_elem_index, r_elem_index;
 };
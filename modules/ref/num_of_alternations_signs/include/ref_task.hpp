@@ -5,13 +5,11 @@
 
 #include <gtest/gtest.h>
 
-#include <algorithm>
-#include <functional>
 #include <memory>
-#include <numeric>
-#include <vector>
+#include <span>
 
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/neighbor_kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -22,12 +20,8 @@ class NumOfAlternationsSigns : public ppc::core::Task {
   explicit NumOfAlternationsSigns(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
   bool pre_processing() override {
     internal_order_test();
-    // Init vectors
-    input_ = std::vector<InOutType>(taskData->inputs_count[0]);
-    auto tmp_ptr = reinterpret_cast<InOutType*>(taskData->inputs[0]);
-    for (unsigned i = 0; i < taskData->inputs_count[0]; i++) {
-      input_[i] = tmp_ptr[i];
-    }
+    // Work on caller memory, no copy
+    input_ = taskData->input_span<InOutType>(0);
     // Init value for output
     num = 0;
     return true;
@@ -41,14 +35,10 @@ class NumOfAlternationsSigns : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    auto rotate_in = input_;
-    int rot_left = 1;
-    rotate(rotate_in.begin(), rotate_in.begin() + rot_left, rotate_in.end());
-
-    auto temp_res = input_;
-    std::transform(input_.begin(), input_.end(), rotate_in.begin(), temp_res.begin(), std::multiplies<>());
-
-    num = std::count_if(temp_res.begin(), temp_res.end() - 1, [](InOutType elem) { return elem < 0; });
+    // One pass over the neighbor pairs, no rotated copy or temporaries
+    kernels::SignAlternations<InOutType> scan;
+    scan.feed(input_);
+    num = static_cast<CountType>(scan.op.count);
     return true;
   }
 
@@ -59,7 +49,7 @@ class NumOfAlternationsSigns : public ppc::core::Task {
   }
 
  private:
-  std::vector<InOutType> input_;
+  std::span<const InOutType> input_;
   CountType num;
 };
 
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
 #include "ref/sum_of_vector_elements/include/ref_task.hpp"
 
@@ -62,6 +63,46 @@ TEST(sum_of_vector_elements, check_double) {
   EXPECT_NEAR(out[0], in.size(), 1e-6);
 }
 
+TEST(sum_of_vector_elements, check_double_fractions) {
+  // Create data
+  std::vector<double> in(1001, 0.5);
+  std::vector<double> out(1, 0);
+  // Create TaskData
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t*>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t*>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+  // Create Task
+  ppc::reference::SumOfVectorElements<double> testTask(taskData, ppc::reference::kernels::Summation::KAHAN);
+  bool isValid = testTask.validation();
+  ASSERT_EQ(isValid, true);
+  testTask.pre_processing();
+  testTask.run();
+  testTask.post_processing();
+  ASSERT_EQ(out[0], 500.5);
+}
+
+TEST(sum_of_vector_elements, check_int64_t_beyond_int32_t) {
+  // Create data
+  std::vector<int64_t> in(10, 3000000000LL);
+  std::vector<int64_t> out(1, 0);
+  // Create TaskData
+  std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+  taskData->inputs.emplace_back(reinterpret_cast<uint8_t*>(in.data()));
+  taskData->inputs_count.emplace_back(in.size());
+  taskData->outputs.emplace_back(reinterpret_cast<uint8_t*>(out.data()));
+  taskData->outputs_count.emplace_back(out.size());
+  // Create Task
+  ppc::reference::SumOfVectorElements<int64_t> testTask(taskData);
+  bool isValid = testTask.validation();
+  ASSERT_EQ(isValid, true);
+  testTask.pre_processing();
+  testTask.run();
+  testTask.post_processing();
+  ASSERT_EQ(out[0], 30000000000LL);
+}
+
 TEST(sum_of_vector_elements, check_uint8_t) {
   // Create data
   std::vector<uint8_t> in(255, 1);
@@ -121,3 +162,34 @@ TEST(sum_of_vector_elements, check_float) {
   testTask.post_processing();
   EXPECT_NEAR(out[0], static_cast<float>(in.size()), 1e-3f);
 }
+
+TEST(sum_of_vector_elements, check_batch_matches_single) {
+  // Create 5000 small inputs of 0..19 elements laid out contiguously
+  std::vector<uint64_t> offsets(1, 0);
+  for (size_t i = 0; i < 5000; i++) {
+    offsets.push_back(offsets.back() + i % 20);
+  }
+  std::vector<int32_t> data(offsets.back());
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<int32_t>(static_cast<int64_t>(i * 7919 % 201) - 100);
+  }
+
+  // Run the batch on 4 threads
+  std::vector<int32_t> out(offsets.size() - 1, -1);
+  ppc::core::Batch<int32_t> batch(data, offsets);
+  ppc::reference::SumOfVectorElements<int32_t>::run_batch(batch, out.data(), 4);
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    std::vector<int32_t> in(batch[i].begin(), batch[i].end());
+    std::vector<int32_t> single_out(1, 0);
+    std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->add_input(in);
+    taskData->add_output(single_out);
+    ppc::reference::SumOfVectorElements<int32_t> testTask(taskData);
+    ASSERT_EQ(testTask.validation(), true);
+    testTask.pre_processing();
+    testTask.run();
+    testTask.post_processing();
+    ASSERT_EQ(out[i], single_out[0]);
+  }
+}
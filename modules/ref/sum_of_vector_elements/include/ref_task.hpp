@@ -5,25 +5,25 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <numeric>
+#include <span>
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/kernels.hpp"
 
 namespace ppc::reference {
 
 template <class InOutType>
 class SumOfVectorElements : public ppc::core::Task {
  public:
-  explicit SumOfVectorElements(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
+  explicit SumOfVectorElements(std::shared_ptr<ppc::core::TaskData> taskData_,
+                               kernels::Summation summation_ = kernels::Summation::PAIRWISE)
+      : Task(taskData_), summation(summation_) {}
   bool pre_processing() override {
     internal_order_test();
-    // Init vectors
-    input_ = std::vector<InOutType>(taskData->inputs_count[0]);
-    auto tmp_ptr = reinterpret_cast<InOutType*>(taskData->inputs[0]);
-    for (unsigned i = 0; i < taskData->inputs_count[0]; i++) {
-      input_[i] = tmp_ptr[i];
-    }
+    // Work on caller memory, no copy
+    input_ = taskData->input_span<InOutType>(0);
     // Init value for output
     sum = 0;
     return true;
@@ -37,7 +37,7 @@ class SumOfVectorElements : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    sum = std::accumulate(input_.begin(), input_.end(), 0);
+    sum = sum_of(input_, summation);
     return true;
   }
 
@@ -47,9 +47,27 @@ class SumOfVectorElements : public ppc::core::Task {
     return true;
   }
 
+  // Batched path for many small inputs, the sum of input i goes to out[i]
+  static void run_batch(const ppc::core::Batch<InOutType>& batch, InOutType* out, size_t num_threads = 0) {
+    ppc::core::parallel_for_batch(
+        batch.size(), batch.total_size(),
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            out[i] = sum_of(batch[i], kernels::Summation::PAIRWISE);
+          }
+        },
+        num_threads);
+  }
+
  private:
-  std::vector<InOutType> input_;
+  std::span<const InOutType> input_;
   InOutType sum;
+  kernels::Summation summation;
+
+  // accumulates in kernels::accumulator_t, not in InOutType
+  static InOutType sum_of(std::span<const InOutType> input, kernels::Summation summation) {
+    return static_cast<InOutType>(kernels::sum_of(input, summation));
+  }
 };
 
 }  // namespace ppc::reference
@@ -6,10 +6,12 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <numeric>
+#include <memory_resource>
+#include <span>
 #include <vector>
 
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -20,17 +22,14 @@ class SumValuesByRowsMatrix : public ppc::core::Task {
   explicit SumValuesByRowsMatrix(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
   bool pre_processing() override {
     internal_order_test();
-    // Init vectors
-    input_ = std::vector<InOutType>(taskData->inputs_count[0]);
+    // Init vectors, in scratch memory so repeated iterations don't allocate
     auto tmp_ptr = reinterpret_cast<InOutType*>(taskData->inputs[0]);
-    for (unsigned i = 0; i < taskData->inputs_count[0]; i++) {
-      input_[i] = tmp_ptr[i];
-    }
+    input_ = std::pmr::vector<InOutType>(tmp_ptr, tmp_ptr + taskData->inputs_count[0], &scratch);
     rows = reinterpret_cast<IndexType*>(taskData->inputs[1])[0];
     cols = reinterpret_cast<IndexType*>(taskData->inputs[1])[1];
 
     // Init value for output
-    sum_ = std::vector<InOutType>(cols, 0.f);
+    sum_ = std::pmr::vector<InOutType>(rows, 0, &scratch);
     return true;
   }
 
@@ -44,7 +43,8 @@ class SumValuesByRowsMatrix : public ppc::core::Task {
   bool run() override {
     internal_order_test();
     for (size_t i = 0; i < rows; i++) {
-      sum_[i] = std::accumulate(input_.begin() + cols * i, input_.begin() + cols * (i + 1), 0.f);
+      std::span<const InOutType> row(input_.data() + cols * i, cols);
+      sum_[i] = static_cast<InOutType>(kernels::sum_of(row));
     }
     return true;
   }
@@ -58,9 +58,9 @@ class SumValuesByRowsMatrix : public ppc::core::Task {
   }
 
  private:
-  std::vector<InOutType> input_;
+  std::pmr::vector<InOutType> input_{&scratch};
   IndexType rows, cols;
-  std::vector<InOutType> sum_;
+  std::pmr::vector<InOutType> sum_{&scratch};
 };
 
 }  // namespace reference
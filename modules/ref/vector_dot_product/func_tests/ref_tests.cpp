@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
 #include "ref/vector_dot_product/include/ref_task.hpp"
 
@@ -185,3 +186,42 @@ TEST(vector_dot_product, check_float) {
   testTask.post_processing();
   EXPECT_NEAR(out[0], in1.size() * (-1.3f) * 1.2f, 1e-3f);
 }
+
+TEST(vector_dot_product, check_batch_matches_single) {
+  // Create 5000 small inputs of 0..19 elements laid out contiguously
+  std::vector<uint64_t> offsets(1, 0);
+  for (size_t i = 0; i < 5000; i++) {
+    offsets.push_back(offsets.back() + i % 20);
+  }
+  std::vector<int32_t> data(offsets.back());
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<int32_t>(static_cast<int64_t>(i * 7919 % 201) - 100);
+  }
+  std::vector<int32_t> data_rhs(data.rbegin(), data.rend());
+
+  // Run the batch on 4 threads
+  std::vector<int32_t> out(offsets.size() - 1, -1);
+  ppc::core::Batch<int32_t> lhs(data, offsets);
+  ppc::core::Batch<int32_t> rhs(data_rhs, offsets);
+  ppc::reference::VectorDotProduct<int32_t>::run_batch(lhs, rhs, out.data(), 4);
+
+  for (size_t i = 0; i < lhs.size(); i++) {
+    std::vector<int32_t> in_lhs(lhs[i].begin(), lhs[i].end());
+    std::vector<int32_t> in_rhs(rhs[i].begin(), rhs[i].end());
+    std::vector<int32_t> single_out(1, 0);
+    std::shared_ptr<ppc::core::TaskData> taskData = std::make_shared<ppc::core::TaskData>();
+    taskData->add_input(in_lhs);
+    taskData->add_input(in_rhs);
+    taskData->add_output(single_out);
+    ppc::reference::VectorDotProduct<int32_t> testTask(taskData);
+    ASSERT_EQ(testTask.validation(), true);
+    testTask.pre_processing();
+    testTask.run();
+    testTask.post_processing();
+    ASSERT_EQ(out[i], single_out[0]);
+  }
+
+  std::vector<uint64_t> other_offsets(offsets.size(), 0);
+  ppc::core::Batch<int32_t> other(data_rhs, other_offsets);
+  EXPECT_ANY_THROW(ppc::reference::VectorDotProduct<int32_t>::run_batch(lhs, other, out.data()));
+}
@@ -6,10 +6,13 @@
 #include <gtest/gtest.h>
 
 #include <memory>
-#include <numeric>
+#include <span>
+#include <stdexcept>
 #include <vector>
 
+#include "core/task/include/batch.hpp"
 #include "core/task/include/task.hpp"
+#include "ref/kernels/include/kernels.hpp"
 
 namespace ppc {
 namespace reference {
@@ -17,7 +20,9 @@ namespace reference {
 template <class InOutType>
 class VectorDotProduct : public ppc::core::Task {
  public:
-  explicit VectorDotProduct(std::shared_ptr<ppc::core::TaskData> taskData_) : Task(taskData_) {}
+  explicit VectorDotProduct(std::shared_ptr<ppc::core::TaskData> taskData_,
+                            kernels::Summation summation_ = kernels::Summation::PAIRWISE)
+      : Task(taskData_), summation(summation_) {}
   bool pre_processing() override {
     internal_order_test();
     // Init vectors
@@ -43,7 +48,7 @@ class VectorDotProduct : public ppc::core::Task {
 
   bool run() override {
     internal_order_test();
-    dor_product = std::inner_product(input_[0].begin(), input_[0].end(), input_[1].begin(), 0.0);
+    dor_product = dot_of(input_[0], input_[1], summation);
     return true;
   }
 
@@ -53,9 +58,33 @@ class VectorDotProduct : public ppc::core::Task {
     return true;
   }
 
+  // Batched path for many small pairs of vectors, input i of lhs and of rhs must have
+  // the same length; their dot product goes to out[i]
+  static void run_batch(const ppc::core::Batch<InOutType>& lhs, const ppc::core::Batch<InOutType>& rhs, InOutType* out,
+                        size_t num_threads = 0) {
+    if (lhs.size() != rhs.size()) throw std::invalid_argument("VectorDotProduct: batches of different sizes");
+    for (size_t i = 0; i < lhs.size(); i++) {
+      if (lhs[i].size() != rhs[i].size()) throw std::invalid_argument("VectorDotProduct: vectors of different sizes");
+    }
+    ppc::core::parallel_for_batch(
+        lhs.size(), lhs.total_size(),
+        [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            out[i] = dot_of(lhs[i], rhs[i], kernels::Summation::PAIRWISE);
+          }
+        },
+        num_threads);
+  }
+
  private:
   std::vector<std::vector<InOutType> > input_;
   InOutType dor_product;
+  kernels::Summation summation;
+
+  static InOutType dot_of(std::span<const InOutType> lhs, std::span<const InOutType> rhs,
+                          kernels::Summation summation) {
+    return static_cast<InOutType>(kernels::dot_of(lhs, rhs, summation));
+  }
 };
 
 }  // namespace reference
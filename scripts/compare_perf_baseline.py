@@ -0,0 +1,159 @@
+import argparse
+import json
+import math
+import os
+import sys
+import time
+
+parser = argparse.ArgumentParser()
+parser.add_argument('-i', '--input', help='Perf records of the new run (.jsonl)', required=True)
+parser.add_argument('-b', '--baseline', help='Baseline file path (.json)', required=True)
+parser.add_argument('-s', '--summary', help='Output file path for the comparison summary (.json)')
+parser.add_argument('--update', action='store_true', help='Overwrite the baseline with the new run')
+parser.add_argument('--alpha', type=float, default=0.01, help='Significance level of the Mann-Whitney test')
+parser.add_argument('--threshold', type=float, default=0.05,
+                    help='Minimal relative slowdown of the median to report a regression')
+args = parser.parse_args()
+
+BASELINE_VERSION = 1
+# Mann-Whitney needs a few samples on each side, shorter runs are compared by time only
+MIN_SAMPLES = 5
+
+
+def record_key(record):
+    return record["backend"] + "/" + record["task_id"] + ":" + record["type_of_running"]
+
+
+def median(values):
+    values = sorted(values)
+    middle = len(values) // 2
+    if len(values) % 2:
+        return values[middle]
+    return (values[middle - 1] + values[middle]) / 2.0
+
+
+def read_records(path):
+    # the last record of a task wins, perf tests may be rerun into the same file
+    entries = {}
+    with open(path, "r") as records_file:
+        for line in records_file:
+            if not line.strip():
+                continue
+            record = json.loads(line)
+            samples = record.get("samples", [])
+            # print_perf_statistic writes time_sec = -1 when the task ran out of time
+            failed = record["time_sec"] <= 0 or any(sample <= 0 for sample in samples)
+            entries[record_key(record)] = {
+                "time_sec": record["time_sec"],
+                "num_running": record["num_running"],
+                "input_size": record["input_size"],
+                "samples": samples,
+                "median": median(samples) if samples else record["time_sec"] / max(record["num_running"], 1),
+                "failed": failed,
+                "hardware": record.get("hardware", {}),
+            }
+    return entries
+
+
+def mann_whitney_p_value(baseline, current):
+    # One-sided p-value of "current is slower than baseline", normal approximation
+    # with correction for ties and continuity
+    n1 = len(baseline)
+    n2 = len(current)
+    values = sorted([(value, 0) for value in baseline] + [(value, 1) for value in current])
+    rank_sum = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        rank = (i + j) / 2.0 + 1.0
+        rank_sum += rank * sum(1 for k in range(i, j + 1) if values[k][1] == 1)
+        tie_term += (j - i + 1) ** 3 - (j - i + 1)
+        i = j + 1
+    u = rank_sum - n2 * (n2 + 1) / 2.0
+    n = n1 + n2
+    sigma = math.sqrt(n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))))
+    if sigma == 0.0:
+        return 1.0
+    z = (u - n1 * n2 / 2.0 - 0.5) / sigma
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+def compare(baseline_entry, current_entry):
+    ratio = current_entry["median"] / baseline_entry["median"] if baseline_entry["median"] > 0 else 1.0
+    result = {"baseline_median": baseline_entry["median"], "current_median": current_entry["median"],
+              "ratio": ratio, "p_value": None}
+    if len(baseline_entry["samples"]) >= MIN_SAMPLES and len(current_entry["samples"]) >= MIN_SAMPLES:
+        p_value = mann_whitney_p_value(baseline_entry["samples"], current_entry["samples"])
+        improvement_p_value = mann_whitney_p_value(current_entry["samples"], baseline_entry["samples"])
+        result["p_value"] = p_value
+        if p_value < args.alpha and ratio > 1.0 + args.threshold:
+            result["status"] = "regression"
+        elif improvement_p_value < args.alpha and ratio < 1.0 - args.threshold:
+            result["status"] = "improvement"
+            result["p_value"] = improvement_p_value
+        else:
+            result["status"] = "unchanged"
+    else:
+        # single measurement per run, without a test only large changes are reported
+        if ratio > 1.0 + 2.0 * args.threshold:
+            result["status"] = "regression"
+        elif ratio < 1.0 - 2.0 * args.threshold:
+            result["status"] = "improvement"
+        else:
+            result["status"] = "unchanged"
+    return result
+
+
+current = read_records(os.path.abspath(args.input))
+baseline_path = os.path.abspath(args.baseline)
+
+if args.update or not os.path.exists(baseline_path):
+    with open(baseline_path, "w") as baseline_file:
+        json.dump({"version": BASELINE_VERSION, "timestamp": int(time.time()), "entries": current},
+                  baseline_file, indent=1, sort_keys=True)
+    print("Baseline with " + str(len(current)) + " tasks is written to " + baseline_path)
+    sys.exit(0)
+
+with open(baseline_path, "r") as baseline_file:
+    baseline_data = json.load(baseline_file)
+if baseline_data.get("version") != BASELINE_VERSION:
+    print("Unsupported baseline version: " + str(baseline_data.get("version")))
+    sys.exit(2)
+baseline = baseline_data["entries"]
+
+summary = {"failed": {}, "regression": {}, "improvement": {}, "unchanged": {}, "new": [], "missing": []}
+for key in sorted(current):
+    if current[key]["failed"]:
+        # a timeout fails the comparison even without a baseline
+        summary["failed"][key] = {"baseline_median": baseline[key]["median"] if key in baseline else None,
+                                  "current_median": current[key]["median"]}
+        continue
+    # a baseline that timed out has no time to compare with either
+    if key not in baseline or baseline[key].get("failed"):
+        summary["new"].append(key)
+        continue
+    if baseline[key].get("hardware", {}).get("cpu_model") != current[key]["hardware"].get("cpu_model"):
+        print("Warning: " + key + " baseline was measured on other hardware")
+    result = compare(baseline[key], current[key])
+    summary[result.pop("status")][key] = result
+summary["missing"] = sorted(key for key in baseline if key not in current)
+
+for key in summary["failed"]:
+    print("failed:" + key + ": timed out or has no valid time")
+for status in ["regression", "improvement"]:
+    for key, result in summary[status].items():
+        p_value = "n/a" if result["p_value"] is None else "%.2g" % result["p_value"]
+        print(status + ":" + key + ":" + "%.10f" % result["baseline_median"] + " -> " +
+              "%.10f" % result["current_median"] + " (x%.3f, p=%s)" % (result["ratio"], p_value))
+print("Perf comparison: " + str(len(summary["failed"])) + " failed, " + str(len(summary["regression"])) +
+      " regressions, " + str(len(summary["improvement"])) + " improvements, " + str(len(summary["unchanged"])) +
+      " unchanged, " + str(len(summary["new"])) + " new, " + str(len(summary["missing"])) + " missing")
+
+if args.summary:
+    with open(os.path.abspath(args.summary), "w") as summary_file:
+        json.dump(summary, summary_file, indent=1, sort_keys=True)
+
+sys.exit(1 if summary["failed"] or summary["regression"] else 0)
@@ -1,11 +1,13 @@
 import argparse
+import json
 import os
 import re
 import xlsxwriter
 import multiprocessing
 
 parser = argparse.ArgumentParser()
-parser.add_argument('-i', '--input', help='Input file path (logs of perf tests, .txt)', required=True)
+parser.add_argument('-i', '--input', help='Input file path (logs of perf tests, .txt, or perf records, .jsonl)',
+                    required=True)
 parser.add_argument('-o', '--output', help='Output file path (path to .xlsx table)', required=True)
 args = parser.parse_args()
 logs_path = os.path.abspath(args.input)
@@ -16,30 +18,31 @@ list_of_type_of_tasks = ["mpi", "omp", "seq", "stl", "tbb"]
 result_tables = {"pipeline": {}, "task_run": {}}
 set_of_task_name = []
 
-logs_file = open(logs_path, "r")
-logs_lines = logs_file.readlines()
-for line in logs_lines:
-    pattern = r'tasks[\/|\\](\w*)[\/|\\](\w*):(\w*):(-*\d*\.\d*)'
-    result = re.findall(pattern, line)
-    if len(result):
-        task_name = result[0][1]
-        perf_type = result[0][2]
-        set_of_task_name.append(task_name)
-        result_tables[perf_type][task_name] = {}
 
-        for ttype in list_of_type_of_tasks:
-            result_tables[perf_type][task_name][ttype] = -1.0
+def add_result(task_type, task_name, perf_type, perf_time):
+    if task_name not in result_tables[perf_type]:
+        set_of_task_name.append(task_name)
+        result_tables[perf_type][task_name] = {ttype: -1.0 for ttype in list_of_type_of_tasks}
+    result_tables[perf_type][task_name][task_type] = perf_time
 
-for line in logs_lines:
-    pattern = r'tasks[\/|\\](\w*)[\/|\\](\w*):(\w*):(-*\d*\.\d*)'
-    result = re.findall(pattern, line)
-    if len(result):
-        task_type = result[0][0]
-        task_name = result[0][1]
-        perf_type = result[0][2]
-        perf_time = float(result[0][3])
-        result_tables[perf_type][task_name][task_type] = perf_time
 
+if logs_path.endswith(".jsonl"):
+    # records written by ppc::core::Perf::print_perf_statistic when PPC_PERF_OUTPUT is set
+    with open(logs_path, "r") as records_file:
+        for line in records_file:
+            if not line.strip():
+                continue
+            record = json.loads(line)
+            if record["backend"] in list_of_type_of_tasks and record["type_of_running"] in result_tables:
+                add_result(record["backend"], record["task_id"], record["type_of_running"], record["time_sec"])
+else:
+    logs_file = open(logs_path, "r")
+    logs_lines = logs_file.readlines()
+    for line in logs_lines:
+        pattern = r'tasks[\/|\\](\w*)[\/|\\](\w*):(\w*):(-*\d*\.\d*)'
+        result = re.findall(pattern, line)
+        if len(result):
+            add_result(result[0][0], result[0][1], result[0][2], float(result[0][3]))
 
 for table_name in result_tables:
     workbook = xlsxwriter.Workbook(os.path.join(xlsx_path, table_name + '_perf_table.xlsx'))
@@ -1,4 +1,9 @@
 @echo off
 mkdir build\perf_stat_dir
+set PPC_PERF_OUTPUT=build\perf_stat_dir\perf_results.jsonl
+if exist %PPC_PERF_OUTPUT% del %PPC_PERF_OUTPUT%
+rem one sample per run after a warmup run, for the Mann-Whitney test of compare_perf_baseline.py
+set PPC_PERF_STATISTICAL=1
 scripts\run_perf_collector.bat > build\perf_stat_dir\perf_log.txt
-python scripts\create_perf_table.py --input build\perf_stat_dir\perf_log.txt --output build\perf_stat_dir
+python scripts\create_perf_table.py --input %PPC_PERF_OUTPUT% --output build\perf_stat_dir
+if not "%PPC_PERF_BASELINE%"=="" python scripts\compare_perf_baseline.py --input %PPC_PERF_OUTPUT% --baseline %PPC_PERF_BASELINE% --summary build\perf_stat_dir\perf_comparison.json
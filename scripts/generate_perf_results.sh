@@ -1,3 +1,11 @@
 mkdir build/perf_stat_dir
+export PPC_PERF_OUTPUT=build/perf_stat_dir/perf_results.jsonl
+rm -f $PPC_PERF_OUTPUT
+# one sample per run after a warmup run, for the Mann-Whitney test of compare_perf_baseline.py
+export PPC_PERF_STATISTICAL=1
 source scripts/run_perf_collector.sh 2>&1 | tee build/perf_stat_dir/perf_log.txt
-python3 scripts/create_perf_table.py --input build/perf_stat_dir/perf_log.txt --output build/perf_stat_dir
+python3 scripts/create_perf_table.py --input $PPC_PERF_OUTPUT --output build/perf_stat_dir
+if [ -n "$PPC_PERF_BASELINE" ]; then
+  python3 scripts/compare_perf_baseline.py --input $PPC_PERF_OUTPUT --baseline $PPC_PERF_BASELINE \
+    --summary build/perf_stat_dir/perf_comparison.json
+fi
@@ -6,10 +6,12 @@
 #include <boost/mpi/communicator.hpp>
 #include <memory>
 #include <numeric>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "core/collectives/include/nonblocking.hpp"
 #include "core/task/include/task.hpp"
 
 namespace budazhapova_e_matrix_mult_mpi {
@@ -40,16 +42,24 @@ class MatrixMultParallel : public ppc::core::Task {
   bool post_processing() override;
 
  private:
+  // messages of the rows of every rank
+  static constexpr int CHUNKS = 4;
+  static int chunk_begin(int local_rows, int k) { return local_rows * k / CHUNKS; }
+
   int rows{};
   int columns{};
 
-  std::vector<int> A;
+  std::span<const int> A;
   std::vector<int> b;
   std::vector<int> res;
 
+  int local_rows{};
   std::vector<int> local_res;
   std::vector<int> local_A;
 
+  ppc::core::collectives::Request b_request;
+  std::vector<ppc::core::collectives::Request> chunks;
+
   boost::mpi::communicator world;
 };
 
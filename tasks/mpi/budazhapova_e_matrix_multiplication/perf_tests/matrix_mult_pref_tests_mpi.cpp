@@ -19,10 +19,10 @@ TEST(budazhapova_e_matrix_mult_mpi, test_pipeline_run) {
   if (world.rank() == 0) {
     taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t*>(A_matrix.data()));
     taskDataPar->inputs_count.emplace_back(A_matrix.size());
-    taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t*>(A_matrix.data()));
-    taskDataPar->inputs_count.emplace_back(A_matrix.size());
-    taskDataPar->outputs.emplace_back(reinterpret_cast<uint8_t*>(b_vector.data()));
-    taskDataPar->outputs_count.emplace_back(b_vector.size());
+    taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t*>(b_vector.data()));
+    taskDataPar->inputs_count.emplace_back(b_vector.size());
+    taskDataPar->outputs.emplace_back(reinterpret_cast<uint8_t*>(out.data()));
+    taskDataPar->outputs_count.emplace_back(out.size());
   }
 
   auto testMpiTaskParallel = std::make_shared<budazhapova_e_matrix_mult_mpi::MatrixMultParallel>(taskDataPar);
@@ -56,10 +56,10 @@ TEST(budazhapova_e_matrix_mult_mpi, test_task_run) {
   if (world.rank() == 0) {
     taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t*>(A_matrix.data()));
     taskDataPar->inputs_count.emplace_back(A_matrix.size());
-    taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t*>(A_matrix.data()));
-    taskDataPar->inputs_count.emplace_back(A_matrix.size());
-    taskDataPar->outputs.emplace_back(reinterpret_cast<uint8_t*>(b_vector.data()));
-    taskDataPar->outputs_count.emplace_back(b_vector.size());
+    taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t*>(b_vector.data()));
+    taskDataPar->inputs_count.emplace_back(b_vector.size());
+    taskDataPar->outputs.emplace_back(reinterpret_cast<uint8_t*>(out.data()));
+    taskDataPar->outputs_count.emplace_back(out.size());
   }
 
   auto testMpiTaskParallel = std::make_shared<budazhapova_e_matrix_mult_mpi::MatrixMultParallel>(taskDataPar);
@@ -8,8 +8,11 @@
 #include <iostream>
 #include <random>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "core/distribution/include/distribution_mpi.hpp"
+
 bool budazhapova_e_matrix_mult_mpi::MatrixMultSequential::pre_processing() {
   internal_order_test();
   A = std::vector<int>(reinterpret_cast<int*>(taskData->inputs[0]),
@@ -51,18 +54,40 @@ bool budazhapova_e_matrix_mult_mpi::MatrixMultSequential::post_processing() {
 
 bool budazhapova_e_matrix_mult_mpi::MatrixMultParallel::pre_processing() {
   internal_order_test();
-
-  std::vector<int> recv_counts(world.size(), 0);
-  std::vector<int> displacements(world.size(), 0);
+  namespace collectives = ppc::core::collectives;
 
   if (world.rank() == 0) {
-    A = std::vector<int>(reinterpret_cast<int*>(taskData->inputs[0]),
-                         reinterpret_cast<int*>(taskData->inputs[0]) + taskData->inputs_count[0]);
-    b = std::vector<int>(reinterpret_cast<int*>(taskData->inputs[1]),
-                         reinterpret_cast<int*>(taskData->inputs[1]) + taskData->inputs_count[1]);
+    A = taskData->input_span<int>(0);
     columns = taskData->inputs_count[1];
     rows = taskData->inputs_count[0] / columns;
-    res = std::vector<int>(rows, 0);
+  }
+  boost::mpi::broadcast(world, columns, 0);
+  boost::mpi::broadcast(world, rows, 0);
+  b.resize(columns);
+  if (world.rank() == 0) {
+    const auto input_b = taskData->input_span<int>(1);
+    std::copy(input_b.begin(), input_b.end(), b.begin());
+  }
+  b_request = collectives::ibcast(world, b.data(), b.size(), 0);
+
+  // rows of A in blocks, the first rows % size ranks get a row more. Every block goes in
+  // CHUNKS scatters, so that run() multiplies the rows of a chunk while the next ones are
+  // on the way; rank 0 keeps its rows in the caller memory of A.
+  const ppc::core::Distribution distribution(rows, world.size());
+  local_rows = static_cast<int>(distribution.count(world.rank()));
+  chunks.clear();
+  local_A.resize(world.rank() == 0 ? 0 : static_cast<size_t>(local_rows) * columns);
+  for (int k = 0; k < CHUNKS; k++) {
+    std::vector<int> counts(world.size());
+    std::vector<int> displacements(world.size());
+    for (int proc = 0; proc < world.size(); proc++) {
+      const int count = static_cast<int>(distribution.count(proc));
+      counts[proc] = (chunk_begin(count, k + 1) - chunk_begin(count, k)) * columns;
+      displacements[proc] = (static_cast<int>(distribution.displacement(proc)) + chunk_begin(count, k)) * columns;
+    }
+    int* chunk =
+        world.rank() == 0 ? nullptr : local_A.data() + static_cast<size_t>(chunk_begin(local_rows, k)) * columns;
+    chunks.push_back(collectives::iscatterv(world, A.data(), std::move(counts), std::move(displacements), chunk, 0));
   }
   return true;
 }
@@ -79,70 +104,21 @@ bool budazhapova_e_matrix_mult_mpi::MatrixMultParallel::validation() {
 
 bool budazhapova_e_matrix_mult_mpi::MatrixMultParallel::run() {
   internal_order_test();
-  std::vector<int> recv_counts(world.size(), 0);
-  std::vector<int> displacements(world.size(), 0);
-
-  boost::mpi::broadcast(world, columns, 0);
-  boost::mpi::broadcast(world, rows, 0);
-  boost::mpi::broadcast(world, A, 0);
-  boost::mpi::broadcast(world, b, 0);
-
-  int n_of_send_rows;
-  int n_of_proc_with_extra_row;
-  int start_row;
-  int end_row;
-  int world_size = world.size();
-  int world_rank = world.rank();
-
-  for (int i = 0; i < world_size; i++) {
-    n_of_send_rows = rows / world_size;
-    n_of_proc_with_extra_row = rows % world_size;
-
-    start_row = i * n_of_send_rows + std::min(i, n_of_proc_with_extra_row);
-    end_row = start_row + n_of_send_rows + (i < n_of_proc_with_extra_row ? 1 : 0);
-    recv_counts[i] = end_row - start_row;
-    displacements[i] = (i == 0) ? 0 : displacements[i - 1] + recv_counts[i - 1];
-  }
-
-  n_of_send_rows = rows / world_size;
-  n_of_proc_with_extra_row = rows % world_size;
-
-  start_row = world_rank * n_of_send_rows + std::min(world_rank, n_of_proc_with_extra_row);
-  end_row = start_row + n_of_send_rows + (world_rank < n_of_proc_with_extra_row ? 1 : 0);
-
-  if (world.size() > rows) {
-    if (world.rank() < rows) {
-      local_A.resize(columns);
-      local_res.resize(1);
-      for (int i = start_row; i < end_row; i++) {
-        for (int j = 0; j < columns; j++) {
-          local_A[(i - start_row) * columns + j] = A[i * columns + j];
-        }
-      }
-    } else {
-      local_A.clear();
-      local_res.clear();
-      return true;
-    }
-  } else {
-    local_A.resize((end_row - start_row) * columns);
-    local_res.resize(end_row - start_row, 0);
-
-    for (int i = start_row; i < end_row; i++) {
+  // rank 0 multiplies its rows in the caller memory of A
+  const int* rows_of_A = world.rank() == 0 ? A.data() : local_A.data();
+  local_res.assign(local_rows, 0);
+  b_request.wait();
+  for (int k = 0; k < CHUNKS; k++) {
+    chunks[k].wait();
+    for (int i = chunk_begin(local_rows, k); i < chunk_begin(local_rows, k + 1); i++) {
       for (int j = 0; j < columns; j++) {
-        local_A[(i - start_row) * columns + j] = A[i * columns + j];
+        local_res[i] += rows_of_A[static_cast<size_t>(i) * columns + j] * b[j];
       }
     }
   }
 
-  for (size_t i = 0; i < local_res.size(); i++) {
-    local_res[i] = 0;
-    for (int j = 0; j < columns; j++) {
-      local_res[i] += local_A[i * columns + j] * b[j];
-    }
-  }
-  res.resize(rows);
-  boost::mpi::gatherv(world, local_res.data(), local_res.size(), res.data(), recv_counts, displacements, 0);
+  res.resize(world.rank() == 0 ? rows : 0);
+  ppc::core::gatherv(world, local_res.data(), res.data(), ppc::core::Distribution(rows, world.size()));
   return true;
 }
 
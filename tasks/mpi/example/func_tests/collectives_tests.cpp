@@ -0,0 +1,234 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "core/collectives/include/collectives.hpp"
+
+namespace collectives = ppc::core::collectives;
+using collectives::Algorithm;
+using collectives::Collective;
+
+namespace {
+
+// counts around the corner cases: empty, fewer elements than ranks, uneven blocks, several
+// CHAIN segments
+const std::vector<size_t> COUNTS = {0, 1, 3, 1001, 3 * collectives::CHAIN_SEGMENT / sizeof(int64_t) + 5};
+
+int64_t value_of(int rank, size_t i) { return static_cast<int64_t>(rank) * 1000003 + static_cast<int64_t>(i % 997); }
+
+std::vector<int> roots_of(const boost::mpi::communicator& world) {
+  if (world.size() == 1) return {0};
+  return {0, world.size() - 1};
+}
+
+}  // namespace
+
+TEST(collectives_tests, check_broadcast) {
+  boost::mpi::communicator world;
+  for (auto algorithm : collectives::algorithms_of(Collective::BROADCAST)) {
+    for (size_t count : COUNTS) {
+      for (int root : roots_of(world)) {
+        std::vector<int64_t> data(count, -1);
+        if (world.rank() == root) {
+          for (size_t i = 0; i < count; i++) data[i] = value_of(root, i);
+        }
+        collectives::broadcast(world, data.data(), count, root, algorithm);
+        for (size_t i = 0; i < count; i++) {
+          ASSERT_EQ(data[i], value_of(root, i)) << collectives::to_string(algorithm) << " count " << count;
+        }
+      }
+    }
+  }
+}
+
+TEST(collectives_tests, check_broadcast_segments) {
+  boost::mpi::communicator world;
+  // a communicator of its own, the segment of world stays as it is
+  boost::mpi::communicator comm(world, boost::mpi::comm_duplicate);
+  // the default until the segment is tuned or set, never a tuning in the middle of a broadcast
+  if (std::getenv("PPC_BCAST_SEGMENT") == nullptr) {
+    EXPECT_EQ(collectives::broadcast_segment(comm), collectives::CHAIN_SEGMENT);
+  }
+  const size_t tuned = collectives::tune_broadcast_segment(comm);
+  EXPECT_NE(std::find(collectives::SEGMENT_CANDIDATES.begin(), collectives::SEGMENT_CANDIDATES.end(), tuned),
+            collectives::SEGMENT_CANDIDATES.end());
+  size_t max_tuned = 0;
+  boost::mpi::all_reduce(comm, tuned, max_tuned, boost::mpi::maximum<size_t>());
+  EXPECT_EQ(max_tuned, tuned);
+
+  // segments of three elements and a short last one
+  collectives::set_broadcast_segment(comm, 3 * sizeof(int64_t));
+  for (auto algorithm : {Algorithm::CHAIN, Algorithm::BINARY_TREE}) {
+    for (int root : roots_of(comm)) {
+      std::vector<int64_t> data(1001, -1);
+      if (comm.rank() == root) {
+        for (size_t i = 0; i < data.size(); i++) data[i] = value_of(root, i);
+      }
+      collectives::broadcast(comm, data.data(), data.size(), root, algorithm);
+      for (size_t i = 0; i < data.size(); i++) {
+        ASSERT_EQ(data[i], value_of(root, i)) << collectives::to_string(algorithm);
+      }
+    }
+  }
+  EXPECT_THROW(collectives::set_broadcast_segment(comm, 0), std::invalid_argument);
+}
+
+TEST(collectives_tests, check_reduce) {
+  boost::mpi::communicator world;
+  for (auto algorithm : collectives::algorithms_of(Collective::REDUCE)) {
+    for (size_t count : COUNTS) {
+      for (int root : roots_of(world)) {
+        std::vector<int64_t> in(count);
+        for (size_t i = 0; i < count; i++) in[i] = value_of(world.rank(), i);
+        std::vector<int64_t> out(count, -1);
+        collectives::reduce(world, in.data(), out.data(), count, std::plus<>(), root, algorithm);
+        if (world.rank() != root) continue;
+        for (size_t i = 0; i < count; i++) {
+          int64_t expected = 0;
+          for (int r = 0; r < world.size(); r++) expected += value_of(r, i);
+          ASSERT_EQ(out[i], expected) << collectives::to_string(algorithm) << " count " << count;
+        }
+      }
+    }
+  }
+}
+
+TEST(collectives_tests, check_all_reduce) {
+  boost::mpi::communicator world;
+  for (auto algorithm : collectives::algorithms_of(Collective::ALL_REDUCE)) {
+    for (size_t count : COUNTS) {
+      // in place
+      std::vector<int64_t> data(count);
+      for (size_t i = 0; i < count; i++) data[i] = value_of(world.rank(), i);
+      collectives::all_reduce(world, data.data(), data.data(), count, boost::mpi::maximum<int64_t>(), algorithm);
+      for (size_t i = 0; i < count; i++) {
+        ASSERT_EQ(data[i], value_of(world.size() - 1, i)) << collectives::to_string(algorithm) << " count " << count;
+      }
+    }
+  }
+}
+
+TEST(collectives_tests, check_all_reduce_matches_boost) {
+  boost::mpi::communicator world;
+  std::vector<double> in(777);
+  for (size_t i = 0; i < in.size(); i++) in[i] = 0.5 * static_cast<double>(value_of(world.rank(), i));
+  std::vector<double> expected(in.size());
+  boost::mpi::all_reduce(world, in.data(), static_cast<int>(in.size()), expected.data(), std::plus<>());
+  for (auto algorithm : collectives::algorithms_of(Collective::ALL_REDUCE)) {
+    std::vector<double> out(in.size());
+    collectives::all_reduce(world, in.data(), out.data(), in.size(), std::plus<>(), algorithm);
+    // the sums are of exact halves, any order of additions gives the same result
+    EXPECT_EQ(out, expected) << collectives::to_string(algorithm);
+  }
+}
+
+TEST(collectives_tests, check_all_reduce_user_operator) {
+  boost::mpi::communicator world;
+  // gcd is associative and commutative but not an operation of MPI
+  const auto gcd = [](int64_t a, int64_t b) { return std::gcd(a, b); };
+  for (auto algorithm : collectives::algorithms_of(Collective::ALL_REDUCE)) {
+    std::vector<int64_t> data(1001);
+    for (size_t i = 0; i < data.size(); i++) data[i] = 6 * static_cast<int64_t>(i) * (world.rank() + 2);
+    collectives::all_reduce(world, data.data(), data.data(), data.size(), gcd, algorithm);
+    for (size_t i = 0; i < data.size(); i++) {
+      const int64_t expected = world.size() == 1 ? 12 * static_cast<int64_t>(i) : 6 * static_cast<int64_t>(i);
+      ASSERT_EQ(data[i], expected) << collectives::to_string(algorithm);
+    }
+  }
+}
+
+TEST(collectives_tests, check_all_reduce_locations) {
+  boost::mpi::communicator world;
+  const int rank = world.rank();
+  const int p = world.size();
+  // element i is least on rank i % p and greatest on rank (i + 1) % p, the first of the
+  // elements is equal on all ranks
+  std::vector<collectives::ValueLocation<double>> in(301);
+  for (size_t i = 0; i < in.size(); i++) {
+    const int position = (rank - static_cast<int>(i % p) + p) % p;
+    in[i] = {i == 0 ? 1.0 : -0.5 * position - static_cast<double>(i), rank};
+  }
+  for (auto algorithm : collectives::algorithms_of(Collective::ALL_REDUCE)) {
+    std::vector<collectives::ValueLocation<double>> min(in.size());
+    std::vector<collectives::ValueLocation<double>> max(in.size());
+    collectives::all_reduce(world, in.data(), min.data(), in.size(), collectives::min_location(), algorithm);
+    collectives::all_reduce(world, in.data(), max.data(), in.size(), collectives::max_location(), algorithm);
+    EXPECT_EQ(min[0].location, 0) << collectives::to_string(algorithm);
+    EXPECT_EQ(max[0].location, 0) << collectives::to_string(algorithm);
+    for (size_t i = 1; i < in.size(); i++) {
+      ASSERT_EQ(max[i].location, static_cast<int>(i % p)) << collectives::to_string(algorithm);
+      ASSERT_EQ(min[i].location, static_cast<int>((i + p - 1) % p)) << collectives::to_string(algorithm);
+      ASSERT_EQ(max[i].value, -static_cast<double>(i)) << collectives::to_string(algorithm);
+    }
+  }
+}
+
+TEST(collectives_tests, check_all_reduce_of_one_value) {
+  boost::mpi::communicator world;
+  // negative floats, below std::numeric_limits<float>::min()
+  const float max = collectives::all_reduce(world, -1.0F - static_cast<float>(world.rank()),
+                                            boost::mpi::maximum<float>());
+  EXPECT_EQ(max, -1.0F);
+  const auto min = collectives::all_reduce(
+      world, collectives::ValueLocation<float>{static_cast<float>(world.rank() % 2), world.rank()},
+      collectives::min_location());
+  EXPECT_EQ(min.value, 0.0F);
+  EXPECT_EQ(min.location, 0);
+}
+
+TEST(collectives_tests, check_scatter_and_gather) {
+  boost::mpi::communicator world;
+  for (auto algorithm : collectives::algorithms_of(Collective::SCATTER)) {
+    for (size_t count : COUNTS) {
+      for (int root : roots_of(world)) {
+        std::vector<int64_t> all;
+        if (world.rank() == root) {
+          for (int r = 0; r < world.size(); r++) {
+            for (size_t i = 0; i < count; i++) all.push_back(value_of(r, i));
+          }
+        }
+        std::vector<int64_t> block(count, -1);
+        collectives::scatter(world, all.data(), block.data(), count, root, algorithm);
+        for (size_t i = 0; i < count; i++) {
+          ASSERT_EQ(block[i], value_of(world.rank(), i)) << collectives::to_string(algorithm) << " count " << count;
+        }
+
+        std::vector<int64_t> gathered(world.rank() == root ? world.size() * count : 0, -1);
+        collectives::gather(world, block.data(), gathered.data(), count, root, algorithm);
+        if (world.rank() == root) {
+          ASSERT_EQ(gathered, all) << collectives::to_string(algorithm) << " count " << count;
+        }
+      }
+    }
+  }
+}
+
+TEST(collectives_tests, check_select_algorithm) {
+  EXPECT_EQ(collectives::select_algorithm(Collective::BROADCAST, 16, 64), Algorithm::BINOMIAL);
+  EXPECT_EQ(collectives::select_algorithm(Collective::BROADCAST, 16, collectives::LONG_MESSAGE),
+            Algorithm::BINARY_TREE);
+  EXPECT_EQ(collectives::select_algorithm(Collective::BROADCAST, 16, 64 * collectives::CHAIN_SEGMENT),
+            Algorithm::CHAIN);
+  EXPECT_EQ(collectives::select_algorithm(Collective::ALL_REDUCE, 16, 64), Algorithm::RECURSIVE_DOUBLING);
+  EXPECT_EQ(collectives::select_algorithm(Collective::ALL_REDUCE, 16, collectives::LONG_MESSAGE),
+            Algorithm::RABENSEIFNER);
+  EXPECT_EQ(collectives::select_algorithm(Collective::ALL_REDUCE, 12, collectives::LONG_MESSAGE), Algorithm::RING);
+  EXPECT_EQ(collectives::select_algorithm(Collective::GATHER, 16, collectives::LONG_MESSAGE), Algorithm::LINEAR);
+}
+
+TEST(collectives_tests, check_unsupported_arguments) {
+  boost::mpi::communicator world;
+  std::vector<int> data(4);
+  EXPECT_THROW(collectives::broadcast(world, data.data(), data.size(), 0, Algorithm::RECURSIVE_DOUBLING),
+               std::invalid_argument);
+  EXPECT_THROW(collectives::broadcast(world, data.data(), data.size(), world.size()), std::invalid_argument);
+}
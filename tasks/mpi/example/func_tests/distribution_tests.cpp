@@ -0,0 +1,74 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <boost/mpi/communicator.hpp>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "core/distribution/include/distribution_mpi.hpp"
+
+using ppc::core::Distribution;
+using ppc::core::Distribution2D;
+using ppc::core::Scheme;
+
+namespace {
+
+// scatterv() and gatherv() of the numbers 0..size - 1 with distribution from root
+template <class Layout>
+void check_round_trip(const boost::mpi::communicator& world, const Layout& distribution, int root) {
+  std::vector<int> global;
+  if (world.rank() == root) {
+    global.resize(distribution.size());
+    std::iota(global.begin(), global.end(), 0);
+  }
+  std::vector<int> part(distribution.count(world.rank()), -1);
+  ppc::core::scatterv(world, global.data(), part.data(), distribution, root);
+  std::vector<int> all(distribution.size());
+  std::iota(all.begin(), all.end(), 0);
+  std::vector<int> packed(all.size());
+  distribution.pack(all.data(), packed.data());
+  const auto begin = packed.begin() + static_cast<std::ptrdiff_t>(distribution.displacement(world.rank()));
+  EXPECT_EQ(part, std::vector<int>(begin, begin + static_cast<std::ptrdiff_t>(part.size())));
+
+  std::vector<int> gathered(world.rank() == root ? distribution.size() : 0, -1);
+  ppc::core::gatherv(world, part.data(), gathered.data(), distribution, root);
+  if (world.rank() == root) {
+    EXPECT_EQ(gathered, global);
+  }
+}
+
+}  // namespace
+
+TEST(distribution_mpi_tests, check_1d_schemes) {
+  boost::mpi::communicator world;
+  for (auto scheme : {Scheme::BLOCK, Scheme::CYCLIC, Scheme::BLOCK_CYCLIC}) {
+    for (size_t size : {0, 5, 120, 1001}) {
+      check_round_trip(world, Distribution(size, world.size(), scheme, 7), 0);
+      check_round_trip(world, Distribution(size, world.size(), scheme, 7), world.size() - 1);
+    }
+  }
+}
+
+TEST(distribution_mpi_tests, check_2d_partitions) {
+  boost::mpi::communicator world;
+  const int p = world.size();
+  check_round_trip(world, Distribution2D::by_rows(13, 9, p), 0);
+  check_round_trip(world, Distribution2D::by_rows(13, 9, p, Scheme::BLOCK_CYCLIC, 2), 0);
+  check_round_trip(world, Distribution2D::by_columns(13, 9, p, Scheme::CYCLIC), p - 1);
+  // the largest grid of p ranks with at most as many rows as columns
+  int grid_rows = 1;
+  for (int r = 1; r * r <= p; r++) {
+    if (p % r == 0) grid_rows = r;
+  }
+  check_round_trip(world, Distribution2D::by_tiles(13, 9, grid_rows, p / grid_rows), 0);
+  check_round_trip(world, Distribution2D::by_tiles(13, 9, grid_rows, p / grid_rows, Scheme::BLOCK_CYCLIC, 2), 0);
+}
+
+TEST(distribution_mpi_tests, check_parts_of_other_communicator) {
+  boost::mpi::communicator world;
+  std::vector<int> data(10);
+  EXPECT_THROW(ppc::core::scatterv(world, data.data(), data.data(), Distribution(10, world.size() + 1)),
+               std::invalid_argument);
+}
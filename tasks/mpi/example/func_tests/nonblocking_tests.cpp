@@ -0,0 +1,87 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "core/collectives/include/nonblocking.hpp"
+
+namespace collectives = ppc::core::collectives;
+
+TEST(nonblocking_tests, check_ring_of_chunks) {
+  boost::mpi::communicator world;
+  const int p = world.size();
+  const int right = (world.rank() + 1) % p;
+  const int left = (world.rank() - 1 + p) % p;
+  constexpr int CHUNKS = 4;
+  constexpr size_t CHUNK = 1000;
+  std::vector<int64_t> out(CHUNKS * CHUNK);
+  for (size_t i = 0; i < out.size(); i++) out[i] = world.rank() * 100000 + static_cast<int64_t>(i);
+  std::vector<int64_t> in(out.size(), -1);
+
+  std::vector<collectives::Request> sends;
+  std::vector<collectives::Request> recvs;
+  for (int k = 0; k < CHUNKS; k++) {
+    recvs.push_back(collectives::irecv(world, in.data() + k * CHUNK, CHUNK, left, k));
+    sends.push_back(collectives::isend(world, out.data() + k * CHUNK, CHUNK, right, k));
+  }
+  // chunks in the order they complete
+  std::vector<bool> seen(CHUNKS, false);
+  for (int received = 0; received < CHUNKS;) {
+    const auto k = collectives::test_any(recvs);
+    if (!k) continue;
+    ASSERT_FALSE(seen[*k]);
+    seen[*k] = true;
+    received++;
+    for (size_t i = *k * CHUNK; i < (*k + 1) * CHUNK; i++) {
+      ASSERT_EQ(in[i], left * 100000 + static_cast<int64_t>(i));
+    }
+  }
+  EXPECT_FALSE(collectives::test_any(recvs));
+  collectives::wait_all(sends);
+  for (const auto& request : sends) EXPECT_FALSE(request.active());
+}
+
+TEST(nonblocking_tests, check_ibcast_and_ireduce) {
+  boost::mpi::communicator world;
+  const int root = world.size() - 1;
+  std::vector<double> data(1001, world.rank() == root ? 0.5 : -1.0);
+  auto broadcast = collectives::ibcast(world, data.data(), data.size(), root);
+
+  std::vector<int64_t> in(777, world.rank() + 1);
+  std::vector<int64_t> sum(in.size(), -1);
+  std::vector<int64_t> max(in);
+  auto sum_request = collectives::ireduce(world, in.data(), sum.data(), in.size(), std::plus<>(), 0);
+  // in place on the root
+  auto max_request = collectives::ireduce(world, max.data(), max.data(), max.size(),
+                                          [](int64_t a, int64_t b) { return a < b ? b : a; }, root);
+  broadcast.wait();
+  sum_request.wait();
+  max_request.wait();
+  EXPECT_TRUE(max_request.test());
+
+  for (double value : data) ASSERT_EQ(value, 0.5);
+  const int64_t p = world.size();
+  if (world.rank() == 0) {
+    for (int64_t value : sum) ASSERT_EQ(value, p * (p + 1) / 2);
+  }
+  if (world.rank() == root) {
+    for (int64_t value : max) ASSERT_EQ(value, p);
+  }
+}
+
+TEST(nonblocking_tests, check_request_moves) {
+  boost::mpi::communicator world;
+  std::vector<int> data(10, world.rank());
+  collectives::Request request;
+  EXPECT_FALSE(request.active());
+  EXPECT_TRUE(request.test());
+  request = collectives::ibcast(world, data.data(), data.size(), 0);
+  collectives::Request moved(std::move(request));
+  moved.wait();
+  EXPECT_FALSE(moved.active());
+  EXPECT_EQ(data.back(), 0);
+}
@@ -7,10 +7,12 @@
 #include <boost/mpi/communicator.hpp>
 #include <memory>
 #include <numeric>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "core/collectives/include/nonblocking.hpp"
 #include "core/task/include/task.hpp"
 
 namespace nesterov_a_test_task_mpi {
@@ -27,7 +29,7 @@ class TestMPITaskSequential : public ppc::core::Task {
   bool post_processing() override;
 
  private:
-  std::vector<int> input_;
+  std::span<const int> input_;
   int res{};
   std::string ops;
 };
@@ -42,7 +44,13 @@ class TestMPITaskParallel : public ppc::core::Task {
   bool post_processing() override;
 
  private:
-  std::vector<int> input_, local_input_;
+  // messages of the block of every rank
+  static constexpr int CHUNKS = 4;
+  static size_t chunk_begin(size_t size, int k) { return size * k / CHUNKS; }
+
+  std::span<const int> local_input_;
+  std::vector<int> received_;
+  std::vector<ppc::core::collectives::Request> chunks;
   int res{};
   std::string ops;
   boost::mpi::communicator world;
@@ -0,0 +1,171 @@
+// Copyright 2024 Nesterov Alexander
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/mpi/timer.hpp>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/collectives/include/collectives.hpp"
+
+namespace collectives = ppc::core::collectives;
+using collectives::Algorithm;
+using collectives::Collective;
+
+namespace {
+
+// message sizes in bytes from latency-bound to bandwidth-bound
+const std::vector<size_t> SIZES = {64, size_t(1) << 12, size_t(1) << 16, size_t(1) << 20, size_t(1) << 22};
+constexpr int NUM_RUNNING = 10;
+
+// Best time of NUM_RUNNING runs, every run timed as the slowest rank after a barrier
+template <class F>
+double time_of(const boost::mpi::communicator& world, F&& run) {
+  run();
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < NUM_RUNNING; i++) {
+    world.barrier();
+    const boost::mpi::timer timer;
+    run();
+    double slowest = 0.0;
+    boost::mpi::all_reduce(world, timer.elapsed(), slowest, boost::mpi::maximum<double>());
+    best = std::min(best, slowest);
+  }
+  return best;
+}
+
+void print(const boost::mpi::communicator& world, const std::string& collective, const std::string& algorithm,
+           size_t bytes, double time) {
+  if (world.rank() != 0) return;
+  std::ostringstream line;
+  line << "collectives:" << collective << ":" << algorithm << ": ranks=" << world.size() << " bytes=" << bytes
+       << " time_sec=" << std::scientific << std::setprecision(3) << time;
+  std::cout << line.str() << std::endl;
+}
+
+// boost::mpi on the same buffers first, then every algorithm of the collective; operation
+// names the op of reductions other than the sum
+template <class Boost, class Own>
+void benchmark(const boost::mpi::communicator& world, Collective collective, Boost&& boost_run, Own&& own_run,
+               const std::string& operation = "") {
+  const auto label = collectives::to_string(collective) + (operation.empty() ? "" : "(" + operation + ")");
+  for (size_t bytes : SIZES) {
+    const size_t count = bytes / sizeof(double);
+    print(world, label, "boost", bytes, time_of(world, [&] { boost_run(count); }));
+    // select_algorithm() takes the block of one rank for scatter and gather
+    const bool blocks = collective == Collective::SCATTER || collective == Collective::GATHER;
+    const size_t segment =
+        collective == Collective::BROADCAST ? collectives::broadcast_segment(world) : collectives::CHAIN_SEGMENT;
+    const auto selected =
+        collectives::select_algorithm(collective, world.size(), blocks ? bytes / world.size() : bytes, segment);
+    for (auto algorithm : collectives::algorithms_of(collective)) {
+      const auto name = algorithm == Algorithm::AUTO ? "auto(" + collectives::to_string(selected) + ")"
+                                                     : collectives::to_string(algorithm);
+      print(world, label, name, bytes, time_of(world, [&] { own_run(count, algorithm); }));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(collectives_perf_test, test_broadcast) {
+  boost::mpi::communicator world;
+  std::vector<double> data(SIZES.back() / sizeof(double), 1.0);
+  // the bound of a broadcast: one message of the whole buffer
+  for (size_t bytes : SIZES) {
+    const int count = static_cast<int>(bytes / sizeof(double));
+    print(world, "broadcast", "point_to_point", bytes, time_of(world, [&] {
+            if (world.rank() == 0 && world.size() > 1) world.send(1, 0, data.data(), count);
+            if (world.rank() == 1) world.recv(0, 0, data.data(), count);
+          }));
+  }
+  const size_t segment = collectives::broadcast_segment(world);
+  if (world.rank() == 0) std::cout << "collectives:broadcast:segment: bytes=" << segment << std::endl;
+  benchmark(
+      world, Collective::BROADCAST,
+      [&](size_t count) { boost::mpi::broadcast(world, data.data(), static_cast<int>(count), 0); },
+      [&](size_t count, Algorithm algorithm) { collectives::broadcast(world, data.data(), count, 0, algorithm); });
+  EXPECT_EQ(data.back(), 1.0);
+}
+
+TEST(collectives_perf_test, test_reduce) {
+  boost::mpi::communicator world;
+  std::vector<double> in(SIZES.back() / sizeof(double), 1.0);
+  std::vector<double> out(in.size());
+  benchmark(
+      world, Collective::REDUCE,
+      [&](size_t count) {
+        boost::mpi::reduce(world, in.data(), static_cast<int>(count), out.data(), std::plus<>(), 0);
+      },
+      [&](size_t count, Algorithm algorithm) {
+        collectives::reduce(world, in.data(), out.data(), count, std::plus<>(), 0, algorithm);
+      });
+  if (world.rank() == 0) {
+    EXPECT_EQ(out.back(), world.size());
+  }
+}
+
+TEST(collectives_perf_test, test_all_reduce) {
+  boost::mpi::communicator world;
+  std::vector<double> in(SIZES.back() / sizeof(double), 1.0);
+  std::vector<double> out(in.size());
+  benchmark(
+      world, Collective::ALL_REDUCE,
+      [&](size_t count) {
+        boost::mpi::all_reduce(world, in.data(), static_cast<int>(count), out.data(), std::plus<>());
+      },
+      [&](size_t count, Algorithm algorithm) {
+        collectives::all_reduce(world, in.data(), out.data(), count, std::plus<>(), algorithm);
+      });
+  EXPECT_EQ(out.back(), world.size());
+}
+
+TEST(collectives_perf_test, test_all_reduce_user_operator) {
+  boost::mpi::communicator world;
+  std::vector<double> in(SIZES.back() / sizeof(double), -1.0);
+  std::vector<double> out(in.size());
+  // the maximum norm, an op that MPI does not have
+  const auto max_abs = [](double a, double b) { return std::max(std::abs(a), std::abs(b)); };
+  benchmark(
+      world, Collective::ALL_REDUCE,
+      [&](size_t count) { boost::mpi::all_reduce(world, in.data(), static_cast<int>(count), out.data(), max_abs); },
+      [&](size_t count, Algorithm algorithm) {
+        collectives::all_reduce(world, in.data(), out.data(), count, max_abs, algorithm);
+      },
+      "max_abs");
+  EXPECT_EQ(out.back(), 1.0);
+}
+
+TEST(collectives_perf_test, test_scatter_and_gather) {
+  boost::mpi::communicator world;
+  // SIZES are the buffers of the root, the blocks of one rank are a part of them
+  std::vector<double> all(SIZES.back() / sizeof(double), 1.0);
+  std::vector<double> block(all.size() / world.size() + 1);
+  const auto block_count = [&](size_t count) { return count / world.size(); };
+  benchmark(
+      world, Collective::SCATTER,
+      [&](size_t count) {
+        boost::mpi::scatter(world, all.data(), block.data(), static_cast<int>(block_count(count)), 0);
+      },
+      [&](size_t count, Algorithm algorithm) {
+        collectives::scatter(world, all.data(), block.data(), block_count(count), 0, algorithm);
+      });
+  benchmark(
+      world, Collective::GATHER,
+      [&](size_t count) {
+        boost::mpi::gather(world, block.data(), static_cast<int>(block_count(count)), all.data(), 0);
+      },
+      [&](size_t count, Algorithm algorithm) {
+        collectives::gather(world, block.data(), all.data(), block_count(count), 0, algorithm);
+      });
+  EXPECT_EQ(all.front(), 1.0);
+}
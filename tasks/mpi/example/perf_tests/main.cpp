@@ -1,10 +1,11 @@
 // Copyright 2023 Nesterov Alexander
 #include <gtest/gtest.h>
 
-#include <boost/mpi/timer.hpp>
 #include <vector>
 
+#include "core/collectives/include/collectives.hpp"
 #include "core/perf/include/perf.hpp"
+#include "core/perf/include/perf_mpi.hpp"
 #include "mpi/example/include/ops_mpi.hpp"
 
 TEST(mpi_example_perf_test, test_pipeline_run) {
@@ -32,8 +33,7 @@ TEST(mpi_example_perf_test, test_pipeline_run) {
   // Create Perf attributes
   auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
   perfAttr->num_running = 10;
-  const boost::mpi::timer current_timer;
-  perfAttr->current_timer = [&] { return current_timer.elapsed(); };
+  ppc::core::set_mpi_timing(perfAttr, world);
 
   // Create and init perf results
   auto perfResults = std::make_shared<ppc::core::PerfResults>();
@@ -44,6 +44,7 @@ TEST(mpi_example_perf_test, test_pipeline_run) {
   if (world.rank() == 0) {
     ppc::core::Perf::print_perf_statistic(perfResults);
     ASSERT_EQ(count_size_vector, global_sum[0]);
+    ASSERT_EQ(perfResults->rank_times.size(), static_cast<size_t>(world.size()));
   }
 }
 
@@ -72,8 +73,7 @@ TEST(mpi_example_perf_test, test_task_run) {
   // Create Perf attributes
   auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
   perfAttr->num_running = 10;
-  const boost::mpi::timer current_timer;
-  perfAttr->current_timer = [&] { return current_timer.elapsed(); };
+  ppc::core::set_mpi_timing(perfAttr, world);
 
   // Create and init perf results
   auto perfResults = std::make_shared<ppc::core::PerfResults>();
@@ -84,6 +84,7 @@ TEST(mpi_example_perf_test, test_task_run) {
   if (world.rank() == 0) {
     ppc::core::Perf::print_perf_statistic(perfResults);
     ASSERT_EQ(count_size_vector, global_sum[0]);
+    ASSERT_EQ(perfResults->rank_times.size(), static_cast<size_t>(world.size()));
   }
 }
 
@@ -134,5 +135,7 @@ int main(int argc, char** argv) {
     boost::mpi::communicator world;
   };
   listeners.Append(new BufferGarbageDetector);
+  // the segment of the pipelined broadcasts, tuned once before anything is timed
+  ppc::core::collectives::tune_broadcast_segment(world);
   return RUN_ALL_TESTS();
 }
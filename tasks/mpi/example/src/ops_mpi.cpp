@@ -3,31 +3,26 @@
 
 #include <algorithm>
 #include <functional>
-#include <random>
+#include <limits>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "core/distribution/include/distribution.hpp"
+#include "core/random/include/random.hpp"
+
 using namespace std::chrono_literals;
 
 std::vector<int> nesterov_a_test_task_mpi::getRandomVector(int sz) {
-  std::random_device dev;
-  std::mt19937 gen(dev());
-  std::vector<int> vec(sz);
-  for (int i = 0; i < sz; i++) {
-    vec[i] = gen() % 100;
-  }
-  return vec;
+  // an input of its own for every test, reproducible from PPC_SEED, and generated in parallel
+  return ppc::core::rng::make_vector<int>(sz, ppc::core::rng::seed_for_test(), ppc::core::rng::Uniform<int>(0, 99));
 }
 
 bool nesterov_a_test_task_mpi::TestMPITaskSequential::pre_processing() {
   internal_order_test();
-  // Init vectors
-  input_ = std::vector<int>(taskData->inputs_count[0]);
-  auto* tmp_ptr = reinterpret_cast<int*>(taskData->inputs[0]);
-  for (unsigned i = 0; i < taskData->inputs_count[0]; i++) {
-    input_[i] = tmp_ptr[i];
-  }
+  // Work on caller memory, no copy
+  input_ = taskData->input_span<int>(0);
   // Init value for output
   res = 0;
   return true;
@@ -59,28 +54,36 @@ bool nesterov_a_test_task_mpi::TestMPITaskSequential::post_processing() {
 
 bool nesterov_a_test_task_mpi::TestMPITaskParallel::pre_processing() {
   internal_order_test();
-  unsigned int delta = 0;
+  unsigned int size = 0;
   if (world.rank() == 0) {
-    delta = taskData->inputs_count[0] / world.size();
+    size = taskData->inputs_count[0];
   }
-  broadcast(world, delta, 0);
+  broadcast(world, size, 0);
+  // The first size % ranks blocks have one element more
+  const ppc::core::Distribution distribution(size, world.size());
+  const size_t delta = distribution.count(world.rank());
 
-  if (world.rank() == 0) {
-    // Init vectors
-    input_ = std::vector<int>(taskData->inputs_count[0]);
-    auto* tmp_ptr = reinterpret_cast<int*>(taskData->inputs[0]);
-    for (unsigned i = 0; i < taskData->inputs_count[0]; i++) {
-      input_[i] = tmp_ptr[i];
-    }
-    for (int proc = 1; proc < world.size(); proc++) {
-      world.send(proc, 0, input_.data() + proc * delta, delta);
+  // The blocks go in CHUNKS scatters, so that run() sums up a chunk while the next ones
+  // are on the way. Rank 0 keeps its block in the caller memory, no copy.
+  chunks.clear();
+  const int* input = world.rank() == 0 ? taskData->input_span<int>(0).data() : nullptr;
+  received_.resize(world.rank() == 0 ? 0 : delta);
+  for (int k = 0; k < CHUNKS; k++) {
+    std::vector<int> counts(world.size());
+    std::vector<int> displacements(world.size());
+    for (int proc = 0; proc < world.size(); proc++) {
+      const size_t count = distribution.count(proc);
+      counts[proc] = static_cast<int>(chunk_begin(count, k + 1) - chunk_begin(count, k));
+      displacements[proc] = static_cast<int>(distribution.displacement(proc) + chunk_begin(count, k));
     }
+    int* chunk = world.rank() == 0 ? nullptr : received_.data() + chunk_begin(delta, k);
+    chunks.push_back(ppc::core::collectives::iscatterv(world, input, std::move(counts), std::move(displacements),
+                                                       chunk, 0));
   }
-  local_input_ = std::vector<int>(delta);
   if (world.rank() == 0) {
-    local_input_ = std::vector<int>(input_.begin(), input_.begin() + delta);
+    local_input_ = std::span<const int>(input, delta);
   } else {
-    world.recv(0, 0, local_input_.data(), delta);
+    local_input_ = received_;
   }
   // Init value for output
   res = 0;
@@ -98,13 +101,19 @@ bool nesterov_a_test_task_mpi::TestMPITaskParallel::validation() {
 
 bool nesterov_a_test_task_mpi::TestMPITaskParallel::run() {
   internal_order_test();
-  int local_res;
-  if (ops == "+") {
-    local_res = std::accumulate(local_input_.begin(), local_input_.end(), 0);
-  } else if (ops == "-") {
-    local_res = -std::accumulate(local_input_.begin(), local_input_.end(), 0);
-  } else if (ops == "max") {
-    local_res = *std::max_element(local_input_.begin(), local_input_.end());
+  int local_res = ops == "max" ? std::numeric_limits<int>::min() : 0;
+  const size_t delta = local_input_.size();
+  for (int k = 0; k < CHUNKS; k++) {
+    chunks[k].wait();
+    const auto chunk =
+        local_input_.subspan(chunk_begin(delta, k), chunk_begin(delta, k + 1) - chunk_begin(delta, k));
+    if (ops == "+") {
+      local_res = std::accumulate(chunk.begin(), chunk.end(), local_res);
+    } else if (ops == "-") {
+      local_res -= std::accumulate(chunk.begin(), chunk.end(), 0);
+    } else if (ops == "max" && !chunk.empty()) {
+      local_res = std::max(local_res, *std::max_element(chunk.begin(), chunk.end()));
+    }
   }
 
   if (ops == "+" || ops == "-") {
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "core/perf/include/perf.hpp"
+#include "core/perf/include/scaling.hpp"
 #include "omp/example/include/ops_omp.hpp"
 
 TEST(openmp_example_perf_test, test_pipeline_run) {
@@ -71,6 +72,38 @@ TEST(openmp_example_perf_test, test_task_run) {
   ASSERT_EQ(count + 1, out[0]);
 }
 
+TEST(openmp_example_perf_test, test_strong_scaling) {
+  std::vector<int> in;
+  std::vector<int> out(1, 0);
+
+  // Create Scaling attributes, the factory sets the number of OpenMP threads
+  auto scalingAttr = std::make_shared<ppc::core::ScalingAttr>();
+  scalingAttr->num_workers = {1, 2, 4};
+  scalingAttr->input_sizes = {1 << 20};
+  scalingAttr->make_task = [&](uint64_t num_workers, uint64_t input_size) {
+    omp_set_num_threads(static_cast<int>(num_workers));
+    in.assign(input_size, 1);
+    auto taskDataPar = std::make_shared<ppc::core::TaskData>();
+    taskDataPar->inputs.emplace_back(reinterpret_cast<uint8_t *>(in.data()));
+    taskDataPar->inputs_count.emplace_back(in.size());
+    taskDataPar->outputs.emplace_back(reinterpret_cast<uint8_t *>(out.data()));
+    taskDataPar->outputs_count.emplace_back(out.size());
+    return std::make_shared<nesterov_a_test_task_omp::TestOMPTaskParallel>(taskDataPar, "+");
+  };
+  scalingAttr->perf_attr->num_running = 10;
+  scalingAttr->perf_attr->current_timer = [&] { return omp_get_wtime(); };
+
+  // Create and init scaling results
+  auto scalingResults = std::make_shared<ppc::core::ScalingResults>();
+
+  // Create Scaling analyzer
+  ppc::core::Scaling scaling(scalingAttr);
+  scaling.strong_run(scalingResults);
+  ppc::core::Scaling::print_scaling_statistic(scalingResults);
+  omp_set_num_threads(omp_get_num_procs());
+  ASSERT_EQ((1 << 20) + 1, out[0]);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
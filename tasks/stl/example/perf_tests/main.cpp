@@ -1,9 +1,19 @@
 // Copyright 2024 Nesterov Alexander
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include "core/dataset/include/dataset.hpp"
 #include "core/perf/include/perf.hpp"
+#include "core/random/include/random.hpp"
+#include "core/task/include/thread_pool.hpp"
 #include "stl/example/include/ops_stl.hpp"
 
 TEST(stl_example_perf_test, test_pipeline_run) {
@@ -80,6 +90,97 @@ TEST(stl_example_perf_test, test_task_run) {
   ASSERT_EQ(count, out[0]);
 }
 
+TEST(stl_example_perf_test, test_task_run_cached_input) {
+  // A large input generated by the first run of the binary and mapped from the dataset
+  // cache (PPC_DATASET_DIR) by the others, so no run pays for making it
+  const uint64_t count = 1 << 22;
+  const uint64_t seed = ppc::core::rng::seed_from_env();
+  const auto dataset = ppc::core::cached_dataset<int>(
+      "stl_example_uniform_int_seed" + std::to_string(seed), {count},
+      [&](std::span<int> data) { ppc::core::rng::fill(data, seed, ppc::core::rng::Uniform<int>(-99, 99)); });
+  const auto in = dataset.span<int>();
+  std::vector<int> out(1, 0);
+
+  // Create TaskData
+  std::shared_ptr<ppc::core::TaskData> taskDataPar = std::make_shared<ppc::core::TaskData>();
+  taskDataPar->add_input(dataset.view());
+  taskDataPar->add_output(out);
+
+  // Create Task
+  auto testTaskSTL = std::make_shared<nesterov_a_test_task_stl::TestSTLTaskParallel>(taskDataPar, "+");
+
+  // Create Perf attributes
+  auto perfAttr = std::make_shared<ppc::core::PerfAttr>();
+  perfAttr->num_running = 10;
+  const auto t0 = std::chrono::high_resolution_clock::now();
+  perfAttr->current_timer = [&] {
+    auto current_time_point = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(current_time_point - t0).count();
+    return static_cast<double>(duration) * 1e-9;
+  };
+
+  // Create and init perf results, reported as tasks/stl/example_cached_input
+  auto perfResults = std::make_shared<ppc::core::PerfResults>();
+  perfResults->variant = "cached_input";
+
+  // Create Perf analyzer
+  auto perfAnalyzer = std::make_shared<ppc::core::Perf>(testTaskSTL);
+  perfAnalyzer->task_run(perfAttr, perfResults);
+  ppc::core::Perf::print_perf_statistic(perfResults);
+  ASSERT_EQ(std::accumulate(in.begin(), in.end(), 0), out[0]);
+}
+
+TEST(stl_example_perf_test, test_thread_pool_vs_thread_per_run) {
+  // Many short reductions: the cost of starting threads on every run dominates them
+  const int num_runs = 200;
+  std::vector<int> in(100000, 1);
+  const auto nthreads = std::max(1U, std::thread::hardware_concurrency());
+  auto chunk_sum = [&](size_t i) {
+    return std::accumulate(in.begin() + in.size() * i / nthreads, in.begin() + in.size() * (i + 1) / nthreads, 0);
+  };
+
+  const auto t0 = std::chrono::high_resolution_clock::now();
+  for (int run = 0; run < num_runs; run++) {
+    std::vector<int> partial(nthreads, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nthreads; i++) {
+      threads.emplace_back([&, i] { partial[i] = chunk_sum(i); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(std::accumulate(partial.begin(), partial.end(), 0), static_cast<int>(in.size()));
+  }
+
+  const auto t1 = std::chrono::high_resolution_clock::now();
+  auto &pool = ppc::core::ThreadPool::shared();
+  for (int run = 0; run < num_runs; run++) {
+    std::vector<std::future<int>> futures;
+    for (size_t i = 0; i < nthreads; i++) {
+      futures.push_back(pool.submit([&, i] { return chunk_sum(i); }));
+    }
+    int res = 0;
+    for (auto &future : futures) {
+      res += pool.wait(future);
+    }
+    ASSERT_EQ(res, static_cast<int>(in.size()));
+  }
+  const auto t2 = std::chrono::high_resolution_clock::now();
+
+  // reported as tasks/stl/example_thread_per_run and tasks/stl/example_thread_pool
+  auto report = [&](const std::string &variant, std::chrono::duration<double> time) {
+    auto perfResults = std::make_shared<ppc::core::PerfResults>();
+    perfResults->type_of_running = ppc::core::PerfResults::TypeOfRunning::TASK_RUN;
+    perfResults->variant = variant;
+    perfResults->num_running = num_runs;
+    perfResults->input_size = in.size();
+    perfResults->time_sec = time.count();
+    ppc::core::Perf::print_perf_statistic(perfResults);
+  };
+  report("thread_per_run", t1 - t0);
+  report("thread_pool", t2 - t1);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
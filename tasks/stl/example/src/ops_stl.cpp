@@ -1,25 +1,22 @@
 // Copyright 2023 Nesterov Alexander
 #include "stl/example/include/ops_stl.hpp"
 
+#include <algorithm>
 #include <future>
 #include <iostream>
 #include <numeric>
-#include <random>
 #include <string>
-#include <thread>
 #include <utility>
 #include <vector>
 
+#include "core/random/include/random.hpp"
+#include "core/task/include/thread_pool.hpp"
+
 using namespace std::chrono_literals;
 
 std::vector<int> nesterov_a_test_task_stl::getRandomVector(int sz) {
-  std::random_device dev;
-  std::mt19937 gen(dev());
-  std::vector<int> vec(sz);
-  for (int i = 0; i < sz; i++) {
-    vec[i] = static_cast<int>(gen()) % 100;
-  }
-  return vec;
+  // an input of its own for every test, reproducible from PPC_SEED, and generated in parallel
+  return ppc::core::rng::make_vector<int>(sz, ppc::core::rng::seed_for_test(), ppc::core::rng::Uniform<int>(-99, 99));
 }
 
 bool nesterov_a_test_task_stl::TestSTLTaskSequential::pre_processing() {
@@ -57,25 +54,20 @@ bool nesterov_a_test_task_stl::TestSTLTaskSequential::post_processing() {
   return true;
 }
 
-std::mutex my_mutex;
+namespace {
 
-void atomOps(std::vector<int> vec, const std::string &ops, std::promise<int> &&pr) {
-  auto sz = vec.size();
+int reduceRange(const int *begin, const int *end, const std::string &ops) {
   int reduction_elem = 0;
   if (ops == "+") {
-    for (size_t i = 0; i < sz; i++) {
-      std::lock_guard<std::mutex> my_lock(my_mutex);
-      reduction_elem += vec[i];
-    }
+    reduction_elem = std::accumulate(begin, end, 0);
   } else if (ops == "-") {
-    for (size_t i = 0; i < sz; i++) {
-      std::lock_guard<std::mutex> my_lock(my_mutex);
-      reduction_elem -= vec[i];
-    }
+    reduction_elem = -std::accumulate(begin, end, 0);
   }
-  pr.set_value(reduction_elem);
+  return reduction_elem;
 }
 
+}  // namespace
+
 bool nesterov_a_test_task_stl::TestSTLTaskParallel::pre_processing() {
   internal_order_test();
   // Init vectors
@@ -97,24 +89,20 @@ bool nesterov_a_test_task_stl::TestSTLTaskParallel::validation() {
 
 bool nesterov_a_test_task_stl::TestSTLTaskParallel::run() {
   internal_order_test();
-  const auto nthreads = std::thread::hardware_concurrency();
-  const auto delta = (input_.end() - input_.begin()) / nthreads;
-
-  auto *promises = new std::promise<int>[nthreads];
-  auto *futures = new std::future<int>[nthreads];
-  auto *threads = new std::thread[nthreads];
-
-  for (unsigned i = 0; i < nthreads; i++) {
-    futures[i] = promises[i].get_future();
-    std::vector<int> tmp_vec(input_.begin() + i * delta, input_.begin() + (i + 1) * delta);
-    threads[i] = std::thread(atomOps, tmp_vec, ops, std::move(promises[i]));
-    threads[i].join();
-    res += futures[i].get();
+  // One chunk per worker of the persistent pool, no threads are created per run
+  auto &pool = ppc::core::ThreadPool::shared();
+  const size_t nchunks = std::max<size_t>(std::min<size_t>(pool.size(), input_.size()), 1);
+
+  std::vector<std::future<int>> futures;
+  futures.reserve(nchunks);
+  for (size_t i = 0; i < nchunks; i++) {
+    const int *begin = input_.data() + input_.size() * i / nchunks;
+    const int *end = input_.data() + input_.size() * (i + 1) / nchunks;
+    futures.push_back(pool.submit([this, begin, end] { return reduceRange(begin, end, ops); }));
+  }
+  for (auto &future : futures) {
+    res += pool.wait(future);
   }
-
-  delete[] promises;
-  delete[] futures;
-  delete[] threads;
   return true;
 }
 
@@ -2,9 +2,11 @@
 #include <gtest/gtest.h>
 #include <oneapi/tbb.h>
 
+#include <memory>
 #include <vector>
 
 #include "core/perf/include/perf.hpp"
+#include "core/task/include/execution.hpp"
 #include "tbb/example/include/ops_tbb.hpp"
 
 TEST(tbb_example_perf_test, test_pipeline_run) {
@@ -73,6 +75,31 @@ TEST(tbb_example_perf_test, test_task_run) {
   ASSERT_EQ(count + 1, out[0]);
 }
 
+TEST(tbb_example_perf_test, test_execution_backends) {
+  // the same parallel_reduce on every backend compiled into core_module_lib, reported
+  // as tasks/tbb/example_execution_<backend>
+  const uint64_t count = 10000000;
+  const int num_runs = 10;
+  std::vector<double> in(count, 1.0);
+
+  for (auto backend : ppc::core::available_backends()) {
+    const ppc::core::ExecutionPolicy policy{backend};
+    const auto t0 = oneapi::tbb::tick_count::now();
+    for (int run = 0; run < num_runs; run++) {
+      const double sum = ppc::core::parallel_reduce(
+          policy, count, 0.0, [&](uint64_t i) { return in[i]; }, [](double a, double b) { return a + b; });
+      ASSERT_EQ(sum, static_cast<double>(count));
+    }
+    auto perfResults = std::make_shared<ppc::core::PerfResults>();
+    perfResults->type_of_running = ppc::core::PerfResults::TypeOfRunning::TASK_RUN;
+    perfResults->variant = "execution_" + ppc::core::to_string(backend);
+    perfResults->num_running = num_runs;
+    perfResults->input_size = count;
+    perfResults->time_sec = (oneapi::tbb::tick_count::now() - t0).seconds();
+    ppc::core::Perf::print_perf_statistic(perfResults);
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -5,21 +5,17 @@
 
 #include <functional>
 #include <numeric>
-#include <random>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "core/random/include/random.hpp"
+
 using namespace std::chrono_literals;
 
 std::vector<int> nesterov_a_test_task_tbb::getRandomVector(int sz) {
-  std::random_device dev;
-  std::mt19937 gen(dev());
-  std::vector<int> vec(sz);
-  for (int i = 0; i < sz; i++) {
-    vec[i] = gen() % 20 + 1;
-  }
-  return vec;
+  // an input of its own for every test, reproducible from PPC_SEED, and generated in parallel
+  return ppc::core::rng::make_vector<int>(sz, ppc::core::rng::seed_for_test(), ppc::core::rng::Uniform<int>(1, 20));
 }
 
 bool nesterov_a_test_task_tbb::TestTBBTaskSequential::pre_processing() {